@@ -0,0 +1,229 @@
+/******************************************************************************
+ * @file BackupStore.cpp
+ * @brief Implements the BackupStore class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.3
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Objects are written by CopyJob::copyFile, which stages a sibling
+ * ".part" file and renames it into place, so a crash never leaves a
+ * truncated object under a valid hash; a manifest is written only
+ * after all of its objects exist.
+ ******************************************************************************/
+
+#include "BackupStore.h"
+#include "Config.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/******************************************************************************
+ * @brief Constructor.
+ * @param root Store folder.
+ ******************************************************************************/
+BackupStore::BackupStore(const QString &root)
+    : m_root(root)
+{
+}
+
+/******************************************************************************
+ * @brief Returns the store folder.
+ ******************************************************************************/
+QString BackupStore::root() const
+{
+    return m_root;
+}
+
+/******************************************************************************
+ * @brief Returns where an object is kept; the first two hex digits name
+ *        a subfolder so no folder grows too large.
+ ******************************************************************************/
+QString BackupStore::objectPath(const QByteArray &hash) const
+{
+    const QString name = QString::fromLatin1(hash);
+    return m_root + "/objects/" + name.left(2) + "/" + name.mid(2);
+}
+
+/******************************************************************************
+ * @brief Returns the manifest path of a snapshot.
+ ******************************************************************************/
+QString BackupStore::snapshotPath(const QString &name) const
+{
+    return m_root + "/snapshots/" + name + ".json";
+}
+
+/******************************************************************************
+ * @brief Returns the snapshot names, oldest first (names are timestamps).
+ ******************************************************************************/
+QStringList BackupStore::snapshots() const
+{
+    QStringList names = QDir(m_root + "/snapshots").entryList(QStringList("*.json"), QDir::Files, QDir::Name);
+    for (int i = 0; i < names.size(); ++i)
+    {
+        names[i].chop(5);
+    }
+    return names;
+}
+
+/******************************************************************************
+ * @brief Returns the files of a snapshot.
+ ******************************************************************************/
+QHash<QString, SyncEntry> BackupStore::files(const QString &name) const
+{
+    return TempSync::readManifest(snapshotPath(name));
+}
+
+/******************************************************************************
+ * @brief Saves a folder as a snapshot, hashing only files that changed
+ *        since the newest snapshot and writing only new objects.
+ ******************************************************************************/
+QString BackupStore::snapshot(const QString &sourceDir, const QString &name, const QStringList &skipNames,
+                              QStringList *errors)
+{
+    PROFILE_SCOPE("backup snapshot");
+    QStringList walkErrors;
+    QVector<SyncFile> sourceFiles;
+    QStringList folders;
+    TempSync::walk(sourceDir, skipNames, sourceFiles, folders, walkErrors);
+    if (errors)
+    {
+        *errors << walkErrors;
+    }
+
+    const QStringList names = snapshots();
+    const QString newest = names.isEmpty() ? QString() : names.last();
+    const QHash<QString, SyncEntry> previous = newest.isEmpty() ? QHash<QString, SyncEntry>() : files(newest);
+    QHash<QString, SyncEntry> entries;
+    entries.reserve(sourceFiles.size());
+    bool changed = sourceFiles.size() != previous.size() || !walkErrors.isEmpty();
+    for (int i = 0; i < sourceFiles.size(); ++i)
+    {
+        const SyncFile &file = sourceFiles.at(i);
+        SyncEntry entry;
+        entry.size = file.size;
+        entry.mtime = file.mtime;
+        entry.mode = file.mode;
+        const auto it = previous.constFind(file.relative);
+        if (it != previous.constEnd() && it->size == file.size && it->mtime == file.mtime)
+        {
+            entry.hash = it->hash;
+            changed = changed || it->mode != file.mode; // chmod leaves the time alone
+        }
+        else
+        {
+            changed = true;
+            entry.hash = TempSync::hashFile(file.path);
+            if (entry.hash.isEmpty())
+            {
+                if (errors)
+                {
+                    *errors << QString("%1: cannot read").arg(file.path);
+                }
+                continue;
+            }
+        }
+
+        const QString object = objectPath(entry.hash);
+        if (!QFileInfo::exists(object))
+        {
+            changed = true;
+            QString error;
+            if (!QDir().mkpath(QFileInfo(object).absolutePath()))
+            {
+                error = QString("Cannot create folder %1").arg(QFileInfo(object).absolutePath());
+            }
+            else
+            {
+                error = CopyJob::copyFile(file.path, object);
+            }
+            if (!error.isEmpty() && QFileInfo::exists(object))
+            {
+                error.clear(); // Another snapshot stored the same content meanwhile
+            }
+            if (!error.isEmpty())
+            {
+                if (errors)
+                {
+                    *errors << error;
+                }
+                continue;
+            }
+        }
+        entries.insert(file.relative, entry);
+    }
+
+    if (!changed)
+    {
+        return newest;
+    }
+    QString unique = name;
+    for (int n = 2; QFileInfo::exists(snapshotPath(unique)); ++n)
+    {
+        unique = QString("%1_%2").arg(name).arg(n);
+    }
+    if (!QDir().mkpath(m_root + "/snapshots") || !TempSync::writeManifest(snapshotPath(unique), entries))
+    {
+        if (errors)
+        {
+            *errors << QString("Cannot write %1").arg(snapshotPath(unique));
+        }
+        return QString();
+    }
+    return unique;
+}
+
+/******************************************************************************
+ * @brief Writes one file of a snapshot.
+ ******************************************************************************/
+QString BackupStore::restoreFile(const QString &name, const QString &relative, const QString &target) const
+{
+    const SyncEntry entry = files(name).value(relative);
+    if (entry.hash.isEmpty())
+    {
+        return QString("%1 is not in backup %2").arg(relative, name);
+    }
+    if (!QDir().mkpath(QFileInfo(target).absolutePath()))
+    {
+        return QString("Cannot create folder %1").arg(QFileInfo(target).absolutePath());
+    }
+    const QString error = CopyJob::copyFile(objectPath(entry.hash), target);
+    if (!error.isEmpty())
+    {
+        return error;
+    }
+    // The object keeps the time and mode of the first file stored with its content
+#ifdef Q_OS_UNIX
+    const int fd = ::open(QFile::encodeName(target).constData(), O_RDONLY | O_CLOEXEC); // Works read-only too
+    if (fd < 0)
+    {
+        return QString("%1: %2").arg(target, qt_error_string(errno));
+    }
+    if (entry.mode != 0)
+    {
+        ::fchmod(fd, mode_t(entry.mode));
+    }
+    const struct timespec times[2] = { { 0, UTIME_OMIT },
+                                       { time_t(entry.mtime / 1000), long(entry.mtime % 1000) * 1000000 } };
+    ::futimens(fd, times);
+    ::close(fd);
+#else
+    QFile file(target);
+    if (file.open(QIODevice::Append))
+    {
+        file.setFileTime(QDateTime::fromMSecsSinceEpoch(entry.mtime), QFileDevice::FileModificationTime);
+    }
+#endif
+    return QString();
+}
+
+/*************** End of BackupStore.cpp **************************************/
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * @file BackupStore.h
+ * @brief Declares the BackupStore class, a content-addressed Temp backup.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.2
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Keeps every backed up file once, however many snapshots hold it:
+ *
+ *   <root>/objects/ab/cdef...   file content, named by its TempSync::hashFile
+ *   <root>/snapshots/NAME.json  relative path -> size, time, hash
+ *
+ * Snapshot manifests use the TempSync manifest format. A snapshot only
+ * hashes files whose size or time differ from the newest snapshot, and
+ * only writes objects it does not have yet, so an unchanged Temp costs
+ * one walk and no new snapshot at all. Restoring a file is one copy of
+ * its object, a clone on file systems with reflinks (see CopyJob).
+ ******************************************************************************/
+
+#pragma once
+
+#include "TempSync.h"
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+
+/******************************************************************************
+ * @class BackupStore
+ * @brief Content-addressed store of Temp snapshots.
+ ******************************************************************************/
+class BackupStore
+{
+public:
+    /**************************************************************************
+     * @brief Constructor.
+     * @param root Store folder, e.g. the backup folder from Settings.
+     *************************************************************************/
+    explicit BackupStore(const QString &root);
+
+    /**************************************************************************
+     * @brief Returns the store folder.
+     *************************************************************************/
+    QString root() const;
+
+    /**************************************************************************
+     * @brief Returns where the object with @p hash is kept.
+     *************************************************************************/
+    QString objectPath(const QByteArray &hash) const;
+
+    /**************************************************************************
+     * @brief Returns the manifest path of snapshot @p name.
+     *************************************************************************/
+    QString snapshotPath(const QString &name) const;
+
+    /**************************************************************************
+     * @brief Returns the snapshot names, oldest first.
+     *************************************************************************/
+    QStringList snapshots() const;
+
+    /**************************************************************************
+     * @brief Returns the files of snapshot @p name by relative path.
+     *************************************************************************/
+    QHash<QString, SyncEntry> files(const QString &name) const;
+
+    /**************************************************************************
+     * @brief Saves the files below @p sourceDir as a snapshot. Blocks;
+     *        run it on a worker thread, e.g. in a CopyJob planner.
+     * @param sourceDir Folder to save, e.g. Temp.
+     * @param name Snapshot name, e.g. a timestamp; made unique if taken.
+     * @param skipNames Top-level names left out.
+     * @param errors Receives the files that could not be saved; the
+     *        snapshot lists only the files that were.
+     * @return The snapshot that holds the folder: @p name, or the newest
+     *         snapshot if nothing changed since it was taken. Empty if
+     *         the manifest cannot be written.
+     *************************************************************************/
+    QString snapshot(const QString &sourceDir, const QString &name, const QStringList &skipNames,
+                     QStringList *errors);
+
+    /**************************************************************************
+     * @brief Writes one file of a snapshot to @p target, with the size,
+     *        modification time and permissions it had when saved.
+     * @param name Snapshot name.
+     * @param relative Path of the file in the snapshot.
+     * @param target Path to write; its folder is created.
+     * @return Empty on success, else a one-line error.
+     *************************************************************************/
+    QString restoreFile(const QString &name, const QString &relative, const QString &target) const;
+
+private:
+    QString m_root; ///< Store folder
+};
+
+/*************** End of BackupStore.h ****************************************/
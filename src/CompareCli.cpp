@@ -0,0 +1,475 @@
+/******************************************************************************
+ * @file CompareCli.cpp
+ * @brief Implements the CompareCli class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.5
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Reads both files, extracts their functions and classifies them by
+ * fingerprint. --summary stops there and never diffs a body; --unified
+ * and --json diff only the changed functions. Comment stripping keeps
+ * every newline, so body lines map straight back to file lines, and
+ * --unified prints those file lines, comments and all, so the hunks
+ * apply to the files as they are.
+ * --trace file.json profiles the run (see Profiler), writes the phases
+ * as a chrome://tracing file and prints the slowest to err.
+ ******************************************************************************/
+
+#include "CompareCli.h"
+#include "Profiler.h"
+#include <QCommandLineParser>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cstring>
+
+/******************************************************************************
+ * @struct CliRow
+ * @brief One diff row with its 0-based line on each side; a row from one
+ *        side keeps the other side's position, where it would go.
+ ******************************************************************************/
+struct CliRow
+{
+    EditOp::Kind kind;
+    int origLine;
+    int newLine;
+    bool approximate;
+};
+
+/******************************************************************************
+ * @brief Returns true for rows whose line is in the original.
+ ******************************************************************************/
+static bool inOriginal(EditOp::Kind kind)
+{
+    return kind == EditOp::Equal || kind == EditOp::Delete || kind == EditOp::MoveFrom;
+}
+
+/******************************************************************************
+ * @brief Returns true for rows whose line is in the new side.
+ ******************************************************************************/
+static bool inNew(EditOp::Kind kind)
+{
+    return kind == EditOp::Equal || kind == EditOp::Insert || kind == EditOp::MoveTo;
+}
+
+/******************************************************************************
+ * @brief Reads a file as UTF-8.
+ * @return false if it cannot be opened.
+ ******************************************************************************/
+static bool readFile(const QString &path, QString &text)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    text = QString::fromUtf8(file.readAll());
+    return true;
+}
+
+/******************************************************************************
+ * @brief Splits a file into lines as FunctionBlock::bodyLines does.
+ ******************************************************************************/
+static QVector<QStringView> fileLines(const QString &text)
+{
+    QVector<QStringView> lines;
+    int start = 0;
+    for (int i = 0; i <= text.size(); ++i)
+    {
+        if (i == text.size() || text.at(i) == QLatin1Char('\n'))
+        {
+            QStringView line = QStringView(text).mid(start, i - start);
+            if (line.endsWith(QLatin1Char('\r')))
+            {
+                line.chop(1);
+            }
+            lines.append(line);
+            start = i + 1;
+        }
+    }
+    return lines;
+}
+
+/******************************************************************************
+ * @brief Writes the unified hunks of one function. Moved lines are
+ *        plain -/+ lines, as patch expects.
+ * @param name Function name, shown after each hunk header.
+ * @param ops Edit script over the body lines of both blocks.
+ * @param origFile Lines of the original file; rows print these, not the
+ *        comment-stripped body lines.
+ * @param newFile Lines of the new file.
+ * @param origBase 0-based file line of the first original body line.
+ * @param newBase 0-based file line of the first new body line.
+ ******************************************************************************/
+static void writeHunks(const QString &name, const QVector<EditOp> &ops,
+                       const QVector<QStringView> &origFile, const QVector<QStringView> &newFile,
+                       int origBase, int newBase, QTextStream &out)
+{
+    QVector<CliRow> rows;
+    rows.reserve(CompareEngine::countRows(ops));
+    for (int i = 0; i < ops.size(); ++i)
+    {
+        const EditOp &op = ops.at(i);
+        for (int k = 0; k < op.length; ++k)
+        {
+            CliRow row;
+            row.kind = op.op;
+            row.origLine = op.origIndex + (inOriginal(op.op) ? k : 0);
+            row.newLine = op.newIndex + (inNew(op.op) ? k : 0);
+            row.approximate = op.approximate;
+            rows.append(row);
+        }
+    }
+
+    const int context = CompareCli::UnifiedContext;
+    const int rowCount = int(rows.size());
+    int r = 0;
+    while (r < rowCount)
+    {
+        if (rows.at(r).kind == EditOp::Equal)
+        {
+            ++r;
+            continue;
+        }
+        // Changes closer than two contexts share a hunk
+        const int start = qMax(r - context, 0);
+        int last = r;
+        for (int scan = r + 1; scan < rowCount && scan - last <= 2 * context; ++scan)
+        {
+            if (rows.at(scan).kind != EditOp::Equal)
+            {
+                last = scan;
+            }
+        }
+        const int end = qMin(last + 1 + context, rowCount);
+
+        int origCount = 0;
+        int newCount = 0;
+        int origStart = -1;
+        int newStart = -1;
+        bool approximate = false;
+        for (int h = start; h < end; ++h)
+        {
+            const CliRow &row = rows.at(h);
+            if (inOriginal(row.kind))
+            {
+                origStart = origStart < 0 ? row.origLine : origStart;
+                ++origCount;
+            }
+            if (inNew(row.kind))
+            {
+                newStart = newStart < 0 ? row.newLine : newStart;
+                ++newCount;
+            }
+            approximate = approximate || row.approximate;
+        }
+        // An empty side names the line before the hunk, as diff -u does
+        origStart = origCount > 0 ? origBase + origStart + 1 : origBase + rows.at(start).origLine;
+        newStart = newCount > 0 ? newBase + newStart + 1 : newBase + rows.at(start).newLine;
+        out << "@@ -" << origStart << ',' << origCount << " +" << newStart << ',' << newCount << " @@ " << name
+            << (approximate ? " (approximate)" : "") << '\n';
+
+        for (int h = start; h < end; ++h)
+        {
+            const CliRow &row = rows.at(h);
+            if (row.kind == EditOp::Equal)
+            {
+                out << ' ' << origFile.value(origBase + row.origLine) << '\n';
+            }
+            else if (inOriginal(row.kind))
+            {
+                out << '-' << origFile.value(origBase + row.origLine) << '\n';
+            }
+            else
+            {
+                out << '+' << newFile.value(newBase + row.newLine) << '\n';
+            }
+        }
+        r = end;
+    }
+}
+
+/******************************************************************************
+ * @brief Returns true if the command line asks for --compare.
+ * @param argc Argument count from main().
+ * @param argv Arguments from main().
+ ******************************************************************************/
+bool CompareCli::isCompareCommand(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--compare") == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/******************************************************************************
+ * @brief Runs a compare from the command line.
+ * @param arguments Full argument list, program name first.
+ * @param out Receives the report.
+ * @param err Receives usage and file errors.
+ * @return ExitCode bits, or ExitUsage / ExitNoInput.
+ ******************************************************************************/
+int CompareCli::run(const QStringList &arguments, QTextStream &out, QTextStream &err)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Compares the functions of two C/C++ files.");
+    const QCommandLineOption compareOption("compare", "Compare orig against new without starting the GUI.");
+    const QCommandLineOption summaryOption("summary", "Print missing, new and changed functions (default).");
+    const QCommandLineOption unifiedOption("unified", "Print a unified diff of every differing function.");
+    const QCommandLineOption jsonOption("json", "Print the result as JSON.");
+    const QCommandLineOption algorithmOption("algorithm", "Diff algorithm: auto, myers, patience, histogram "
+                                             "or bitparallel.", "name", "auto");
+    const QCommandLineOption traceOption("trace", "Write phase timings as a chrome://tracing file.", "file");
+    const QCommandLineOption helpOption(QStringList({ "h", "help" }), "Show this help.");
+    parser.addOptions({ compareOption, summaryOption, unifiedOption, jsonOption, algorithmOption, traceOption,
+                        helpOption });
+    parser.addPositionalArgument("orig", "Original file.");
+    parser.addPositionalArgument("new", "New file.");
+
+    if (!parser.parse(arguments))
+    {
+        err << parser.errorText() << '\n';
+        return ExitUsage;
+    }
+    if (parser.isSet(helpOption))
+    {
+        out << parser.helpText();
+        return ExitSame;
+    }
+    const QStringList files = parser.positionalArguments();
+    const int formats = int(parser.isSet(summaryOption)) + int(parser.isSet(unifiedOption))
+                        + int(parser.isSet(jsonOption));
+    if (files.size() != 2 || formats > 1)
+    {
+        err << "Usage: DiffCheckAI --compare orig new [--summary|--unified|--json] [--algorithm name]"
+               " [--trace file]\n";
+        return ExitUsage;
+    }
+    // diffAlgorithmFromName maps any unknown name to auto; a typo must not.
+    // The reference LCS table is kept for tests and not offered here
+    const QString algorithmName = parser.value(algorithmOption);
+    const DiffAlgorithm algorithm = CompareEngine::diffAlgorithmFromName(algorithmName);
+    if (algorithm == DiffAlgorithm::Lcs
+        || CompareEngine::diffAlgorithmName(algorithm) != algorithmName.trimmed().toLower())
+    {
+        err << "Unknown --algorithm " << algorithmName
+            << "; use auto, myers, patience, histogram or bitparallel\n";
+        return ExitUsage;
+    }
+
+    QString origText;
+    QString newText;
+    for (int i = 0; i < 2; ++i)
+    {
+        if (!readFile(files.at(i), i == 0 ? origText : newText))
+        {
+            err << "Cannot read " << files.at(i) << '\n';
+            return ExitNoInput;
+        }
+    }
+
+    const QString tracePath = parser.value(traceOption);
+    if (!tracePath.isEmpty())
+    {
+        Profiler::reset();
+        Profiler::setEnabled(true);
+    }
+    CompareEngine engine;
+    engine.setDiffAlgorithm(algorithm);
+    const QMap<QString, FunctionBlock> orig = engine.extractFunctions(origText);
+    const QMap<QString, FunctionBlock> news = engine.extractFunctions(newText);
+
+    int code = ExitSame;
+    for (auto it = orig.constBegin(); it != orig.constEnd(); ++it)
+    {
+        const auto found = news.constFind(it.key());
+        if (found == news.constEnd())
+        {
+            code |= ExitMissing;
+        }
+        else if (found.value().fingerprint != it.value().fingerprint)
+        {
+            code |= ExitChanged;
+        }
+    }
+    for (auto it = news.constBegin(); it != news.constEnd(); ++it)
+    {
+        if (!orig.contains(it.key()))
+        {
+            code |= ExitAdded;
+        }
+    }
+
+    if (parser.isSet(unifiedOption))
+    {
+        writeUnified(engine, files.at(0), files.at(1), origText, newText, orig, news, out);
+    }
+    else if (parser.isSet(jsonOption))
+    {
+        writeJson(engine, files.at(0), files.at(1), orig, news, out);
+    }
+    else
+    {
+        out << engine.buildSummary(orig, news) << '\n';
+    }
+    out.flush();
+    if (!tracePath.isEmpty())
+    {
+        Profiler::setEnabled(false);
+        err << "Phases: " << Profiler::summary(8) << '\n';
+        if (!Profiler::writeTrace(tracePath))
+        {
+            err << "Cannot write " << tracePath << '\n';
+        }
+    }
+    return code;
+}
+
+/******************************************************************************
+ * @brief Writes a unified diff of every changed, missing and added
+ *        function, in name order, with line numbers of the original files.
+ *        A missing function is one all-deleted hunk, an added one one
+ *        all-inserted hunk. Bodies are diffed as extracted; the lines
+ *        printed are the raw file lines at the same positions.
+ ******************************************************************************/
+void CompareCli::writeUnified(const CompareEngine &engine, const QString &origPath, const QString &newPath,
+                              const QString &origText, const QString &newText,
+                              const QMap<QString, FunctionBlock> &orig,
+                              const QMap<QString, FunctionBlock> &news, QTextStream &out)
+{
+    const QVector<QStringView> origFile = fileLines(origText);
+    const QVector<QStringView> newFile = fileLines(newText);
+    QStringList names = orig.keys();
+    for (auto it = news.constBegin(); it != news.constEnd(); ++it)
+    {
+        if (!orig.contains(it.key()))
+        {
+            names << it.key();
+        }
+    }
+    names.sort();
+
+    bool headerWritten = false;
+    for (int i = 0; i < names.size(); ++i)
+    {
+        const QString &name = names.at(i);
+        const auto o = orig.constFind(name);
+        const auto n = news.constFind(name);
+        if (o != orig.constEnd() && n != news.constEnd() && o.value().fingerprint == n.value().fingerprint)
+        {
+            continue;
+        }
+        if (!headerWritten)
+        {
+            out << "--- " << origPath << '\n' << "+++ " << newPath << '\n';
+            headerWritten = true;
+        }
+
+        const QVector<QStringView> origLines = o != orig.constEnd() ? o.value().bodyLines() : QVector<QStringView>();
+        const QVector<QStringView> newLines = n != news.constEnd() ? n.value().bodyLines() : QVector<QStringView>();
+        QVector<EditOp> ops;
+        if (o != orig.constEnd() && n != news.constEnd())
+        {
+            ops = engine.diffLines(origLines, newLines);
+        }
+        else
+        {
+            EditOp op;
+            op.op = origLines.isEmpty() ? EditOp::Insert : EditOp::Delete;
+            op.length = int(origLines.isEmpty() ? newLines.size() : origLines.size());
+            ops.append(op);
+        }
+        writeHunks(name, ops, origFile, newFile,
+                   o != orig.constEnd() ? firstBodyLine(o.value()) : 0,
+                   n != news.constEnd() ? firstBodyLine(n.value()) : 0, out);
+    }
+}
+
+/******************************************************************************
+ * @brief Writes the compare result as one JSON object: file names, the
+ *        missing and added functions, and per changed function its hunk
+ *        and line counts. Lines are 1-based file lines of the body start.
+ ******************************************************************************/
+void CompareCli::writeJson(const CompareEngine &engine, const QString &origPath, const QString &newPath,
+                           const QMap<QString, FunctionBlock> &orig,
+                           const QMap<QString, FunctionBlock> &news, QTextStream &out)
+{
+    QJsonArray missing;
+    QJsonArray added;
+    QJsonArray changed;
+    int unchanged = 0;
+    for (auto it = orig.constBegin(); it != orig.constEnd(); ++it)
+    {
+        const auto found = news.constFind(it.key());
+        if (found == news.constEnd())
+        {
+            missing.append(QJsonObject({ { "name", it.key() }, { "line", firstBodyLine(it.value()) + 1 } }));
+            continue;
+        }
+        if (found.value().fingerprint == it.value().fingerprint)
+        {
+            ++unchanged;
+            continue;
+        }
+        const QVector<EditOp> ops = engine.diffLines(it.value().bodyLines(), found.value().bodyLines());
+        int deleted = 0;
+        int inserted = 0;
+        int moved = 0;
+        for (int i = 0; i < ops.size(); ++i)
+        {
+            const EditOp &op = ops.at(i);
+            if (op.op == EditOp::Delete) { deleted += op.length; }
+            else if (op.op == EditOp::Insert) { inserted += op.length; }
+            else if (op.op == EditOp::MoveTo) { moved += op.length; }
+        }
+        QJsonObject function;
+        function.insert("name", it.key());
+        function.insert("originalLine", firstBodyLine(it.value()) + 1);
+        function.insert("newLine", firstBodyLine(found.value()) + 1);
+        function.insert("hunks", CompareEngine::countHunks(ops));
+        function.insert("deleted", deleted);
+        function.insert("inserted", inserted);
+        function.insert("moved", moved);
+        function.insert("approximate", CompareEngine::isApproximate(ops));
+        changed.append(function);
+    }
+    for (auto it = news.constBegin(); it != news.constEnd(); ++it)
+    {
+        if (!orig.contains(it.key()))
+        {
+            added.append(QJsonObject({ { "name", it.key() }, { "line", firstBodyLine(it.value()) + 1 } }));
+        }
+    }
+
+    QJsonObject root;
+    root.insert("original", origPath);
+    root.insert("new", newPath);
+    root.insert("algorithm", CompareEngine::diffAlgorithmName(engine.diffAlgorithm()));
+    root.insert("missing", missing);
+    root.insert("added", added);
+    root.insert("changed", changed);
+    root.insert("unchanged", unchanged);
+    out << QJsonDocument(root).toJson(QJsonDocument::Indented);
+}
+
+/******************************************************************************
+ * @brief Returns the 0-based file line of a block's first body line: the
+ *        line of its opening brace.
+ ******************************************************************************/
+int CompareCli::firstBodyLine(const FunctionBlock &block)
+{
+    if (!block.source)
+    {
+        return 0;
+    }
+    return int(QStringView(*block.source).left(block.bodyStart).count(QLatin1Char('\n')));
+}
+
+/*************** End of CompareCli.cpp ***************************************/
@@ -0,0 +1,89 @@
+/******************************************************************************
+ * @file CompareCli.h
+ * @brief Declares the CompareCli class behind the headless --compare mode.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.3
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * DiffCheckAI --compare orig.cpp new.cpp [--summary|--unified|--json]
+ * [--trace trace.json]
+ * compares two files with CompareEngine and prints the result, without
+ * widgets, settings or translations, so main() only needs a
+ * QCoreApplication. The exit code is a bit mask of what differs, so
+ * scripts can test it without parsing the output.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+#include "CompareEngine.h"
+
+/******************************************************************************
+ * @class CompareCli
+ * @brief Stateless command-line front end of CompareEngine.
+ ******************************************************************************/
+class CompareCli
+{
+public:
+    /**************************************************************************
+     * @enum ExitCode
+     * @brief Process exit codes; the first three combine as bits.
+     *************************************************************************/
+    enum ExitCode
+    {
+        ExitSame = 0,     /**< Every function matches */
+        ExitChanged = 1,  /**< Some function body changed */
+        ExitMissing = 2,  /**< Some original function is missing in new */
+        ExitAdded = 4,    /**< Some new function is not in the original */
+        ExitUsage = 64,   /**< Bad command line (EX_USAGE) */
+        ExitNoInput = 66  /**< A file could not be read (EX_NOINPUT) */
+    };
+
+    static constexpr int UnifiedContext = 3; ///< Unchanged lines around a hunk
+
+    /**************************************************************************
+     * @brief Returns true if the command line asks for --compare, so main()
+     *        can skip the GUI before any QApplication exists.
+     * @param argc Argument count from main().
+     * @param argv Arguments from main().
+     *************************************************************************/
+    static bool isCompareCommand(int argc, char *argv[]);
+
+    /**************************************************************************
+     * @brief Runs a compare from the command line.
+     * @param arguments Full argument list, program name first.
+     * @param out Receives the report.
+     * @param err Receives usage and file errors.
+     * @return ExitCode bits, or ExitUsage / ExitNoInput.
+     *************************************************************************/
+    static int run(const QStringList &arguments, QTextStream &out, QTextStream &err);
+
+private:
+    /**************************************************************************
+     * @brief Writes a unified diff of every changed, missing and added
+     *        function, with line numbers and lines of the original files.
+     *************************************************************************/
+    static void writeUnified(const CompareEngine &engine, const QString &origPath, const QString &newPath,
+                             const QString &origText, const QString &newText,
+                             const QMap<QString, FunctionBlock> &orig,
+                             const QMap<QString, FunctionBlock> &news, QTextStream &out);
+
+    /**************************************************************************
+     * @brief Writes the compare result as one JSON object.
+     *************************************************************************/
+    static void writeJson(const CompareEngine &engine, const QString &origPath, const QString &newPath,
+                          const QMap<QString, FunctionBlock> &orig,
+                          const QMap<QString, FunctionBlock> &news, QTextStream &out);
+
+    /**************************************************************************
+     * @brief Returns the 0-based file line of a block's first body line.
+     *************************************************************************/
+    static int firstBodyLine(const FunctionBlock &block);
+};
+
+/*************** End of CompareCli.h *****************************************/
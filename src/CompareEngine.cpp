@@ -3,23 +3,35 @@
  * @brief Implements the CompareEngine class for code comparison.
  *
  * @author Jeffrey Scott Flesher with the help of AI: Copilot
- * @version 0.8
- * @date 2025-11-07
+ * @version 0.26
+ * @date 2026-10-16
  * @section License MIT
  * @section DESCRIPTION
- * Regex-based function extraction, normalization (whitespace/
- * brace compression), and a simple diff algorithm that marks
- * deletions (-), additions (+), and reorders (~) heuristically.
+ * Lexer-based function extraction (see CppLexer), normalization
+ * (see Normalizer), and a selectable line diff (see
+ * DiffKernels) that marks deletions (-), additions (+), and moved
+ * lines/blocks (~), returned as a run-length EditOp script. Each
+ * diff is bounded by an edit cost and time budget; past it the
+ * kernels degrade to a coarse diff flagged approximate. The public
+ * phases are timed with PROFILE_SCOPE (see Profiler).
  ******************************************************************************/
 
 #include "CompareEngine.h"
-#include <QRegularExpression>
+#include "Config.h"
+#include "CppLexer.h"
+#include "DiffKernels.h"
+#include "LineInterner.h"
+#include "Normalizer.h"
 #include <utility> // for std::as_const
 
 /******************************************************************************
  * @brief Constructor.
  ******************************************************************************/
 CompareEngine::CompareEngine()
+    : m_diffAlgorithm(DiffAlgorithm::Auto)
+    , m_normalizeFlags(Normalizer::IgnoreCommentOnlyChanges)
+    , m_maxEditCost(DefaultMaxEditCost)
+    , m_maxMilliseconds(DefaultMaxMilliseconds)
 {
 }
 
@@ -31,84 +43,472 @@ CompareEngine::~CompareEngine()
 }
 
 /******************************************************************************
- * @brief Removes comments from code.
+ * @brief Removes comments from code. String and char literals are lexed,
+ *        so comment markers inside them are kept.
  * @param code Raw file content.
  * @return Code without comments.
  ******************************************************************************/
 QString CompareEngine::stripComments(const QString &code) const
 {
-    QString s = code;
-    QRegularExpression blockComments(R"(/\*.*?\*/)", QRegularExpression::DotMatchesEverythingOption);
-    s.remove(blockComments);
-    QRegularExpression lineComments(R"(//[^\n]*)");
-    s = s.replace(lineComments, "");
-    return s;
+    PROFILE_SCOPE("stripComments");
+    return CppLexer::stripComments(code, CppLexer::tokenize(code));
 }
 
 /******************************************************************************
- * @brief Extracts function blocks from raw C/C++ code.
+ * @brief Returns the text of a token.
+ ******************************************************************************/
+static QStringView tokenText(const QString &s, const CppToken &token)
+{
+    return QStringView(s).mid(token.start, token.length);
+}
+
+/******************************************************************************
+ * @brief Pairs every brace and parenthesis with its partner in one pass.
+ *        A '}' also closes any '(' left open inside its block, so one
+ *        broken parameter list cannot swallow the rest of the file.
+ * @return Index of the partner token for each bracket, -1 if unmatched
+ *         or not a bracket.
+ ******************************************************************************/
+static QVector<int> matchBrackets(const QVector<CppToken> &tokens)
+{
+    QVector<int> partner(tokens.size(), -1);
+    QVector<int> open;
+    for (int k = 0; k < tokens.size(); ++k)
+    {
+        switch (tokens.at(k).kind)
+        {
+        case CppTokenKind::OpenBrace:
+        case CppTokenKind::OpenParen:
+            open.append(k);
+            break;
+        case CppTokenKind::CloseParen:
+            if (!open.isEmpty() && tokens.at(open.last()).kind == CppTokenKind::OpenParen)
+            {
+                partner[open.last()] = k;
+                partner[k] = open.takeLast();
+            }
+            break;
+        case CppTokenKind::CloseBrace:
+            while (!open.isEmpty() && tokens.at(open.last()).kind == CppTokenKind::OpenParen)
+            {
+                open.removeLast();
+            }
+            if (!open.isEmpty())
+            {
+                partner[open.last()] = k;
+                partner[k] = open.takeLast();
+            }
+            break;
+        default:
+            break;
+        }
+    }
+    return partner;
+}
+
+/******************************************************************************
+ * @brief Classifies the brace at brace: namespace, class/struct/union and
+ *        extern "C" blocks are scopes to descend into; anything else
+ *        (enum bodies, initializers, stray blocks) is skipped.
+ * @param name Receives the scope name, empty for anonymous scopes.
+ * @return true if the brace opens a scope.
+ ******************************************************************************/
+static bool scopeName(const QString &s, const QVector<CppToken> &tokens, int brace, QString &name)
+{
+    static const QStringList scopeKeywords = { "namespace", "class", "struct", "union" };
+    int keyword = -1;
+    for (int k = brace - 1; k >= 0; --k)
+    {
+        const CppTokenKind kind = tokens.at(k).kind;
+        if (kind == CppTokenKind::Semicolon || kind == CppTokenKind::OpenBrace
+            || kind == CppTokenKind::CloseBrace || kind == CppTokenKind::Preprocessor)
+        {
+            break;
+        }
+        const QStringView text = tokenText(s, tokens.at(k));
+        if (text == u">")
+        {
+            // template <class T> class Foo: the class inside <...> is a parameter
+            int depth = 1;
+            while (depth > 0 && k > 0)
+            {
+                --k;
+                const QStringView inner = tokenText(s, tokens.at(k));
+                depth += (inner == u">") ? 1 : (inner == u"<") ? -1 : 0;
+            }
+            continue;
+        }
+        if (kind == CppTokenKind::Identifier && text == u"extern" && k + 1 < brace
+            && tokens.at(k + 1).kind == CppTokenKind::String)
+        {
+            name.clear();
+            return true;
+        }
+        if (kind == CppTokenKind::Identifier && scopeKeywords.contains(text.toString()))
+        {
+            keyword = k;
+        }
+    }
+    if (keyword < 0 || (keyword > 0 && tokenText(s, tokens.at(keyword - 1)) == u"enum"))
+    {
+        return false;
+    }
+    // class EXPORT_MACRO Name final : Base -> "Name"
+    name.clear();
+    for (int k = keyword + 1; k < brace; ++k)
+    {
+        const QStringView text = tokenText(s, tokens.at(k));
+        if (tokens.at(k).kind == CppTokenKind::Identifier)
+        {
+            if (text == u"final")
+            {
+                break;
+            }
+            if (!name.endsWith(QLatin1String("::")))
+            {
+                name.clear();
+            }
+            name += text;
+        }
+        else if (text == u"::")
+        {
+            name += text;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return true;
+}
+
+/******************************************************************************
+ * @brief Walks back from the '>' at close to the '<' that opens its
+ *        template argument list, e.g. the "<T>" of "Box<T>::get".
+ * @return Token index of '<', or -1 if close does not end such a list.
+ ******************************************************************************/
+static int templateArgsStart(const QString &s, const QVector<CppToken> &tokens, int close)
+{
+    int depth = 0;
+    for (int k = close; k >= 0; --k)
+    {
+        const CppToken &token = tokens.at(k);
+        const QStringView text = tokenText(s, token);
+        if (text == u">")
+        {
+            ++depth;
+        }
+        else if (text == u"<" && --depth == 0)
+        {
+            return k;
+        }
+        else if (token.kind == CppTokenKind::OpenBrace || token.kind == CppTokenKind::CloseBrace
+                 || token.kind == CppTokenKind::Semicolon)
+        {
+            return -1;
+        }
+    }
+    return -1;
+}
+
+/******************************************************************************
+ * @brief Finds the first token of a function name ending just before the
+ *        parenthesis at paren: name, Class::name, Class::~Class,
+ *        Box<T>::name or an operator. Control keywords are not names.
+ * @return Token index, or -1 if no function name precedes paren.
+ ******************************************************************************/
+static int functionNameStart(const QString &s, const QVector<CppToken> &tokens, int paren)
+{
+    static const QStringList keywords = { "if", "for", "while", "switch", "catch", "return",
+                                          "sizeof", "alignof", "alignas", "decltype", "noexcept",
+                                          "static_assert", "throw", "new", "delete" };
+    int start = -1;
+    // operator==, operator(), operator new: "operator" within three tokens
+    for (int k = paren - 1; k >= 0 && k >= paren - 3; --k)
+    {
+        if (tokens.at(k).kind == CppTokenKind::Identifier && tokenText(s, tokens.at(k)) == u"operator")
+        {
+            start = k;
+            break;
+        }
+    }
+    if (start < 0)
+    {
+        if (paren == 0 || tokens.at(paren - 1).kind != CppTokenKind::Identifier
+            || keywords.contains(tokenText(s, tokens.at(paren - 1)).toString()))
+        {
+            return -1;
+        }
+        start = paren - 1;
+        if (start > 0 && tokenText(s, tokens.at(start - 1)) == u"~")
+        {
+            --start;
+        }
+    }
+    while (start >= 2 && tokenText(s, tokens.at(start - 1)) == u"::")
+    {
+        int scope = start - 2;
+        if (tokenText(s, tokens.at(scope)) == u">")
+        {
+            scope = templateArgsStart(s, tokens, scope) - 1;
+        }
+        if (scope < 0 || tokens.at(scope).kind != CppTokenKind::Identifier)
+        {
+            break;
+        }
+        start = scope;
+    }
+    return start;
+}
+
+/******************************************************************************
+ * @brief Finds the opening brace of a function body after the parameter
+ *        list closed at close. Allows cv/ref qualifiers, noexcept(...),
+ *        trailing return types and constructor initializer lists.
+ * @return Token index of '{', or -1 if a declaration or call follows.
+ ******************************************************************************/
+static int functionBodyStart(const QString &s, const QVector<CppToken> &tokens,
+                             const QVector<int> &partner, int close)
+{
+    static const QStringList qualifiers = { "const", "volatile", "noexcept", "override", "final",
+                                            "mutable", "throw", "requires", "decltype" };
+    bool initList = false;
+    bool trailingType = false;
+    int k = close + 1;
+    while (k < tokens.size())
+    {
+        const CppToken &token = tokens.at(k);
+        const QStringView text = tokenText(s, token);
+        switch (token.kind)
+        {
+        case CppTokenKind::OpenBrace:
+            // In an initializer list, member{value} is not the body
+            if (initList && tokens.at(k - 1).kind == CppTokenKind::Identifier)
+            {
+                k = partner.at(k);
+                if (k < 0) { return -1; }
+                ++k;
+                continue;
+            }
+            return k;
+        case CppTokenKind::OpenParen:
+            if (!initList && !trailingType && !qualifiers.contains(tokenText(s, tokens.at(k - 1)).toString()))
+            {
+                return -1;
+            }
+            k = partner.at(k);
+            if (k < 0) { return -1; }
+            ++k;
+            continue;
+        case CppTokenKind::Identifier:
+            if (!initList && !trailingType && !qualifiers.contains(text.toString()))
+            {
+                return -1;
+            }
+            ++k;
+            continue;
+        case CppTokenKind::Punct:
+            if (text == u":")
+            {
+                initList = true;
+            }
+            else if (text == u">" && tokenText(s, tokens.at(k - 1)) == u"-")
+            {
+                trailingType = true;
+            }
+            else if (text != u"&" && text != u"*" && text != u"-" && text != u"<"
+                     && text != u">" && text != u"," && text != u"::")
+            {
+                return -1;
+            }
+            ++k;
+            continue;
+        default:
+            return -1;
+        }
+    }
+    return -1;
+}
+
+/******************************************************************************
+ * @brief Extracts function blocks from raw C/C++ code in one forward pass
+ *        over the tokens. Brackets are paired up front, so a function
+ *        body is jumped over in O(1) and blocks inside it are never
+ *        looked at. A stack of namespace/class scopes qualifies names,
+ *        e.g. "ns::Widget::paint" for a method defined in its class.
  * @param code Raw file content.
  * @return Map of function name to FunctionBlock.
  ******************************************************************************/
 QMap<QString, FunctionBlock> CompareEngine::extractFunctions(const QString &code) const
 {
+    PROFILE_SCOPE("extractFunctions");
     QMap<QString, FunctionBlock> out;
-    const QString s = stripComments(code);
-    QRegularExpression re(R"(([\w:~]+)\s*\([^\)]*\)\s*\{)", QRegularExpression::MultilineOption);
-    QRegularExpressionMatchIterator it = re.globalMatch(s);
-    while (it.hasNext())
-    {
-        QRegularExpressionMatch m = it.next();
-        int idx = m.capturedStart(0);
-        if (idx < 0) { continue; }
-        int braceStart = s.indexOf('{', idx);
-        if (braceStart < 0) { continue; }
-        int depth = 0;
-        int pos = braceStart;
-        int endPos = -1;
-        while (pos < s.size())
-        {
-            QChar c = s.at(pos);
-            if (c == '{') { depth++; }
-            else if (c == '}')
-            {
-                depth--;
-                if (depth == 0)
+    // Every block of this file shares one copy of its text. Comments are
+    // only stripped when they are ignored; otherwise they stay in the
+    // bodies and count, and only their tokens are left out of the scan
+    const QVector<CppToken> lexed = CppLexer::tokenize(code);
+    QVector<CppToken> tokens;
+    QSharedPointer<const QString> source;
+    if (m_normalizeFlags & Normalizer::IgnoreCommentOnlyChanges)
+    {
+        source.reset(new QString(CppLexer::stripComments(code, lexed, &tokens)));
+    }
+    else
+    {
+        source.reset(new QString(code));
+        tokens.reserve(lexed.size());
+        for (int k = 0; k < lexed.size(); ++k)
+        {
+            if (!lexed.at(k).isComment())
+            {
+                tokens.append(lexed.at(k));
+            }
+        }
+    }
+    const QString &s = *source;
+    const QVector<int> partner = matchBrackets(tokens);
+
+    struct Scope
+    {
+        int close;      // Token index of the closing brace
+        QString prefix; // Qualified name including this scope, "" or "ns::Class::"
+    };
+    QVector<Scope> scopes;
+    int t = 0;
+    while (t < tokens.size())
+    {
+        while (!scopes.isEmpty() && t >= scopes.last().close)
+        {
+            scopes.removeLast();
+        }
+        const CppToken &token = tokens.at(t);
+        const int close = partner.at(t);
+        if (token.kind == CppTokenKind::OpenBrace && close >= 0)
+        {
+            QString name;
+            if (scopeName(s, tokens, t, name))
+            {
+                QString prefix = scopes.isEmpty() ? QString() : scopes.last().prefix;
+                if (!name.isEmpty())
                 {
-                    endPos = pos;
-                    break;
+                    prefix += name + "::";
                 }
+                scopes.append(Scope{ close, prefix });
+                ++t;
             }
-            pos++;
+            else
+            {
+                t = close + 1;
+            }
+            continue;
+        }
+        if (token.kind != CppTokenKind::OpenParen || close < 0)
+        {
+            ++t;
+            continue;
+        }
+
+        const int nameStart = functionNameStart(s, tokens, t);
+        const int braceStart = (nameStart < 0) ? -1 : functionBodyStart(s, tokens, partner, close);
+        const int braceEnd = (braceStart < 0) ? -1 : partner.at(braceStart);
+        if (braceEnd < 0)
+        {
+            t = close + 1;
+            continue;
         }
-        if (endPos < 0) { continue; }
-        QString signature = s.mid(idx, braceStart - idx).trimmed();
-        QString name = m.captured(1).trimmed();
-        QString body = s.mid(braceStart + 1, endPos - braceStart - 1);
+        QString name = scopes.isEmpty() ? QString() : scopes.last().prefix;
+        int templateDepth = 0;
+        for (int k = nameStart; k < t; ++k)
+        {
+            // Box<T>::get is keyed like get defined in Box, "Box::get"
+            const QStringView text = tokenText(s, tokens.at(k));
+            if (templateDepth > 0
+                || (text == u"<" && tokens.at(k - 1).kind == CppTokenKind::Identifier
+                    && tokenText(s, tokens.at(k - 1)) != u"operator"))
+            {
+                templateDepth += int(text == u"<") - int(text == u">");
+                continue;
+            }
+            // Keep "operator bool" apart, drop all other spacing
+            if (k > nameStart && tokens.at(k).kind == CppTokenKind::Identifier
+                && tokens.at(k - 1).kind == CppTokenKind::Identifier)
+            {
+                name += QLatin1Char(' ');
+            }
+            name += text;
+        }
+        const int signatureStart = tokens.at(nameStart).start;
+        const QStringView signature = QStringView(*source).mid(signatureStart, tokens.at(braceStart).start - signatureStart);
         FunctionBlock fb;
-        fb.signature = signature;
-        fb.body = body;
-        fb.normalizedBody = normalizeBody(body);
-        fb.bodyLines = toLines(body);
+        fb.source = source;
+        fb.signatureStart = signatureStart;
+        fb.signatureLength = int(signature.trimmed().size());
+        fb.bodyStart = tokens.at(braceStart).end();
+        fb.bodyLength = tokens.at(braceEnd).start - fb.bodyStart;
+        fb.normalizeFlags = m_normalizeFlags;
+        fb.fingerprint = fingerprintBody(fb.body(), m_normalizeFlags);
         out.insert(name, fb);
+        t = braceEnd + 1;
     }
     return out;
 }
 
 /******************************************************************************
- * @brief Normalizes code body to ignore style/spacing.
+ * @brief Normalizes code body to ignore style/spacing: whitespace runs
+ *        become one space, none is kept next to braces, and literals are
+ *        kept verbatim.
  * @param body Raw function body.
+ * @param flags Extra Normalizer::Flag policies.
  * @return Normalized single-line body.
  ******************************************************************************/
-QString CompareEngine::normalizeBody(const QString &body) const
+QString CompareEngine::normalizeBody(QStringView body, unsigned flags)
+{
+    PROFILE_SCOPE("normalizeBody");
+    return Normalizer::normalize(body, flags | Normalizer::JoinLines);
+}
+
+/******************************************************************************
+ * @brief Fingerprints a body: equal fingerprints mean equal normalizeBody
+ *        results for the same flags (up to 64-bit hash collisions).
+ * @param body Raw function body.
+ * @param flags Extra Normalizer::Flag policies.
+ * @return FNV-1a 64 of the normalized body, which is never built.
+ ******************************************************************************/
+quint64 CompareEngine::fingerprintBody(QStringView body, unsigned flags)
 {
-    QString s = body;
-    s.replace("\r", "");
-    s.replace("\t", " ");
-    s = s.replace(QRegularExpression(R"(\s+)"), " ");
-    s = s.replace(QRegularExpression(R"(\s*\{\s*)"), "{");
-    s = s.replace(QRegularExpression(R"(\s*\}\s*)"), "}");
-    return s.trimmed();
+    return Normalizer::fingerprint(body, flags | Normalizer::JoinLines);
+}
+
+/******************************************************************************
+ * @brief Returns the body split into lines, without '\r'.
+ ******************************************************************************/
+QVector<QStringView> FunctionBlock::bodyLines() const
+{
+    const QStringView text = body();
+    QVector<QStringView> lines;
+    int start = 0;
+    for (int i = 0; i <= text.size(); ++i)
+    {
+        if (i == text.size() || text.at(i) == QLatin1Char('\n'))
+        {
+            QStringView line = text.mid(start, i - start);
+            if (line.endsWith(QLatin1Char('\r')))
+            {
+                line.chop(1);
+            }
+            lines.append(line);
+            start = i + 1;
+        }
+    }
+    return lines;
+}
+
+/******************************************************************************
+ * @brief Builds the normalized body (see CompareEngine::normalizeBody).
+ ******************************************************************************/
+QString FunctionBlock::normalizedBody() const
+{
+    return CompareEngine::normalizeBody(body(), normalizeFlags);
 }
 
 /******************************************************************************
@@ -124,72 +524,348 @@ QStringList CompareEngine::toLines(const QString &text) const
 }
 
 /******************************************************************************
- * @brief Computes line-by-line diff between original and new.
- * @param originalLines Lines from original function body.
- * @param newLines Lines from new function body.
- * @return Triples of (marker, originalText, newText).
+ * @brief Returns true if a normalized line has no letters or digits,
+ *        e.g. blank lines and lone braces, which move too often to matter.
  ******************************************************************************/
-QVector<QVector<QString>> CompareEngine::diffLines(const QStringList &originalLines,
-                                                   const QStringList &newLines) const
+static bool isTrivialLine(const QString &normalized)
 {
-    auto norm = [](const QString &l) -> QString {
-        QString s = l;
-        s.replace("\t", " ");
-        s = s.replace(QRegularExpression(R"(\s+)"), " ").trimmed();
-        return s;
-    };
-    int n = originalLines.size();
-    int m = newLines.size();
-    QVector<QVector<int>> dp(n + 1, QVector<int>(m + 1, 0));
-    for (int i = n - 1; i >= 0; --i)
+    for (int i = 0; i < normalized.size(); ++i)
     {
-        for (int j = m - 1; j >= 0; --j)
+        if (normalized.at(i).isLetterOrNumber())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+/******************************************************************************
+ * @brief Marks moved lines: each Insert row is paired with an unused
+ *        Delete row of the same interned ID, and they become MoveTo and
+ *        MoveFrom. Deletions are kept in per-ID FIFO lists so the pass is
+ *        linear. An Insert row following a paired Insert row first tries
+ *        the line after the previous partner, so a moved run of lines
+ *        pairs up as one block. Blocks made only of trivial lines are left
+ *        as plain deletions and insertions.
+ * @param rows EditOp::Kind of each diff row, updated in place.
+ * @param rowIds Interned ID of each row's text.
+ * @param interner Interner that produced rowIds.
+ ******************************************************************************/
+static void markMoves(QVector<quint8> &rows, const QVector<quint32> &rowIds,
+                      const LineInterner &interner)
+{
+    const int rowCount = int(rows.size());
+    const int idCount = interner.size();
+    QVector<int> head(idCount, -1);
+    QVector<int> tail(idCount, -1);
+    QVector<int> next(rowCount, -1);
+    for (int r = 0; r < rowCount; ++r)
+    {
+        if (rows.at(r) != EditOp::Delete)
+        {
+            continue;
+        }
+        const quint32 id = rowIds.at(r);
+        if (tail.at(id) < 0)
         {
-            if (norm(originalLines[i]) == norm(newLines[j]))
+            head[id] = r;
+        }
+        else
+        {
+            next[tail.at(id)] = r;
+        }
+        tail[id] = r;
+    }
+
+    QVector<int> partner(rowCount, -1); // Insert row -> paired Delete row
+    QVector<bool> used(rowCount, false);
+    int prevPlus = -1;
+    for (int k = 0; k < rowCount; ++k)
+    {
+        if (rows.at(k) != EditOp::Insert)
+        {
+            continue;
+        }
+        const quint32 id = rowIds.at(k);
+        int match = -1;
+        if (prevPlus == k - 1 && prevPlus >= 0)
+        {
+            const int candidate = partner.at(prevPlus) + 1;
+            if (candidate < rowCount && !used.at(candidate) && rows.at(candidate) == EditOp::Delete
+                && rowIds.at(candidate) == id)
             {
-                dp[i][j] = 1 + dp[i + 1][j + 1];
+                match = candidate;
             }
-            else
+        }
+        if (match < 0)
+        {
+            int h = head.at(id);
+            while (h >= 0 && used.at(h))
+            {
+                h = next.at(h);
+            }
+            head[id] = h;
+            match = h;
+        }
+        if (match >= 0)
+        {
+            used[match] = true;
+            partner[k] = match;
+            prevPlus = k;
+        }
+        else
+        {
+            prevPlus = -1;
+        }
+    }
+
+    // Mark whole blocks, skipping blocks of only braces/blank lines
+    QVector<qint8> trivial(idCount, -1);
+    int k = 0;
+    while (k < rowCount)
+    {
+        if (partner.at(k) < 0)
+        {
+            ++k;
+            continue;
+        }
+        int end = k + 1;
+        while (end < rowCount && partner.at(end) >= 0 && partner.at(end) == partner.at(end - 1) + 1)
+        {
+            ++end;
+        }
+        bool meaningful = false;
+        for (int r = k; r < end && !meaningful; ++r)
+        {
+            const quint32 id = rowIds.at(r);
+            if (trivial.at(id) < 0)
+            {
+                trivial[id] = isTrivialLine(interner.text(id)) ? 1 : 0;
+            }
+            meaningful = (trivial.at(id) == 0);
+        }
+        if (meaningful)
+        {
+            for (int r = k; r < end; ++r)
             {
-                dp[i][j] = qMax(dp[i + 1][j], dp[i][j + 1]);
+                rows[r] = EditOp::MoveTo;
+                rows[partner.at(r)] = EditOp::MoveFrom;
             }
         }
+        k = end;
     }
-    QVector<QVector<QString>> result;
+}
+
+/******************************************************************************
+ * @brief Computes line-by-line diff between original and new.
+ * @param originalLines Lines from original function body.
+ * @param newLines Lines from new function body.
+ * @return Edit script indexing originalLines and newLines.
+ ******************************************************************************/
+QVector<EditOp> CompareEngine::diffLines(const QStringList &originalLines,
+                                         const QStringList &newLines) const
+{
+    QVector<QStringView> origViews;
+    QVector<QStringView> newViews;
+    origViews.reserve(originalLines.size());
+    newViews.reserve(newLines.size());
+    for (int i = 0; i < originalLines.size(); ++i)
+    {
+        origViews.append(originalLines.at(i));
+    }
+    for (int j = 0; j < newLines.size(); ++j)
+    {
+        newViews.append(newLines.at(j));
+    }
+    return diffLines(origViews, newViews);
+}
+
+/******************************************************************************
+ * @brief Appends one row to the script, extending the last run when the
+ *        row continues it on both sides.
+ * @param ops Script being built.
+ * @param kind EditOp::Kind of the row.
+ * @param origIndex Original line of the row, or the insert position.
+ * @param newIndex New line of the row, or the delete position.
+ * @param approximate Row came from the coarse fallback.
+ ******************************************************************************/
+static void appendRow(QVector<EditOp> &ops, quint8 kind, int origIndex, int newIndex, bool approximate)
+{
+    if (!ops.isEmpty())
+    {
+        EditOp &last = ops.last();
+        const bool origStep = (kind == EditOp::Equal || kind == EditOp::Delete || kind == EditOp::MoveFrom);
+        const bool newStep = (kind == EditOp::Equal || kind == EditOp::Insert || kind == EditOp::MoveTo);
+        if (last.op == kind && last.approximate == approximate
+            && origIndex == last.origIndex + (origStep ? last.length : 0)
+            && newIndex == last.newIndex + (newStep ? last.length : 0))
+        {
+            ++last.length;
+            return;
+        }
+    }
+    EditOp op;
+    op.op = EditOp::Kind(kind);
+    op.approximate = approximate;
+    op.origIndex = origIndex;
+    op.newIndex = newIndex;
+    op.length = 1;
+    ops.append(op);
+}
+
+/******************************************************************************
+ * @brief Computes line-by-line diff between line views.
+ * @param originalViews Lines from original function body.
+ * @param newViews Lines from new function body.
+ * @return Edit script indexing originalViews and newViews.
+ ******************************************************************************/
+QVector<EditOp> CompareEngine::diffLines(const QVector<QStringView> &originalViews,
+                                         const QVector<QStringView> &newViews) const
+{
+    PROFILE_SCOPE("diffLines");
+    // IgnoreBlankLines leaves blank lines out of the diff altogether; the
+    // kept lines remember their index so the script still points at the inputs
+    const bool skipBlank = (m_normalizeFlags & Normalizer::IgnoreBlankLines) != 0;
+    QVector<QStringView> keptOriginal;
+    QVector<QStringView> keptNew;
+    QVector<int> origIndex;
+    QVector<int> newIndex;
+    for (int i = 0; skipBlank && i < originalViews.size(); ++i)
+    {
+        if (!originalViews.at(i).trimmed().isEmpty())
+        {
+            keptOriginal.append(originalViews.at(i));
+            origIndex.append(i);
+        }
+    }
+    for (int j = 0; skipBlank && j < newViews.size(); ++j)
+    {
+        if (!newViews.at(j).trimmed().isEmpty())
+        {
+            keptNew.append(newViews.at(j));
+            newIndex.append(j);
+        }
+    }
+    origIndex.append(int(originalViews.size()));
+    newIndex.append(int(newViews.size()));
+    const QVector<QStringView> &originalLines = skipBlank ? keptOriginal : originalViews;
+    const QVector<QStringView> &newLines = skipBlank ? keptNew : newViews;
+
+    // Normalize and hash every line once; kernels only compare the IDs
+    LineInterner interner(m_normalizeFlags);
+    const QVector<quint32> origIds = interner.internLines(originalLines);
+    const QVector<quint32> newIds = interner.internLines(newLines);
+    QByteArray script;
+    DiffKernels::Budget budget;
+    budget.maxCost = m_maxEditCost;
+    if (m_maxMilliseconds > 0)
+    {
+        budget.deadline.setRemainingTime(m_maxMilliseconds);
+    }
+    DiffAlgorithm algorithm = m_diffAlgorithm;
+    if (algorithm == DiffAlgorithm::Auto)
+    {
+        algorithm = chooseDiffAlgorithm(origIds, newIds);
+    }
+    switch (algorithm)
+    {
+    case DiffAlgorithm::Patience:
+        DiffKernels::patience(origIds, newIds, script, &budget);
+        break;
+    case DiffAlgorithm::Histogram:
+        DiffKernels::histogram(origIds, newIds, script, &budget);
+        break;
+    case DiffAlgorithm::BitParallel:
+        DiffKernels::bitParallel(origIds, newIds, script, &budget);
+        break;
+    case DiffAlgorithm::Lcs:
+        DiffKernels::lcs(origIds, newIds, script, &budget);
+        break;
+    case DiffAlgorithm::Myers:
+    default:
+        DiffKernels::myers(origIds, newIds, script, &budget);
+        break;
+    }
+
+    // One kind per row; each run of changes is all deletions, then all
+    // additions, and approximate if the kernel gave up on any of it
+    QVector<quint8> rows;
+    QVector<bool> rowApproximate;
+    QVector<quint32> rowIds;
+    QVector<int> rowLine; // Kept-line index of each row on its own side
+    rows.reserve(script.size());
+    rowIds.reserve(script.size());
+    rowLine.reserve(script.size());
+    rowApproximate.reserve(script.size());
     int i = 0, j = 0;
-    while (i < n && j < m)
+    int pos = 0;
+    while (pos < script.size())
     {
-        if (norm(originalLines[i]) == norm(newLines[j]))
+        if (script.at(pos) == DiffKernels::OpEqual)
         {
-            result.push_back({ " ", originalLines[i], newLines[j] });
-            i++; j++;
+            rows.push_back(EditOp::Equal);
+            rowIds.push_back(origIds[i]);
+            rowLine.push_back(i);
+            rowApproximate.push_back(false);
+            i++; j++; pos++;
+            continue;
         }
-        else if (dp[i + 1][j] >= dp[i][j + 1])
+        int deletions = 0;
+        int insertions = 0;
+        bool approximate = false;
+        while (pos < script.size() && script.at(pos) != DiffKernels::OpEqual)
         {
-            result.push_back({ "-", originalLines[i], "" });
+            const char op = script.at(pos);
+            if (op == DiffKernels::OpDelete || op == DiffKernels::OpDeleteApprox) { deletions++; }
+            else { insertions++; }
+            approximate = approximate || op == DiffKernels::OpDeleteApprox || op == DiffKernels::OpInsertApprox;
+            pos++;
+        }
+        rowApproximate.insert(rowApproximate.size(), deletions + insertions, approximate);
+        for (int d = 0; d < deletions; ++d)
+        {
+            rows.push_back(EditOp::Delete);
+            rowIds.push_back(origIds[i]);
+            rowLine.push_back(i);
             i++;
         }
-        else
+        for (int a = 0; a < insertions; ++a)
         {
-            result.push_back({ "+", "", newLines[j] });
+            rows.push_back(EditOp::Insert);
+            rowIds.push_back(newIds[j]);
+            rowLine.push_back(j);
             j++;
         }
     }
-    while (i < n) { result.push_back({ "-", originalLines[i], "" }); i++; }
-    while (j < m) { result.push_back({ "+", "", newLines[j] }); j++; }
-    for (int k = 0; k < result.size(); ++k)
+    markMoves(rows, rowIds, interner);
+
+    // Fold the rows into runs, translating kept lines back to input lines
+    QVector<EditOp> result;
+    i = 0;
+    j = 0;
+    for (int r = 0; r < rows.size(); ++r)
     {
-        if (result[k][0] == "+")
+        const quint8 kind = rows.at(r);
+        if (kind == EditOp::Equal)
         {
-            QString added = norm(result[k][2]);
-            for (int r = 0; r < result.size(); ++r)
-            {
-                if (result[r][0] == "-" && norm(result[r][1]) == added)
-                {
-                    result[k][0] = "~"; // reorder
-                    break;
-                }
-            }
+            i = rowLine.at(r);
+            appendRow(result, kind, skipBlank ? origIndex.at(i) : i, skipBlank ? newIndex.at(j) : j,
+                      rowApproximate.at(r));
+            i++; j++;
+        }
+        else if (kind == EditOp::Delete || kind == EditOp::MoveFrom)
+        {
+            i = rowLine.at(r);
+            appendRow(result, kind, skipBlank ? origIndex.at(i) : i, skipBlank ? newIndex.at(j) : j,
+                      rowApproximate.at(r));
+            i++;
+        }
+        else
+        {
+            j = rowLine.at(r);
+            appendRow(result, kind, skipBlank ? origIndex.at(i) : i, skipBlank ? newIndex.at(j) : j,
+                      rowApproximate.at(r));
+            j++;
         }
     }
     return result;
@@ -204,6 +880,7 @@ QVector<QVector<QString>> CompareEngine::diffLines(const QStringList &originalLi
 QString CompareEngine::buildSummary(const QMap<QString, FunctionBlock> &orig,
                                     const QMap<QString, FunctionBlock> &news) const
 {
+    PROFILE_SCOPE("buildSummary");
     QStringList lines;
     lines << "=== Summary ===";
     QStringList missingFuncs;
@@ -216,7 +893,7 @@ QString CompareEngine::buildSummary(const QMap<QString, FunctionBlock> &orig,
         {
             missingFuncs << name;
         }
-        else if (it.value().normalizedBody != news.value(name).normalizedBody)
+        else if (it.value().fingerprint != news.value(name).fingerprint)
         {
             changedFuncs << name;
         }
@@ -247,4 +924,187 @@ QString CompareEngine::buildSummary(const QMap<QString, FunctionBlock> &orig,
     return lines.join("\n");
 }
 
+/******************************************************************************
+ * @brief Selects the diff kernel used by diffLines.
+ * @param algorithm Kernel to use.
+ ******************************************************************************/
+void CompareEngine::setDiffAlgorithm(DiffAlgorithm algorithm)
+{
+    m_diffAlgorithm = algorithm;
+}
+
+/******************************************************************************
+ * @brief Returns the diff kernel used by diffLines.
+ ******************************************************************************/
+DiffAlgorithm CompareEngine::diffAlgorithm() const
+{
+    return m_diffAlgorithm;
+}
+
+/******************************************************************************
+ * @brief Selects the normalization policies used by extractFunctions
+ *        fingerprints and diffLines.
+ * @param flags Combination of Normalizer::Flag values.
+ ******************************************************************************/
+void CompareEngine::setNormalizeFlags(unsigned flags)
+{
+    m_normalizeFlags = flags & ~unsigned(Normalizer::JoinLines);
+}
+
+/******************************************************************************
+ * @brief Returns the normalization policies.
+ ******************************************************************************/
+unsigned CompareEngine::normalizeFlags() const
+{
+    return m_normalizeFlags;
+}
+
+/******************************************************************************
+ * @brief Bounds the work of one diffLines call.
+ * @param maxEditCost Edit cost one Myers search may reach; 0 for none.
+ * @param maxMilliseconds Wall-clock limit per call; 0 for none.
+ ******************************************************************************/
+void CompareEngine::setDiffBudget(int maxEditCost, int maxMilliseconds)
+{
+    m_maxEditCost = qMax(0, maxEditCost);
+    m_maxMilliseconds = qMax(0, maxMilliseconds);
+}
+
+/******************************************************************************
+ * @brief Returns the edit cost limit; 0 means none.
+ ******************************************************************************/
+int CompareEngine::maxEditCost() const
+{
+    return m_maxEditCost;
+}
+
+/******************************************************************************
+ * @brief Returns the time limit in milliseconds; 0 means none.
+ ******************************************************************************/
+int CompareEngine::maxMilliseconds() const
+{
+    return m_maxMilliseconds;
+}
+
+/******************************************************************************
+ * @brief Returns the settings name of a diff kernel.
+ * @param algorithm Kernel.
+ * @return Lower-case name, e.g. "myers".
+ ******************************************************************************/
+QString CompareEngine::diffAlgorithmName(DiffAlgorithm algorithm)
+{
+    switch (algorithm)
+    {
+    case DiffAlgorithm::Patience:
+        return "patience";
+    case DiffAlgorithm::Histogram:
+        return "histogram";
+    case DiffAlgorithm::BitParallel:
+        return "bitparallel";
+    case DiffAlgorithm::Lcs:
+        return "lcs";
+    case DiffAlgorithm::Myers:
+        return "myers";
+    case DiffAlgorithm::Auto:
+    default:
+        return "auto";
+    }
+}
+
+/******************************************************************************
+ * @brief Parses a settings name back into a diff kernel.
+ * @param name Name from diffAlgorithmName.
+ * @return Matching kernel, or Auto if the name is unknown.
+ ******************************************************************************/
+DiffAlgorithm CompareEngine::diffAlgorithmFromName(const QString &name)
+{
+    const QString key = name.trimmed().toLower();
+    if (key == "myers") { return DiffAlgorithm::Myers; }
+    if (key == "patience") { return DiffAlgorithm::Patience; }
+    if (key == "histogram") { return DiffAlgorithm::Histogram; }
+    if (key == "bitparallel") { return DiffAlgorithm::BitParallel; }
+    if (key == "lcs") { return DiffAlgorithm::Lcs; }
+    return DiffAlgorithm::Auto;
+}
+
+/******************************************************************************
+ * @brief Counts hunks: runs of consecutive changed rows.
+ * @param diff Edit script from diffLines.
+ * @return Number of hunks.
+ ******************************************************************************/
+int CompareEngine::countHunks(const QVector<EditOp> &diff)
+{
+    int hunks = 0;
+    bool inHunk = false;
+    for (int i = 0; i < diff.size(); ++i)
+    {
+        const bool changed = (diff.at(i).op != EditOp::Equal);
+        if (changed && !inHunk)
+        {
+            ++hunks;
+        }
+        inHunk = changed;
+    }
+    return hunks;
+}
+
+/******************************************************************************
+ * @brief Counts diff rows: the lines of every run.
+ * @param diff Edit script from diffLines.
+ * @return Number of rows.
+ ******************************************************************************/
+int CompareEngine::countRows(const QVector<EditOp> &diff)
+{
+    int rows = 0;
+    for (int i = 0; i < diff.size(); ++i)
+    {
+        rows += diff.at(i).length;
+    }
+    return rows;
+}
+
+/******************************************************************************
+ * @brief Returns true if any run of the script is approximate.
+ * @param diff Edit script from diffLines.
+ ******************************************************************************/
+bool CompareEngine::isApproximate(const QVector<EditOp> &diff)
+{
+    for (int i = 0; i < diff.size(); ++i)
+    {
+        if (diff.at(i).approximate)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/******************************************************************************
+ * @brief Picks the kernel DiffAlgorithm::Auto runs for two sides. Myers
+ *        costs about (N+M)*D steps, the bit-parallel LCS N*M/64 word ops
+ *        of a few instructions each; measured on synthetic bodies the
+ *        crossover is near (N+M)*D*4 = N*M. D is a lower bound from line
+ *        counts, so moved or reordered lines still go to Myers.
+ * @param a Interned original line IDs.
+ * @param b Interned new line IDs.
+ * @return DiffAlgorithm::Myers or DiffAlgorithm::BitParallel.
+ ******************************************************************************/
+DiffAlgorithm CompareEngine::chooseDiffAlgorithm(const QVector<quint32> &a, const QVector<quint32> &b)
+{
+    const qint64 n = a.size();
+    const qint64 m = b.size();
+    // The kernel keeps m rows of ceil(n/64) words each, so short rows
+    // still cost a word apiece
+    if (n == 0 || m == 0 || m * ((n + 63) / 64) > DiffKernels::BitParallelMaxWords)
+    {
+        return DiffAlgorithm::Myers;
+    }
+    const qint64 d = DiffKernels::estimateEditDistance(a, b);
+    if ((n + m) * d * 4 > n * m)
+    {
+        return DiffAlgorithm::BitParallel;
+    }
+    return DiffAlgorithm::Myers;
+}
+
 /*************** End of CompareEngine.cpp ************************************/
@@ -3,8 +3,8 @@
  * @brief Declares the CompareEngine class for code comparison.
  *
  * @author Jeffrey Scott Flesher with the help of AI: Copilot
- * @version 0.8
- * @date 2025-11-07
+ * @version 0.19
+ * @date 2026-10-16
  * @section License MIT
  * @section DESCRIPTION
  * Provides function-aware code comparison, normalization, and diff.
@@ -14,19 +14,141 @@
 
 #include <QString>
 #include <QStringList>
+#include <QStringView>
+#include <QSharedPointer>
 #include <QMap>
 #include <QVector>
 
 /******************************************************************************
  * @struct FunctionBlock
- * @brief Holds function signature, body, and normalized body.
+ * @brief Locates one function in the comment-stripped text of its file.
+ *
+ * All blocks of a file share one immutable copy of that text and only
+ * store offsets, so a block is cheap to copy into a QMap. Signature,
+ * body and lines are views into the shared text; the normalized body
+ * is built on demand. Equal fingerprints mean equal normalized bodies,
+ * so unchanged functions are recognized without comparing text.
  ******************************************************************************/
 struct FunctionBlock
 {
-    QString signature;      /**< Function signature */
-    QString body;           /**< Raw function body */
-    QString normalizedBody; /**< Normalized body for comparison */
-    QStringList bodyLines;  /**< Body split into lines */
+    QSharedPointer<const QString> source; /**< Comment-stripped file text */
+    int signatureStart = 0;               /**< Offset of the signature */
+    int signatureLength = 0;              /**< Length of the signature */
+    int bodyStart = 0;                    /**< Offset just past the '{' */
+    int bodyLength = 0;                   /**< Length up to the '}' */
+    quint64 fingerprint = 0;              /**< Hash of the normalized body */
+    unsigned normalizeFlags = 0;          /**< Normalizer::Flag policies of the hash */
+
+    /**************************************************************************
+     * @brief Returns the function signature, e.g. "Foo::bar(int x) const".
+     *************************************************************************/
+    QStringView signature() const
+    {
+        return source ? QStringView(*source).mid(signatureStart, signatureLength) : QStringView();
+    }
+
+    /**************************************************************************
+     * @brief Returns the body between the braces.
+     *************************************************************************/
+    QStringView body() const
+    {
+        return source ? QStringView(*source).mid(bodyStart, bodyLength) : QStringView();
+    }
+
+    /**************************************************************************
+     * @brief Returns the body split into lines, without '\r'.
+     *************************************************************************/
+    QVector<QStringView> bodyLines() const;
+
+    /**************************************************************************
+     * @brief Builds the normalized body (see CompareEngine::normalizeBody).
+     *************************************************************************/
+    QString normalizedBody() const;
+};
+
+/******************************************************************************
+ * @struct EditOp
+ * @brief One run of the edit script returned by CompareEngine::diffLines.
+ *
+ * A run covers length consecutive lines of one kind and only indexes the
+ * caller's line arrays, so a diff row costs no string copies and a run
+ * of any length costs 16 bytes. Lines removed by IgnoreBlankLines are in
+ * no run. Runs that touch only one side still record the position on
+ * the other side, where the lines would go. Changed runs found after
+ * the diff budget ran out are flagged approximate: still a valid
+ * script, but maybe longer than the minimal one.
+ ******************************************************************************/
+struct EditOp
+{
+    /**************************************************************************
+     * @enum Kind
+     * @brief What happened to the lines of a run.
+     *************************************************************************/
+    enum Kind : quint8
+    {
+        Equal,    /**< In both sides; text from the original */
+        Delete,   /**< Only in the original */
+        Insert,   /**< Only in the new side */
+        MoveFrom, /**< Original lines that moved elsewhere */
+        MoveTo    /**< New lines that moved from elsewhere */
+    };
+
+    Kind op = Equal;          /**< Kind of every line in the run */
+    bool approximate = false; /**< Changed run from the coarse fallback */
+    int origIndex = 0;        /**< First original line, or insert position */
+    int newIndex = 0;         /**< First new line, or delete position */
+    int length = 0;           /**< Number of lines */
+
+    /**************************************************************************
+     * @brief Returns true if the run's lines are original lines.
+     *************************************************************************/
+    bool fromOriginal() const
+    {
+        return op == Equal || op == Delete || op == MoveFrom;
+    }
+
+    /**************************************************************************
+     * @brief Returns the row marker: ' ', '-', '+' or '~'.
+     *************************************************************************/
+    QChar marker() const
+    {
+        switch (op)
+        {
+        case Delete: return QLatin1Char('-');
+        case Insert: return QLatin1Char('+');
+        case MoveFrom:
+        case MoveTo: return QLatin1Char('~');
+        default: return QLatin1Char(' ');
+        }
+    }
+
+    /**************************************************************************
+     * @brief Returns one line of the run from the array it indexes.
+     * @param originalLines Lines passed to diffLines as the original.
+     * @param newLines Lines passed to diffLines as the new side.
+     * @param offset Line within the run, 0 to length - 1.
+     *************************************************************************/
+    template <typename Lines>
+    const auto &line(const Lines &originalLines, const Lines &newLines, int offset) const
+    {
+        return fromOriginal() ? originalLines.at(origIndex + offset) : newLines.at(newIndex + offset);
+    }
+};
+
+static_assert(sizeof(EditOp) == 16, "EditOp is meant to stay 16 bytes");
+
+/******************************************************************************
+ * @enum DiffAlgorithm
+ * @brief Selects the line diff kernel used by CompareEngine::diffLines.
+ ******************************************************************************/
+enum class DiffAlgorithm
+{
+    Auto,        /**< Picks Myers or BitParallel per compare (default) */
+    Myers,       /**< Linear-space Myers O((N+M)D) diff */
+    Patience,    /**< Anchors on lines unique to both sides */
+    Histogram,   /**< Anchors on the least frequent common lines */
+    BitParallel, /**< Bit-vector LCS, 64 cells per word op */
+    Lcs          /**< Full O(N*M) LCS table, kept as a reference for tests */
 };
 
 /******************************************************************************
@@ -36,6 +158,9 @@ struct FunctionBlock
 class CompareEngine
 {
 public:
+    static constexpr int DefaultMaxEditCost = 1024;     ///< Edit cost a Myers search may reach
+    static constexpr int DefaultMaxMilliseconds = 2000; ///< Time one diffLines call may take
+
     /**************************************************************************
      * @brief Constructor.
      *************************************************************************/
@@ -54,7 +179,8 @@ public:
     QString stripComments(const QString &code) const;
 
     /**************************************************************************
-     * @brief Extracts function blocks from raw C/C++ code.
+     * @brief Extracts function blocks from raw C/C++ code. Comments are
+     *        stripped only under Normalizer::IgnoreCommentOnlyChanges.
      * @param code Raw file content.
      * @return Map of function name to FunctionBlock.
      *************************************************************************/
@@ -63,9 +189,18 @@ public:
     /**************************************************************************
      * @brief Normalizes code body to ignore style/spacing.
      * @param body Raw function body.
+     * @param flags Extra Normalizer::Flag policies.
      * @return Normalized single-line body.
      *************************************************************************/
-    QString normalizeBody(const QString &body) const;
+    static QString normalizeBody(QStringView body, unsigned flags = 0);
+
+    /**************************************************************************
+     * @brief Fingerprints a body as extractFunctions does.
+     * @param body Raw function body.
+     * @param flags Extra Normalizer::Flag policies.
+     * @return 64-bit hash of the normalized body.
+     *************************************************************************/
+    static quint64 fingerprintBody(QStringView body, unsigned flags = 0);
 
     /**************************************************************************
      * @brief Splits text into lines.
@@ -78,10 +213,20 @@ public:
      * @brief Computes line-by-line diff between original and new.
      * @param originalLines Lines from original function body.
      * @param newLines Lines from new function body.
-     * @return Triples of (marker, originalText, newText).
+     * @return Edit script indexing originalLines and newLines.
      *************************************************************************/
-    QVector<QVector<QString>> diffLines(const QStringList &originalLines,
-                                        const QStringList &newLines) const;
+    QVector<EditOp> diffLines(const QStringList &originalLines,
+                              const QStringList &newLines) const;
+
+    /**************************************************************************
+     * @brief Computes line-by-line diff between line views, e.g. from
+     *        FunctionBlock::bodyLines, without copying the inputs.
+     * @param originalViews Lines from original function body.
+     * @param newViews Lines from new function body.
+     * @return Edit script indexing originalViews and newViews.
+     *************************************************************************/
+    QVector<EditOp> diffLines(const QVector<QStringView> &originalViews,
+                              const QVector<QStringView> &newViews) const;
 
     /**************************************************************************
      * @brief Builds textual summary of missing/new/changed functions.
@@ -91,6 +236,102 @@ public:
      *************************************************************************/
     QString buildSummary(const QMap<QString, FunctionBlock> &orig,
                          const QMap<QString, FunctionBlock> &news) const;
+
+    /**************************************************************************
+     * @brief Selects the diff kernel used by diffLines.
+     * @param algorithm Kernel to use.
+     *************************************************************************/
+    void setDiffAlgorithm(DiffAlgorithm algorithm);
+
+    /**************************************************************************
+     * @brief Returns the diff kernel used by diffLines.
+     *************************************************************************/
+    DiffAlgorithm diffAlgorithm() const;
+
+    /**************************************************************************
+     * @brief Selects the normalization policies, e.g. ignoring blank lines
+     *        or trailing semicolons, used by extractFunctions, fingerprints
+     *        and diffLines. The default is IgnoreCommentOnlyChanges; without
+     *        it, comments stay in the function bodies and edits to them count.
+     * @param flags Combination of Normalizer::Flag values.
+     *************************************************************************/
+    void setNormalizeFlags(unsigned flags);
+
+    /**************************************************************************
+     * @brief Returns the normalization policies.
+     *************************************************************************/
+    unsigned normalizeFlags() const;
+
+    /**************************************************************************
+     * @brief Bounds the work of one diffLines call. Past either limit the
+     *        Myers, patience and histogram kernels fall back to a coarse
+     *        diff and the affected runs are flagged approximate.
+     *        BitParallel and Lcs only check the deadline; inputs too large
+     *        for their tables are diffed by Myers, flagged approximate.
+     * @param maxEditCost Edit cost one Myers search may reach; 0 for none.
+     * @param maxMilliseconds Wall-clock limit per call; 0 for none.
+     *************************************************************************/
+    void setDiffBudget(int maxEditCost, int maxMilliseconds);
+
+    /**************************************************************************
+     * @brief Returns the edit cost limit; 0 means none.
+     *************************************************************************/
+    int maxEditCost() const;
+
+    /**************************************************************************
+     * @brief Returns the time limit in milliseconds; 0 means none.
+     *************************************************************************/
+    int maxMilliseconds() const;
+
+    /**************************************************************************
+     * @brief Returns the settings name of a diff kernel.
+     * @param algorithm Kernel.
+     * @return Lower-case name, e.g. "myers".
+     *************************************************************************/
+    static QString diffAlgorithmName(DiffAlgorithm algorithm);
+
+    /**************************************************************************
+     * @brief Parses a settings name back into a diff kernel.
+     * @param name Name from diffAlgorithmName.
+     * @return Matching kernel, or Auto if the name is unknown.
+     *************************************************************************/
+    static DiffAlgorithm diffAlgorithmFromName(const QString &name);
+
+    /**************************************************************************
+     * @brief Counts hunks: runs of consecutive changed rows.
+     * @param diff Edit script from diffLines.
+     * @return Number of hunks.
+     *************************************************************************/
+    static int countHunks(const QVector<EditOp> &diff);
+
+    /**************************************************************************
+     * @brief Counts diff rows: the lines of every run.
+     * @param diff Edit script from diffLines.
+     * @return Number of rows.
+     *************************************************************************/
+    static int countRows(const QVector<EditOp> &diff);
+
+    /**************************************************************************
+     * @brief Returns true if any run of the script is approximate.
+     * @param diff Edit script from diffLines.
+     *************************************************************************/
+    static bool isApproximate(const QVector<EditOp> &diff);
+
+    /**************************************************************************
+     * @brief Picks the kernel DiffAlgorithm::Auto runs for two sides:
+     *        Myers when few lines differ, BitParallel when the estimated
+     *        edit distance makes (N+M)D outgrow N*M/64 word ops.
+     * @param a Interned original line IDs.
+     * @param b Interned new line IDs.
+     * @return DiffAlgorithm::Myers or DiffAlgorithm::BitParallel.
+     *************************************************************************/
+    static DiffAlgorithm chooseDiffAlgorithm(const QVector<quint32> &a, const QVector<quint32> &b);
+
+private:
+    DiffAlgorithm m_diffAlgorithm; ///< Kernel used by diffLines
+    unsigned m_normalizeFlags;     ///< Normalizer::Flag policies
+    int m_maxEditCost;             ///< Myers search limit, 0 for none
+    int m_maxMilliseconds;         ///< diffLines time limit, 0 for none
 };
 
 /*************** End of CompareEngine.h **************************************/
@@ -0,0 +1,226 @@
+/******************************************************************************
+ * @file CompareJob.cpp
+ * @brief Implements the CompareJob class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.7
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * The job object lives on the GUI thread and never blocks it: the
+ * extraction and diff tasks run on QThreadPool::globalInstance() and
+ * only hand back implicitly shared values through QFutureWatcher.
+ * Every task captures its own copies and the Shared stop flag by
+ * pointer, as CopyJob tasks hold their Counters, so a task still
+ * running after the job is gone touches nothing of it and the job
+ * never waits for one. An extraction cannot be interrupted; a diff
+ * not yet started when the flag is set returns at once. Finished
+ * diffs are handed to the GUI at most RowsPerTick rows per event-loop
+ * tick, so a burst of results never stalls painting or input.
+ ******************************************************************************/
+
+#include "CompareJob.h"
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+#include <QTimer>
+
+/******************************************************************************
+ * @brief Constructor.
+ * @param engine Engine whose algorithm and normalization are used.
+ * @param original Original source text.
+ * @param changed New source text.
+ * @param parent Parent object.
+ ******************************************************************************/
+CompareJob::CompareJob(const CompareEngine &engine, const QString &original, const QString &changed,
+                       QObject *parent)
+    : QObject(parent)
+    , m_engine(engine)
+    , m_original(original)
+    , m_changed(changed)
+    , m_shared(new Shared())
+    , m_pendingExtractions(0)
+    , m_nextResult(0)
+    , m_running(false)
+    , m_diffsDone(false)
+    , m_drainQueued(false)
+{
+    connect(&m_origWatcher, &QFutureWatcherBase::finished, this, &CompareJob::onExtracted);
+    connect(&m_newWatcher, &QFutureWatcherBase::finished, this, &CompareJob::onExtracted);
+    connect(&m_diffWatcher, &QFutureWatcherBase::resultReadyAt, this, &CompareJob::onDiffReady);
+    connect(&m_diffWatcher, &QFutureWatcherBase::finished, this, &CompareJob::onDiffsFinished);
+}
+
+/******************************************************************************
+ * @brief Destructor. Cancels the background work; a cancel during a long
+ *        extraction must not block the GUI thread, so nothing is awaited.
+ ******************************************************************************/
+CompareJob::~CompareJob()
+{
+    m_running = false;
+    m_shared->stop = true;
+    m_diffWatcher.cancel();
+}
+
+/******************************************************************************
+ * @brief Starts extraction of both sides, each on its own pool thread.
+ ******************************************************************************/
+void CompareJob::start()
+{
+    if (m_running)
+    {
+        return;
+    }
+    m_running = true;
+    m_pendingExtractions = 2;
+    const CompareEngine engine = m_engine;
+    const QString original = m_original;
+    const QString changed = m_changed;
+    m_origWatcher.setFuture(QtConcurrent::run([engine, original]()
+                                              {
+                                                  return engine.extractFunctions(original);
+                                              }));
+    m_newWatcher.setFuture(QtConcurrent::run([engine, changed]()
+                                             {
+                                                 return engine.extractFunctions(changed);
+                                             }));
+}
+
+/******************************************************************************
+ * @brief Stops the job. Diffs already running finish on their threads and
+ *        are dropped; the rest are never started.
+ ******************************************************************************/
+void CompareJob::cancel()
+{
+    if (!m_running)
+    {
+        return;
+    }
+    m_running = false;
+    m_shared->stop = true;
+    m_diffWatcher.cancel();
+    emit canceled();
+}
+
+/******************************************************************************
+ * @brief Returns true between start() and finished()/canceled().
+ ******************************************************************************/
+bool CompareJob::isRunning() const
+{
+    return m_running;
+}
+
+/******************************************************************************
+ * @brief Starts the diffs once both extractions are done. Functions with
+ *        equal fingerprints are unchanged and are not diffed.
+ ******************************************************************************/
+void CompareJob::onExtracted()
+{
+    if (--m_pendingExtractions > 0 || !m_running)
+    {
+        return;
+    }
+    m_origMap = m_origWatcher.result();
+    m_newMap = m_newWatcher.result();
+    m_changedNames.clear();
+    for (auto it = m_origMap.constBegin(); it != m_origMap.constEnd(); ++it)
+    {
+        const auto found = m_newMap.constFind(it.key());
+        if (found != m_newMap.constEnd() && found.value().fingerprint != it.value().fingerprint)
+        {
+            m_changedNames << it.key();
+        }
+    }
+    emit extracted(int(m_changedNames.size()), m_origMap, m_newMap);
+    if (m_changedNames.isEmpty())
+    {
+        onDiffsFinished();
+        return;
+    }
+
+    const CompareEngine engine = m_engine;
+    const QMap<QString, FunctionBlock> origMap = m_origMap;
+    const QMap<QString, FunctionBlock> newMap = m_newMap;
+    const QSharedPointer<Shared> shared = m_shared;
+    m_nextResult = 0;
+    m_diffWatcher.setFuture(QtConcurrent::mapped(m_changedNames, [engine, origMap, newMap, shared](const QString &name)
+                                                 {
+                                                     FunctionDiff diff;
+                                                     diff.name = name;
+                                                     if (shared->stop)
+                                                     {
+                                                         return diff;
+                                                     }
+                                                     diff.ops = engine.diffLines(origMap.value(name).bodyLines(),
+                                                                                 newMap.value(name).bodyLines());
+                                                     return diff;
+                                                 }));
+}
+
+/******************************************************************************
+ * @brief Emits the diffs that are ready, unless a later tick already will.
+ * @param index Index of the result that became ready.
+ ******************************************************************************/
+void CompareJob::onDiffReady(int index)
+{
+    Q_UNUSED(index);
+    if (!m_drainQueued)
+    {
+        emitReady();
+    }
+}
+
+/******************************************************************************
+ * @brief Continues emitting on the tick after a full batch.
+ ******************************************************************************/
+void CompareJob::onDrainTick()
+{
+    m_drainQueued = false;
+    emitReady();
+}
+
+/******************************************************************************
+ * @brief Emits ready diffs in order, about RowsPerTick rows per call.
+ *        Results arrive in any order; one that overtakes an earlier
+ *        function waits for it. A full batch queues the rest for the next
+ *        tick; once the diffs are done and all are out, the summary follows.
+ ******************************************************************************/
+void CompareJob::emitReady()
+{
+    const QFuture<FunctionDiff> future = m_diffWatcher.future();
+    int rows = 0;
+    while (m_running && m_nextResult < m_changedNames.size() && future.isResultReadyAt(m_nextResult))
+    {
+        if (rows >= RowsPerTick)
+        {
+            m_drainQueued = true;
+            QTimer::singleShot(0, this, &CompareJob::onDrainTick);
+            return;
+        }
+        const FunctionDiff diff = future.resultAt(m_nextResult++);
+        rows += CompareEngine::countRows(diff.ops);
+        emit functionDiffed(diff.name, diff.ops);
+    }
+    if (m_running && m_diffsDone)
+    {
+        m_running = false;
+        emit finished(m_engine.buildSummary(m_origMap, m_newMap));
+    }
+}
+
+/******************************************************************************
+ * @brief Emits the summary once the diffs are done and handed over.
+ ******************************************************************************/
+void CompareJob::onDiffsFinished()
+{
+    if (!m_running)
+    {
+        return;
+    }
+    m_diffsDone = true;
+    if (!m_drainQueued)
+    {
+        emitReady();
+    }
+}
+
+/*************** End of CompareJob.cpp ***************************************/
@@ -0,0 +1,168 @@
+/******************************************************************************
+ * @file CompareJob.h
+ * @brief Declares the CompareJob class that runs a compare in the background.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.7
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Runs one compare off the GUI thread: both sides are extracted in
+ * parallel, then diffLines is mapped over the changed functions on the
+ * global thread pool. Results come back through QFutureWatcher's queued
+ * signals and are re-emitted in function name order, in batches of
+ * about RowsPerTick rows per event-loop tick, so the GUI shows them as
+ * they arrive and stays responsive while they do. A job can be canceled, or deleted, at any time
+ * without waiting: a canceled job emits canceled() and nothing else.
+ * Tasks still running finish on their own copies and are dropped.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QMap>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include "CompareEngine.h"
+
+/******************************************************************************
+ * @struct FunctionDiff
+ * @brief Edit script of one changed function. The script indexes the
+ *        bodyLines() of the function's blocks from extracted().
+ ******************************************************************************/
+struct FunctionDiff
+{
+    QString name;        /**< Function name */
+    QVector<EditOp> ops; /**< Edit script from CompareEngine::diffLines */
+};
+
+/******************************************************************************
+ * @class CompareJob
+ * @brief One background compare of two source texts.
+ ******************************************************************************/
+class CompareJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int RowsPerTick = 20000; ///< Diff rows handed to the GUI per event-loop tick
+
+    /**************************************************************************
+     * @brief Constructor. The engine settings are copied, so changing them
+     *        while the job runs does not affect it.
+     * @param engine Engine whose algorithm and normalization are used.
+     * @param original Original source text.
+     * @param changed New source text.
+     * @param parent Parent object.
+     *************************************************************************/
+    CompareJob(const CompareEngine &engine, const QString &original, const QString &changed,
+               QObject *parent = nullptr);
+
+    /**************************************************************************
+     * @brief Destructor. Cancels the background work without waiting.
+     *************************************************************************/
+    ~CompareJob() override;
+
+    /**************************************************************************
+     * @brief Starts extraction of both sides.
+     *************************************************************************/
+    void start();
+
+    /**************************************************************************
+     * @brief Stops the job; diffs not yet started are skipped.
+     *************************************************************************/
+    void cancel();
+
+    /**************************************************************************
+     * @brief Returns true between start() and finished()/canceled().
+     *************************************************************************/
+    bool isRunning() const;
+
+signals:
+    /**************************************************************************
+     * @brief Both sides are extracted.
+     * @param changedCount Number of functions that will be diffed.
+     * @param orig Original functions.
+     * @param news New functions.
+     *************************************************************************/
+    void extracted(int changedCount, const QMap<QString, FunctionBlock> &orig,
+                   const QMap<QString, FunctionBlock> &news);
+
+    /**************************************************************************
+     * @brief One changed function was diffed; sent in name order.
+     * @param name Function name.
+     * @param ops Edit script over the bodyLines() of both blocks.
+     *************************************************************************/
+    void functionDiffed(const QString &name, const QVector<EditOp> &ops);
+
+    /**************************************************************************
+     * @brief All functions were diffed.
+     * @param summary Text from CompareEngine::buildSummary.
+     *************************************************************************/
+    void finished(const QString &summary);
+
+    /**************************************************************************
+     * @brief The job was canceled.
+     *************************************************************************/
+    void canceled();
+
+private slots:
+    /**************************************************************************
+     * @brief Starts the diffs once both extractions are done.
+     *************************************************************************/
+    void onExtracted();
+
+    /**************************************************************************
+     * @brief Emits the diffs that are ready, unless a later tick will.
+     * @param index Index of the result that became ready.
+     *************************************************************************/
+    void onDiffReady(int index);
+
+    /**************************************************************************
+     * @brief Continues emitting on the tick after a full batch.
+     *************************************************************************/
+    void onDrainTick();
+
+    /**************************************************************************
+     * @brief Emits the summary when the diffs are done.
+     *************************************************************************/
+    void onDiffsFinished();
+
+private:
+    /**************************************************************************
+     * @brief Emits ready diffs in order, about RowsPerTick rows per call,
+     *        then the summary once all are out.
+     *************************************************************************/
+    void emitReady();
+
+    /**************************************************************************
+     * @struct Shared
+     * @brief State shared with the pool tasks, which may outlive the job.
+     *************************************************************************/
+    struct Shared
+    {
+        std::atomic<bool> stop{ false }; ///< Set by cancel() and the destructor
+    };
+
+    CompareEngine m_engine;                                      ///< Copied engine settings
+    QString m_original;                                          ///< Original text
+    QString m_changed;                                           ///< New text
+    QFutureWatcher<QMap<QString, FunctionBlock>> m_origWatcher;  ///< Original extraction
+    QFutureWatcher<QMap<QString, FunctionBlock>> m_newWatcher;   ///< New extraction
+    QFutureWatcher<FunctionDiff> m_diffWatcher;                  ///< Mapped diffs
+    QMap<QString, FunctionBlock> m_origMap;                      ///< Original functions
+    QMap<QString, FunctionBlock> m_newMap;                       ///< New functions
+    QStringList m_changedNames;                                  ///< Functions to diff
+    QSharedPointer<Shared> m_shared;                             ///< Stop flag of the tasks
+    int m_pendingExtractions;                                    ///< Extractions still running
+    int m_nextResult;                                            ///< Next diff to emit
+    bool m_running;                                              ///< Between start and end
+    bool m_diffsDone;                                            ///< All diffs computed
+    bool m_drainQueued;                                          ///< A drain tick is pending
+};
+
+/*************** End of CompareJob.h *****************************************/
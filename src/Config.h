@@ -3,17 +3,21 @@
  * @brief Global configuration macros for debug output.
  *
  * @author Jeffrey Scott Flesher with the help of AI
- * @version 0.6
- * @date    2025-11-07
+ * @version 0.7
+ * @date    2026-10-16
  * @section License Unlicensed, MIT, or any.
  * @section DESCRIPTION
  * Provides a SHOW_DEBUG toggle and DEBUG_MSG() macro that
  * expands to qDebug() with function name context.
  * Usage: At top of file add: #define SHOW_DEBUG 1, then include Config.h
  * Set it to 1 to enable debug messages, or 0 to turn it off.
+ * PROFILE_SCOPE("phase") times the rest of the enclosing scope
+ * with a ScopedTimer (see Profiler.h); SHOW_PROFILE 0 removes
+ * every timer from the build.
  ***************************************************************/
 #pragma once
 #include <QDebug>
+#include "Profiler.h"
 
 /****************************************************************
  * @def SHOW_DEBUG
@@ -38,4 +42,29 @@
     #define DEBUG_MSG() if (true) {} else qDebug()
 #endif
 
+/****************************************************************
+ * @def SHOW_PROFILE
+ * @brief Compile phase timers in: 1 (default) or 0. Unlike
+ * SHOW_DEBUG it is set for the whole build (DIFFCHECK_PROFILE in
+ * CMake); the timers themselves are switched on at run time with
+ * Profiler::setEnabled.
+ ***************************************************************/
+#ifndef SHOW_PROFILE
+    #define SHOW_PROFILE 1
+#endif
+
+/****************************************************************
+ * @def PROFILE_SCOPE
+ * @brief Times the rest of the enclosing scope as phase @p name,
+ * which must be a string literal. Compiles to nothing when
+ * SHOW_PROFILE is 0.
+ ***************************************************************/
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+#if SHOW_PROFILE
+    #define PROFILE_SCOPE(name) ScopedTimer PROFILE_CONCAT(profileScope, __LINE__)(name)
+#else
+    #define PROFILE_SCOPE(name) do {} while (false)
+#endif
+
 /************** End of Config.h **************************/
@@ -0,0 +1,619 @@
+/******************************************************************************
+ * @file CopyJob.cpp
+ * @brief Implements the CopyJob class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.4
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * The walk runs as one pool task and makes every folder, so the copy
+ * tasks never race on mkpath. Each copy task owns its file descriptors
+ * and only touches the shared Counters, which it holds by pointer, as
+ * CompareJob tasks hold their own copies. A file that fails halfway is
+ * removed, so the target never holds a silently truncated file. A
+ * copy is written to a hidden sibling and renamed over the target, so
+ * a hard link made by linkFile can only be broken, never written
+ * through, and a failed copy leaves the old target as it was.
+ ******************************************************************************/
+
+#include "CopyJob.h"
+#include "Config.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSet>
+#include <QThread>
+#include <QtConcurrent/QtConcurrentMap>
+#include <QtConcurrent/QtConcurrentRun>
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <cerrno>
+#include <cstdio>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#ifdef Q_OS_LINUX
+#include <fcntl.h>
+#include <linux/fs.h>
+#include <sys/ioctl.h>
+#endif
+
+/******************************************************************************
+ * @brief Constructor.
+ * @param parent Parent object.
+ ******************************************************************************/
+CopyJob::CopyJob(QObject *parent)
+    : QObject(parent)
+    , m_linkFiles(false)
+    , m_counters(new Counters())
+    , m_running(false)
+{
+    // I/O bound: a few threads overlap the waits, more only add seeks
+    m_pool.setMaxThreadCount(qBound(2, QThread::idealThreadCount(), MaxThreads));
+    m_progressTimer.setInterval(ProgressIntervalMs);
+    connect(&m_planWatcher, &QFutureWatcherBase::finished, this, &CopyJob::onPlanned);
+    connect(&m_copyWatcher, &QFutureWatcherBase::finished, this, &CopyJob::onCopied);
+    connect(&m_progressTimer, &QTimer::timeout, this, &CopyJob::onProgressTimer);
+}
+
+/******************************************************************************
+ * @brief Destructor. Cancels and waits for the background work.
+ ******************************************************************************/
+CopyJob::~CopyJob()
+{
+    m_running = false;
+    m_counters->stop = true;
+    m_copyWatcher.cancel();
+    m_planWatcher.waitForFinished();
+    m_copyWatcher.waitForFinished();
+    m_pool.waitForDone();
+}
+
+/******************************************************************************
+ * @brief Queues the contents of a folder to be copied into another.
+ ******************************************************************************/
+void CopyJob::addTree(const QString &sourceDir, const QString &targetDir, const QStringList &skipNames)
+{
+    m_sources << sourceDir;
+    m_targets << targetDir;
+    m_skipNames << skipNames;
+}
+
+/******************************************************************************
+ * @brief Replaces the tree walk with a planner.
+ ******************************************************************************/
+void CopyJob::setPlanner(const std::function<CopyPlan()> &planner)
+{
+    m_planner = planner;
+}
+
+/******************************************************************************
+ * @brief Shares the files with linkFile instead of copying them.
+ ******************************************************************************/
+void CopyJob::setLinkFiles(bool link)
+{
+    m_linkFiles = link;
+}
+
+/******************************************************************************
+ * @brief Starts the walk on the copy pool.
+ ******************************************************************************/
+void CopyJob::start()
+{
+    if (m_running)
+    {
+        return;
+    }
+    m_running = true;
+    m_errors.clear();
+    m_plan = CopyPlan();
+    m_counters->bytesDone = 0;
+    m_counters->stop = false;
+    std::function<CopyPlan()> planner = m_planner;
+    if (!planner)
+    {
+        const QStringList sources = m_sources;
+        const QStringList targets = m_targets;
+        const QVector<QStringList> skipNames = m_skipNames;
+        planner = [sources, targets, skipNames]()
+        {
+            return plan(sources, targets, skipNames);
+        };
+    }
+    m_planWatcher.setFuture(QtConcurrent::run(&m_pool, planner));
+}
+
+/******************************************************************************
+ * @brief Stops the job.
+ ******************************************************************************/
+void CopyJob::cancel()
+{
+    if (!m_running)
+    {
+        return;
+    }
+    m_running = false;
+    m_counters->stop = true;
+    m_copyWatcher.cancel();
+    m_progressTimer.stop();
+    emit canceled();
+}
+
+/******************************************************************************
+ * @brief Returns true between start() and finished()/canceled().
+ ******************************************************************************/
+bool CopyJob::isRunning() const
+{
+    return m_running;
+}
+
+/******************************************************************************
+ * @brief Returns the plan being copied.
+ ******************************************************************************/
+const CopyPlan &CopyJob::currentPlan() const
+{
+    return m_plan;
+}
+
+/******************************************************************************
+ * @brief Starts the copies once the walk is done.
+ ******************************************************************************/
+void CopyJob::onPlanned()
+{
+    if (!m_running)
+    {
+        return;
+    }
+    m_plan = m_planWatcher.result();
+    m_errors = m_plan.errors;
+    emit planned(int(m_plan.files.size()), m_plan.bytes);
+    if (m_plan.files.isEmpty())
+    {
+        onCopied();
+        return;
+    }
+
+    const QSharedPointer<Counters> counters = m_counters;
+    const bool link = m_linkFiles;
+    m_progressTimer.start();
+    m_copyWatcher.setFuture(QtConcurrent::mapped(&m_pool, m_plan.files, [counters, link](const CopyItem &item)
+                                                 {
+                                                     if (counters->stop)
+                                                     {
+                                                         return QString();
+                                                     }
+                                                     if (link)
+                                                     {
+                                                         return linkFile(item.source, item.target,
+                                                                         &counters->bytesDone, &counters->stop);
+                                                     }
+                                                     return copyFile(item.source, item.target,
+                                                                     &counters->bytesDone, &counters->stop);
+                                                 }));
+}
+
+/******************************************************************************
+ * @brief Collects the copy errors and ends the job.
+ ******************************************************************************/
+void CopyJob::onCopied()
+{
+    if (!m_running)
+    {
+        return;
+    }
+    m_running = false;
+    m_progressTimer.stop();
+    const QFuture<QString> future = m_copyWatcher.future();
+    const int count = future.resultCount();
+    for (int i = 0; i < count; ++i)
+    {
+        const QString error = future.resultAt(i);
+        if (!error.isEmpty())
+        {
+            m_errors << error;
+        }
+    }
+    emit progress(m_counters->bytesDone, m_plan.bytes);
+    emit finished(m_errors);
+}
+
+/******************************************************************************
+ * @brief Emits progress().
+ ******************************************************************************/
+void CopyJob::onProgressTimer()
+{
+    emit progress(m_counters->bytesDone, m_plan.bytes);
+}
+
+/******************************************************************************
+ * @brief Walks the trees, creating every target folder. Each folder is
+ *        read once; symlinked folders are followed like any other, but
+ *        a canonical path already walked is not walked again.
+ ******************************************************************************/
+CopyPlan CopyJob::plan(const QStringList &sourceDirs, const QStringList &targetDirs,
+                       const QVector<QStringList> &skipNames)
+{
+    PROFILE_SCOPE("copy plan");
+    CopyPlan result;
+    QSet<QString> walked;
+    for (int t = 0; t < sourceDirs.size(); ++t)
+    {
+        QStringList sourceStack(sourceDirs.at(t));
+        QStringList targetStack(targetDirs.at(t));
+        bool top = true;
+        while (!sourceStack.isEmpty())
+        {
+            const QString source = sourceStack.takeLast();
+            const QString target = targetStack.takeLast();
+            const QString canonical = QFileInfo(source).canonicalFilePath();
+            if (walked.contains(canonical))
+            {
+                continue;
+            }
+            walked.insert(canonical);
+            if (!QDir().mkpath(target))
+            {
+                result.errors << QString("Cannot create folder %1").arg(target);
+                top = false;
+                continue;
+            }
+            const QDir dir(source);
+            if (!dir.exists())
+            {
+                result.errors << QString("Cannot read folder %1").arg(source);
+                top = false;
+                continue;
+            }
+            const QFileInfoList entries = dir.entryInfoList(QDir::NoDotAndDotDot | QDir::AllEntries, QDir::Name);
+            for (int i = 0; i < entries.size(); ++i)
+            {
+                const QFileInfo &entry = entries.at(i);
+                if (top && skipNames.value(t).contains(entry.fileName()))
+                {
+                    continue;
+                }
+                const QString entryTarget = target + "/" + entry.fileName();
+                if (entry.isDir())
+                {
+                    sourceStack << entry.absoluteFilePath();
+                    targetStack << entryTarget;
+                }
+                else
+                {
+                    CopyItem item;
+                    item.source = entry.absoluteFilePath();
+                    item.target = entryTarget;
+                    item.size = entry.size();
+                    result.bytes += item.size;
+                    result.files << item;
+                }
+            }
+            top = false;
+        }
+    }
+    return result;
+}
+
+/******************************************************************************
+ * @brief Returns the hidden sibling a copy to @p target is written to.
+ *        Tree walks skip hidden entries, so a leftover is never copied.
+ ******************************************************************************/
+static QString partPath(const QString &target)
+{
+    const QFileInfo info(target);
+    return info.absolutePath() + "/." + info.fileName() + ".part";
+}
+
+/******************************************************************************
+ * @brief Moves a finished copy over its target; removes it on failure.
+ * @return Empty on success, else the reason.
+ ******************************************************************************/
+static QString replaceFile(const QString &part, const QString &target)
+{
+#ifdef Q_OS_UNIX
+    if (::rename(QFile::encodeName(part).constData(), QFile::encodeName(target).constData()) != 0)
+    {
+        const int error = errno;
+        QFile::remove(part);
+        return qt_error_string(error);
+    }
+#else
+    // QFile::rename does not replace; the target is only a name here
+    QFile::remove(target);
+    QFile file(part);
+    if (!file.rename(target))
+    {
+        const QString error = file.errorString();
+        QFile::remove(part);
+        return error;
+    }
+#endif
+    return QString();
+}
+
+#ifdef Q_OS_LINUX
+/******************************************************************************
+ * @brief Copies @p in to @p out on Linux: FICLONE, then copy_file_range,
+ *        then read/write for whatever is left. Both descriptors are at
+ *        offset 0; copy_file_range advances them, so the buffered loop
+ *        resumes where the kernel copy stopped.
+ * @return 0 on success, else errno; ECANCELED if stopped.
+ ******************************************************************************/
+static int copyDescriptors(int in, int out, qint64 size, std::atomic<qint64> *bytesDone,
+                           const std::atomic<bool> *stop)
+{
+    if (stop && *stop)
+    {
+        return ECANCELED;
+    }
+#ifdef FICLONE
+    if (::ioctl(out, FICLONE, in) == 0)
+    {
+        if (bytesDone)
+        {
+            *bytesDone += size;
+        }
+        return 0;
+    }
+#endif
+    bool kernelCopy = true;
+    QByteArray buffer;
+    for (;;)
+    {
+        if (stop && *stop)
+        {
+            return ECANCELED;
+        }
+        ssize_t written = 0;
+        if (kernelCopy)
+        {
+            written = ::copy_file_range(in, nullptr, out, nullptr, size_t(CopyJob::ChunkBytes), 0);
+            if (written < 0 && (errno == EXDEV || errno == ENOSYS || errno == EOPNOTSUPP || errno == EINVAL))
+            {
+                // Different file systems, old kernel or special file: copy through memory
+                kernelCopy = false;
+                continue;
+            }
+        }
+        else
+        {
+            if (buffer.isEmpty())
+            {
+                buffer.resize(int(qMin<qint64>(CopyJob::ChunkBytes, 1024 * 1024)));
+            }
+            const ssize_t got = ::read(in, buffer.data(), size_t(buffer.size()));
+            written = got;
+            for (ssize_t offset = 0; got > 0 && offset < got;)
+            {
+                const ssize_t put = ::write(out, buffer.constData() + offset, size_t(got - offset));
+                if (put < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+                    return errno;
+                }
+                offset += put;
+            }
+        }
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return errno;
+        }
+        if (written == 0)
+        {
+            return 0;
+        }
+        if (bytesDone)
+        {
+            *bytesDone += written;
+        }
+    }
+}
+#endif
+
+/******************************************************************************
+ * @brief Copies one file, keeping its permissions and modification time,
+ *        so later compares of size and time see it as unchanged.
+ ******************************************************************************/
+QString CopyJob::copyFile(const QString &source, const QString &target, std::atomic<qint64> *bytesDone,
+                          const std::atomic<bool> *stop)
+{
+    PROFILE_SCOPE("copyFile");
+#ifdef Q_OS_LINUX
+    const QByteArray sourcePath = QFile::encodeName(source);
+    const int in = ::open(sourcePath.constData(), O_RDONLY | O_CLOEXEC);
+    if (in < 0)
+    {
+        return QString("%1: %2").arg(source, qt_error_string(errno));
+    }
+    struct stat info;
+    if (::fstat(in, &info) != 0)
+    {
+        const int error = errno;
+        ::close(in);
+        return QString("%1: %2").arg(source, qt_error_string(error));
+    }
+    // Replace the target, never write through it: it may be a hard link
+    const QString part = partPath(target);
+    const QByteArray partName = QFile::encodeName(part);
+    const int out = ::open(partName.constData(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, info.st_mode & 07777);
+    if (out < 0)
+    {
+        const int error = errno;
+        ::close(in);
+        return QString("%1: %2").arg(target, qt_error_string(error));
+    }
+    int error = copyDescriptors(in, out, qint64(info.st_size), bytesDone, stop);
+    if (error == 0)
+    {
+        // O_CREAT applies the umask
+        ::fchmod(out, info.st_mode & 07777);
+        const struct timespec times[2] = { info.st_atim, info.st_mtim };
+        ::futimens(out, times);
+    }
+    ::close(in);
+    if (::close(out) != 0 && error == 0)
+    {
+        error = errno;
+    }
+    if (error != 0)
+    {
+        ::unlink(partName.constData());
+        return QString("%1: %2").arg(source, error == ECANCELED ? QString("canceled") : qt_error_string(error));
+    }
+    const QString renameError = replaceFile(part, target);
+    return renameError.isEmpty() ? QString() : QString("%1: %2").arg(target, renameError);
+#else
+    QFile in(source);
+    if (!in.open(QIODevice::ReadOnly))
+    {
+        return QString("%1: %2").arg(source, in.errorString());
+    }
+    // Replace the target, never write through it: it may be a hard link
+    const QString part = partPath(target);
+    QFile out(part);
+    if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return QString("%1: %2").arg(target, out.errorString());
+    }
+    QString error;
+    QByteArray buffer;
+    while (error.isEmpty())
+    {
+        if (stop && *stop)
+        {
+            error = "canceled";
+            break;
+        }
+        buffer = in.read(qMin<qint64>(ChunkBytes, 1024 * 1024));
+        if (buffer.isEmpty())
+        {
+            if (in.error() != QFileDevice::NoError)
+            {
+                error = in.errorString();
+            }
+            break;
+        }
+        if (out.write(buffer) != buffer.size())
+        {
+            error = out.errorString();
+            break;
+        }
+        if (bytesDone)
+        {
+            *bytesDone += buffer.size();
+        }
+    }
+    if (error.isEmpty())
+    {
+        out.setFileTime(QFileInfo(in).lastModified(), QFileDevice::FileModificationTime);
+    }
+    out.close();
+    if (error.isEmpty())
+    {
+        QFile::setPermissions(part, QFile::permissions(source));
+        const QString renameError = replaceFile(part, target);
+        return renameError.isEmpty() ? QString() : QString("%1: %2").arg(target, renameError);
+    }
+    QFile::remove(part);
+    return QString("%1: %2").arg(source, error);
+#endif
+}
+
+/******************************************************************************
+ * @brief Shares one file instead of copying it: a reflink clone where the
+ *        file system has them (private to the target from the start), else
+ *        a hard link, else a copy when linking is not possible, e.g.
+ *        across file systems.
+ ******************************************************************************/
+QString CopyJob::linkFile(const QString &source, const QString &target, std::atomic<qint64> *bytesDone,
+                          const std::atomic<bool> *stop)
+{
+    PROFILE_SCOPE("linkFile");
+#ifdef Q_OS_UNIX
+    if (stop && *stop)
+    {
+        return QString("%1: canceled").arg(source);
+    }
+    const QByteArray sourcePath = QFile::encodeName(source);
+    const QByteArray targetPath = QFile::encodeName(target);
+    struct stat info;
+    if (::stat(sourcePath.constData(), &info) != 0)
+    {
+        return QString("%1: %2").arg(source, qt_error_string(errno));
+    }
+    ::unlink(targetPath.constData());
+#if defined(Q_OS_LINUX) && defined(FICLONE)
+    const int in = ::open(sourcePath.constData(), O_RDONLY | O_CLOEXEC);
+    const int out = in < 0 ? -1 : ::open(targetPath.constData(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, info.st_mode & 07777);
+    const bool cloned = out >= 0 && ::ioctl(out, FICLONE, in) == 0;
+    if (cloned)
+    {
+        ::fchmod(out, info.st_mode & 07777);
+        const struct timespec times[2] = { info.st_atim, info.st_mtim };
+        ::futimens(out, times);
+    }
+    if (out >= 0)
+    {
+        ::close(out);
+    }
+    if (in >= 0)
+    {
+        ::close(in);
+    }
+    if (cloned)
+    {
+        if (bytesDone)
+        {
+            *bytesDone += qint64(info.st_size);
+        }
+        return QString();
+    }
+    ::unlink(targetPath.constData());
+#endif
+    if (::link(sourcePath.constData(), targetPath.constData()) == 0)
+    {
+        if (bytesDone)
+        {
+            *bytesDone += qint64(info.st_size);
+        }
+        return QString();
+    }
+#endif
+    return copyFile(source, target, bytesDone, stop);
+}
+
+/******************************************************************************
+ * @brief Gives a hard-linked file its own copy before it is written, so
+ *        the write does not reach the other links (break-on-write). A
+ *        copy onto itself does it: copyFile renames the copy over the
+ *        path, so the other links keep the old content and the file
+ *        keeps its mode and time.
+ ******************************************************************************/
+QString CopyJob::unshareFile(const QString &path)
+{
+#ifdef Q_OS_UNIX
+    const QByteArray native = QFile::encodeName(path);
+    struct stat info;
+    if (::stat(native.constData(), &info) != 0 || !S_ISREG(info.st_mode) || info.st_nlink < 2)
+    {
+        return QString();
+    }
+    PROFILE_SCOPE("unshareFile");
+    return copyFile(path, path);
+#else
+    Q_UNUSED(path);
+#endif
+    return QString();
+}
+
+/*************** End of CopyJob.cpp ******************************************/
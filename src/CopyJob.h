@@ -0,0 +1,244 @@
+/******************************************************************************
+ * @file CopyJob.h
+ * @brief Declares the CopyJob class that copies folder trees in the background.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.4
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Copies one or more folder trees off the GUI thread. The trees are
+ * walked once, creating every target folder, then the files are copied
+ * on a bounded pool of its own, so a large project does not starve the
+ * global pool used by CompareJob. On Linux a file is first cloned with
+ * FICLONE (instant on Btrfs/XFS), then copied in kernel with
+ * copy_file_range, and only then through a user-space buffer.
+ * Failures do not stop the job: they are collected and handed over in
+ * one list when it ends. Progress is counted in bytes as they are
+ * written, and reported on a timer. A planner can replace the walk, so
+ * an incremental sync reuses the same copy engine. With setLinkFiles the
+ * files are shared instead (clone or hard link), and writers call
+ * unshareFile first so a write never reaches the source.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QSharedPointer>
+#include <QString>
+#include <QStringList>
+#include <QThreadPool>
+#include <QTimer>
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+/******************************************************************************
+ * @struct CopyItem
+ * @brief One file to copy.
+ ******************************************************************************/
+struct CopyItem
+{
+    QString source;  /**< Absolute source path */
+    QString target;  /**< Absolute target path */
+    qint64 size = 0; /**< Source size when walked */
+};
+
+/******************************************************************************
+ * @struct CopyPlan
+ * @brief Result of the walk: the files to copy and the walk errors.
+ ******************************************************************************/
+struct CopyPlan
+{
+    QVector<CopyItem> files; /**< Files in walk order */
+    QStringList errors;      /**< Folders that could not be read or made */
+    qint64 bytes = 0;        /**< Sum of the file sizes */
+    int unchanged = 0;       /**< Files a planner found already up to date */
+    int removed = 0;         /**< Entries a planner removed from the target */
+};
+
+/******************************************************************************
+ * @class CopyJob
+ * @brief One background copy of folder trees.
+ ******************************************************************************/
+class CopyJob : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 ChunkBytes = 8 * 1024 * 1024; ///< Bytes per copy step; cancel and progress granularity
+    static constexpr int MaxThreads = 8;                  ///< Upper bound of the copy pool
+    static constexpr int ProgressIntervalMs = 100;        ///< Period of progress()
+
+    /**************************************************************************
+     * @brief Constructor.
+     * @param parent Parent object.
+     *************************************************************************/
+    explicit CopyJob(QObject *parent = nullptr);
+
+    /**************************************************************************
+     * @brief Destructor. Cancels and waits for the background work.
+     *************************************************************************/
+    ~CopyJob() override;
+
+    /**************************************************************************
+     * @brief Queues the contents of @p sourceDir to be copied into
+     *        @p targetDir. Call before start().
+     * @param sourceDir Folder whose entries are copied.
+     * @param targetDir Folder that receives them; created if missing.
+     * @param skipNames Top-level entry names to leave out, e.g. "build".
+     *************************************************************************/
+    void addTree(const QString &sourceDir, const QString &targetDir,
+                 const QStringList &skipNames = QStringList());
+
+    /**************************************************************************
+     * @brief Replaces the tree walk with @p planner, run on the copy pool
+     *        before the copies (TempSync::plan copies only what changed).
+     *        The trees queued with addTree are then ignored.
+     *************************************************************************/
+    void setPlanner(const std::function<CopyPlan()> &planner);
+
+    /**************************************************************************
+     * @brief Shares the files with linkFile instead of copying them.
+     *        Call before start().
+     *************************************************************************/
+    void setLinkFiles(bool link);
+
+    /**************************************************************************
+     * @brief Starts the walk, then the copies.
+     *************************************************************************/
+    void start();
+
+    /**************************************************************************
+     * @brief Stops the job; files being copied stop at the next chunk and
+     *        are removed, the rest are never started.
+     *************************************************************************/
+    void cancel();
+
+    /**************************************************************************
+     * @brief Returns true between start() and finished()/canceled().
+     *************************************************************************/
+    bool isRunning() const;
+
+    /**************************************************************************
+     * @brief Returns the plan being copied; empty before planned().
+     *************************************************************************/
+    const CopyPlan &currentPlan() const;
+
+    /**************************************************************************
+     * @brief Walks the trees: creates every target folder and lists the
+     *        files. Hidden entries are left out, as QDir::AllEntries does;
+     *        a folder reached twice through symlinks is walked once.
+     * @param sourceDirs Source folders.
+     * @param targetDirs Target folder of each source.
+     * @param skipNames Top-level names to leave out, per source.
+     * @return Files, errors and total size.
+     *************************************************************************/
+    static CopyPlan plan(const QStringList &sourceDirs, const QStringList &targetDirs,
+                         const QVector<QStringList> &skipNames);
+
+    /**************************************************************************
+     * @brief Copies one file, keeping its permissions and modification time.
+     *        The copy is written beside the target and renamed over it, so
+     *        a hard-linked target is replaced, never written through.
+     * @param source Source path.
+     * @param target Target path; its folder must exist. May be @p source.
+     * @param bytesDone Increased by every chunk written; may be nullptr.
+     * @param stop Checked between chunks; may be nullptr.
+     * @return Empty on success, else a one-line error naming the file.
+     *************************************************************************/
+    static QString copyFile(const QString &source, const QString &target,
+                            std::atomic<qint64> *bytesDone = nullptr,
+                            const std::atomic<bool> *stop = nullptr);
+
+    /**************************************************************************
+     * @brief Shares one file instead of copying it: a reflink clone where
+     *        the file system supports it, else a hard link, else a copy.
+     *        A hard-linked target must go through unshareFile before it
+     *        is written.
+     * @param source Source path.
+     * @param target Target path; replaced if it exists.
+     * @param bytesDone Increased by the file size; may be nullptr.
+     * @param stop Checked before starting; may be nullptr.
+     * @return Empty on success, else a one-line error naming the file.
+     *************************************************************************/
+    static QString linkFile(const QString &source, const QString &target,
+                            std::atomic<qint64> *bytesDone = nullptr,
+                            const std::atomic<bool> *stop = nullptr);
+
+    /**************************************************************************
+     * @brief Breaks a hard link before a write: if @p path has other links,
+     *        it is replaced by its own copy. Does nothing otherwise.
+     * @param path File about to be written.
+     * @return Empty on success, else a one-line error.
+     *************************************************************************/
+    static QString unshareFile(const QString &path);
+
+signals:
+    /**************************************************************************
+     * @brief The trees were walked.
+     * @param files Number of files to copy.
+     * @param bytes Their total size.
+     *************************************************************************/
+    void planned(int files, qint64 bytes);
+
+    /**************************************************************************
+     * @brief Bytes written so far; sent every ProgressIntervalMs.
+     *************************************************************************/
+    void progress(qint64 bytesDone, qint64 bytesTotal);
+
+    /**************************************************************************
+     * @brief Every file was tried.
+     * @param errors One line per failure; empty if everything was copied.
+     *************************************************************************/
+    void finished(const QStringList &errors);
+
+    /**************************************************************************
+     * @brief The job was canceled.
+     *************************************************************************/
+    void canceled();
+
+private slots:
+    /**************************************************************************
+     * @brief Starts the copies once the walk is done.
+     *************************************************************************/
+    void onPlanned();
+
+    /**************************************************************************
+     * @brief Collects the errors and ends the job.
+     *************************************************************************/
+    void onCopied();
+
+    /**************************************************************************
+     * @brief Emits progress().
+     *************************************************************************/
+    void onProgressTimer();
+
+private:
+    /**************************************************************************
+     * @struct Counters
+     * @brief State shared with the pool tasks, which may outlive a cancel.
+     *************************************************************************/
+    struct Counters
+    {
+        std::atomic<qint64> bytesDone{ 0 }; ///< Bytes written
+        std::atomic<bool> stop{ false };    ///< Set by cancel()
+    };
+
+    QStringList m_sources;                       ///< Queued source folders
+    QStringList m_targets;                       ///< Target of each source
+    QVector<QStringList> m_skipNames;            ///< Skipped top-level names per source
+    std::function<CopyPlan()> m_planner;         ///< Replaces plan() when set
+    bool m_linkFiles;                            ///< linkFile instead of copyFile
+    QThreadPool m_pool;                          ///< Bounded copy pool
+    QSharedPointer<Counters> m_counters;         ///< Progress and stop flag
+    QFutureWatcher<CopyPlan> m_planWatcher;      ///< Walk
+    QFutureWatcher<QString> m_copyWatcher;       ///< Mapped file copies
+    QTimer m_progressTimer;                      ///< Drives progress()
+    QStringList m_errors;                        ///< Walk errors, then copy errors
+    CopyPlan m_plan;                             ///< Result of the walk
+    bool m_running;                              ///< Between start and end
+};
+
+/*************** End of CopyJob.h ********************************************/
@@ -0,0 +1,321 @@
+/******************************************************************************
+ * @file CppLexer.cpp
+ * @brief Implements the single-pass C/C++ lexer used by CompareEngine.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Hand-written scanner: every character is looked at once, literals
+ * and comments are skipped by their closing delimiters, so text such
+ * as "http://x" or '{' never confuses comment or brace handling.
+ ******************************************************************************/
+
+#include "CppLexer.h"
+
+/******************************************************************************
+ * @brief Returns true if c can start an identifier.
+ ******************************************************************************/
+static bool isIdentifierStart(QChar c)
+{
+    return c.isLetter() || c == QLatin1Char('_') || c == QLatin1Char('$');
+}
+
+/******************************************************************************
+ * @brief Returns true if c can continue an identifier.
+ ******************************************************************************/
+static bool isIdentifierChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_') || c == QLatin1Char('$');
+}
+
+/******************************************************************************
+ * @brief Tokenizes source text in one pass.
+ * @param code Source text.
+ * @return Token spans in source order.
+ ******************************************************************************/
+QVector<CppToken> CppLexer::tokenize(QStringView code)
+{
+    QVector<CppToken> tokens;
+    tokens.reserve(code.size() / 4);
+    const int n = int(code.size());
+    int pos = 0;
+    bool lineStart = true; // Only whitespace or comments since the last newline
+    while (pos < n)
+    {
+        const QChar c = code.at(pos);
+        if (c == QLatin1Char('\n'))
+        {
+            lineStart = true;
+            ++pos;
+            continue;
+        }
+        if (c.isSpace())
+        {
+            ++pos;
+            continue;
+        }
+
+        const int start = pos;
+        const QChar next = (pos + 1 < n) ? code.at(pos + 1) : QChar();
+        CppTokenKind kind = CppTokenKind::Punct;
+        if (c == QLatin1Char('#') && lineStart)
+        {
+            kind = CppTokenKind::Preprocessor;
+            pos = skipDirective(code, pos);
+        }
+        else if (c == QLatin1Char('/') && next == QLatin1Char('/'))
+        {
+            kind = CppTokenKind::LineComment;
+            pos += 2;
+            while (pos < n && code.at(pos) != QLatin1Char('\n') && code.at(pos) != QLatin1Char('\r'))
+            {
+                ++pos;
+            }
+        }
+        else if (c == QLatin1Char('/') && next == QLatin1Char('*'))
+        {
+            kind = CppTokenKind::BlockComment;
+            const qsizetype close = code.indexOf(QLatin1String("*/"), pos + 2);
+            pos = (close < 0) ? n : int(close) + 2;
+        }
+        else if (c == QLatin1Char('"'))
+        {
+            kind = CppTokenKind::String;
+            pos = skipQuoted(code, pos, c);
+        }
+        else if (c == QLatin1Char('\''))
+        {
+            kind = CppTokenKind::Char;
+            pos = skipQuoted(code, pos, c);
+        }
+        else if (isIdentifierStart(c))
+        {
+            kind = CppTokenKind::Identifier;
+            ++pos;
+            while (pos < n && isIdentifierChar(code.at(pos)))
+            {
+                ++pos;
+            }
+            // Encoding and raw prefixes glue onto the literal that follows
+            if (pos < n && (code.at(pos) == QLatin1Char('"') || code.at(pos) == QLatin1Char('\'')))
+            {
+                const QStringView word = code.mid(start, pos - start);
+                const QChar quote = code.at(pos);
+                if (quote == QLatin1Char('"') && (word == u"R" || word == u"u8R" || word == u"uR"
+                                                  || word == u"UR" || word == u"LR"))
+                {
+                    kind = CppTokenKind::RawString;
+                    pos = skipRawString(code, pos);
+                }
+                else if (word == u"u8" || word == u"u" || word == u"U" || word == u"L")
+                {
+                    kind = (quote == QLatin1Char('"')) ? CppTokenKind::String : CppTokenKind::Char;
+                    pos = skipQuoted(code, pos, quote);
+                }
+            }
+        }
+        else if (c.isDigit() || (c == QLatin1Char('.') && next.isDigit()))
+        {
+            kind = CppTokenKind::Number;
+            const bool hex = (c == QLatin1Char('0') && (next == QLatin1Char('x') || next == QLatin1Char('X')));
+            ++pos;
+            while (pos < n)
+            {
+                const QChar d = code.at(pos);
+                const QChar prev = code.at(pos - 1);
+                const bool exponent = hex ? (prev == QLatin1Char('p') || prev == QLatin1Char('P'))
+                                          : (prev == QLatin1Char('e') || prev == QLatin1Char('E'));
+                if (d.isLetterOrNumber() || d == QLatin1Char('_') || d == QLatin1Char('.'))
+                {
+                    ++pos;
+                }
+                else if (d == QLatin1Char('\'') && pos + 1 < n && code.at(pos + 1).isLetterOrNumber())
+                {
+                    ++pos; // Digit separator, as in 1'000'000
+                }
+                else if ((d == QLatin1Char('+') || d == QLatin1Char('-')) && exponent)
+                {
+                    ++pos;
+                }
+                else
+                {
+                    break;
+                }
+            }
+        }
+        else
+        {
+            switch (c.unicode())
+            {
+            case '{': kind = CppTokenKind::OpenBrace; break;
+            case '}': kind = CppTokenKind::CloseBrace; break;
+            case '(': kind = CppTokenKind::OpenParen; break;
+            case ')': kind = CppTokenKind::CloseParen; break;
+            case ';': kind = CppTokenKind::Semicolon; break;
+            default: break;
+            }
+            pos += (c == QLatin1Char(':') && next == QLatin1Char(':')) ? 2 : 1;
+        }
+
+        tokens.append(CppToken{ kind, start, pos - start });
+        if (kind != CppTokenKind::LineComment && kind != CppTokenKind::BlockComment)
+        {
+            lineStart = false;
+        }
+    }
+    return tokens;
+}
+
+/******************************************************************************
+ * @brief Rebuilds the text without comments. A line comment is dropped, a
+ *        block comment becomes its newlines, or one space if it has none.
+ * @param code Source text that was tokenized.
+ * @param tokens Tokens of code.
+ * @param kept If set, receives the non-comment tokens with offsets into
+ *        the returned text.
+ * @return Text without comments.
+ ******************************************************************************/
+QString CppLexer::stripComments(QStringView code, const QVector<CppToken> &tokens,
+                                QVector<CppToken> *kept)
+{
+    QString out;
+    out.reserve(code.size());
+    if (kept)
+    {
+        kept->clear();
+        kept->reserve(tokens.size());
+    }
+    int copied = 0;
+    for (int i = 0; i < tokens.size(); ++i)
+    {
+        const CppToken &token = tokens.at(i);
+        if (!token.isComment())
+        {
+            if (kept)
+            {
+                // Text up to this token is copied verbatim, so only the offset shifts
+                kept->append(CppToken{ token.kind, int(out.size()) + token.start - copied, token.length });
+            }
+            continue;
+        }
+        out.append(code.mid(copied, token.start - copied));
+        if (token.kind == CppTokenKind::BlockComment)
+        {
+            const int newlines = int(code.mid(token.start, token.length).count(QLatin1Char('\n')));
+            if (newlines > 0)
+            {
+                out.append(QString(newlines, QLatin1Char('\n')));
+            }
+            else
+            {
+                out.append(QLatin1Char(' '));
+            }
+        }
+        copied = token.end();
+    }
+    out.append(code.mid(copied));
+    return out;
+}
+
+/******************************************************************************
+ * @brief Returns the end of a quoted literal starting at pos. Escapes are
+ *        skipped; an unterminated literal ends at the end of its line.
+ ******************************************************************************/
+int CppLexer::skipQuoted(QStringView code, int pos, QChar quote)
+{
+    const int n = int(code.size());
+    ++pos;
+    while (pos < n)
+    {
+        const QChar c = code.at(pos);
+        if (c == QLatin1Char('\\'))
+        {
+            pos += 2;
+        }
+        else if (c == quote)
+        {
+            return pos + 1;
+        }
+        else if (c == QLatin1Char('\n'))
+        {
+            return pos;
+        }
+        else
+        {
+            ++pos;
+        }
+    }
+    return n;
+}
+
+/******************************************************************************
+ * @brief Returns the end of a raw string whose '"' is at pos. A malformed
+ *        delimiter is lexed as an ordinary string.
+ ******************************************************************************/
+int CppLexer::skipRawString(QStringView code, int pos)
+{
+    const int n = int(code.size());
+    int open = pos + 1;
+    while (open < n && open - pos <= 17 && code.at(open) != QLatin1Char('('))
+    {
+        const QChar c = code.at(open);
+        if (c.isSpace() || c == QLatin1Char('\\') || c == QLatin1Char(')') || c == QLatin1Char('"'))
+        {
+            break;
+        }
+        ++open;
+    }
+    if (open >= n || code.at(open) != QLatin1Char('('))
+    {
+        return skipQuoted(code, pos, QLatin1Char('"'));
+    }
+    const QString terminator = QLatin1Char(')') + code.mid(pos + 1, open - pos - 1).toString()
+                               + QLatin1Char('"');
+    const qsizetype close = code.indexOf(terminator, open + 1);
+    return (close < 0) ? n : int(close + terminator.size());
+}
+
+/******************************************************************************
+ * @brief Returns the end of a preprocessor line starting at pos. Backslash
+ *        continuations are followed; a trailing comment is left for the
+ *        lexer so stripComments still removes it.
+ ******************************************************************************/
+int CppLexer::skipDirective(QStringView code, int pos)
+{
+    const int n = int(code.size());
+    const int start = pos;
+    while (pos < n)
+    {
+        const QChar c = code.at(pos);
+        const QChar next = (pos + 1 < n) ? code.at(pos + 1) : QChar();
+        if (c == QLatin1Char('\n'))
+        {
+            break;
+        }
+        if (c == QLatin1Char('\\') && (next == QLatin1Char('\n') || next == QLatin1Char('\r')))
+        {
+            pos += (next == QLatin1Char('\r') && pos + 2 < n && code.at(pos + 2) == QLatin1Char('\n')) ? 3 : 2;
+        }
+        else if (c == QLatin1Char('"'))
+        {
+            pos = skipQuoted(code, pos, c);
+        }
+        else if (c == QLatin1Char('/') && (next == QLatin1Char('/') || next == QLatin1Char('*')))
+        {
+            break;
+        }
+        else
+        {
+            ++pos;
+        }
+    }
+    while (pos > start + 1 && code.at(pos - 1).isSpace())
+    {
+        --pos;
+    }
+    return pos;
+}
+
+/*************** End of CppLexer.cpp *****************************************/
@@ -0,0 +1,115 @@
+/******************************************************************************
+ * @file CppLexer.h
+ * @brief Declares the single-pass C/C++ lexer used by CompareEngine.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.2
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Splits source text into token spans in one linear pass: comments,
+ * string/raw-string/char literals, preprocessor lines, identifiers,
+ * numbers, braces and punctuation. Whitespace is not a token; the gaps
+ * between spans are whitespace. Tokens only hold offsets, so function
+ * extraction, normalization and diffing can share one token vector.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QStringView>
+#include <QVector>
+
+/******************************************************************************
+ * @enum CppTokenKind
+ * @brief Kind of a lexed span.
+ ******************************************************************************/
+enum class CppTokenKind : quint8
+{
+    Identifier,   /**< Names and keywords */
+    Number,       /**< Numeric literal, including digit separators */
+    String,       /**< "..." with optional u8/u/U/L prefix */
+    RawString,    /**< R"delim(...)delim" with optional prefix */
+    Char,         /**< '...' with optional prefix */
+    LineComment,  /**< // up to, not including, the newline */
+    BlockComment, /**< Slash-star comment, possibly multi-line */
+    Preprocessor, /**< # directive up to the end of line, with continuations */
+    OpenBrace,    /**< { */
+    CloseBrace,   /**< } */
+    OpenParen,    /**< ( */
+    CloseParen,   /**< ) */
+    Semicolon,    /**< ; */
+    Punct         /**< Any other character; "::" is one token */
+};
+
+/******************************************************************************
+ * @struct CppToken
+ * @brief One lexed span of the source text.
+ ******************************************************************************/
+struct CppToken
+{
+    CppTokenKind kind; /**< Token kind */
+    int start;         /**< Offset of the first character */
+    int length;        /**< Number of characters */
+
+    /**************************************************************************
+     * @brief Returns the offset just past the token.
+     *************************************************************************/
+    int end() const { return start + length; }
+
+    /**************************************************************************
+     * @brief Returns true for line and block comments.
+     *************************************************************************/
+    bool isComment() const
+    {
+        return kind == CppTokenKind::LineComment || kind == CppTokenKind::BlockComment;
+    }
+};
+
+/******************************************************************************
+ * @class CppLexer
+ * @brief Stateless single-pass C/C++ tokenizer.
+ ******************************************************************************/
+class CppLexer
+{
+public:
+    /**************************************************************************
+     * @brief Tokenizes source text. Unterminated literals and comments
+     *        run to the end of the text.
+     * @param code Source text.
+     * @return Token spans in source order.
+     *************************************************************************/
+    static QVector<CppToken> tokenize(QStringView code);
+
+    /**************************************************************************
+     * @brief Rebuilds the text without comments. A line comment is
+     *        dropped, a block comment becomes its newlines, or one space
+     *        if it has none, so line numbers and token gaps survive.
+     * @param code Source text that was tokenized.
+     * @param tokens Tokens of code.
+     * @param kept If set, receives the non-comment tokens with offsets
+     *        into the returned text.
+     * @return Text without comments.
+     *************************************************************************/
+    static QString stripComments(QStringView code, const QVector<CppToken> &tokens,
+                                 QVector<CppToken> *kept = nullptr);
+
+    /**************************************************************************
+     * @brief Returns the end of a quoted literal starting at pos. Also
+     *        used by Normalizer to copy literals verbatim.
+     *************************************************************************/
+    static int skipQuoted(QStringView code, int pos, QChar quote);
+
+    /**************************************************************************
+     * @brief Returns the end of a raw string whose '"' is at pos.
+     *************************************************************************/
+    static int skipRawString(QStringView code, int pos);
+
+private:
+    /**************************************************************************
+     * @brief Returns the end of a preprocessor line starting at pos.
+     *************************************************************************/
+    static int skipDirective(QStringView code, int pos);
+};
+
+/*************** End of CppLexer.h *******************************************/
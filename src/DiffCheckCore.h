@@ -0,0 +1,38 @@
+/******************************************************************************
+ * @file DiffCheckCore.h
+ * @brief Public API of the diffcheck_core library.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.2
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Include this one header and link diffcheck_core (Qt6::Core only) to
+ * use the function-aware compare outside the GUI:
+ *
+ *     CompareEngine engine;
+ *     const auto orig = engine.extractFunctions(origText);
+ *     const auto news = engine.extractFunctions(newText);
+ *     const QVector<EditOp> ops = engine.diffLines(orig.value("f").bodyLines(),
+ *                                                  news.value("f").bodyLines());
+ *
+ * CompareEngine is the entry point; CppLexer, Normalizer, LineInterner,
+ * DiffKernels and InlineDiff are the building blocks it uses, exposed
+ * for tools that need a single step. Profiler times the phases when
+ * enabled.
+ ******************************************************************************/
+
+#pragma once
+
+#include "CompareEngine.h"
+#include "CppLexer.h"
+#include "DiffKernels.h"
+#include "InlineDiff.h"
+#include "LineInterner.h"
+#include "Normalizer.h"
+#include "Profiler.h"
+
+#define DIFFCHECK_CORE_VERSION_MAJOR 0 ///< Bumped on incompatible API changes
+#define DIFFCHECK_CORE_VERSION_MINOR 2 ///< Bumped on additions
+
+/*************** End of DiffCheckCore.h **************************************/
@@ -0,0 +1,86 @@
+/******************************************************************************
+ * @file DiffDelegate.cpp
+ * @brief Implements the DiffDelegate class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * The row background, selection and focus come from the style as usual;
+ * the text is drawn with a QTextLayout whose format ranges carry the
+ * span backgrounds, so tabs and spans line up with what is shown.
+ ******************************************************************************/
+
+#include "DiffDelegate.h"
+#include "DiffModel.h"
+#include "DiffRenderer.h"
+#include <QApplication>
+#include <QPainter>
+#include <QTextLayout>
+
+/******************************************************************************
+ * @brief Constructor.
+ * @param parent Parent object.
+ ******************************************************************************/
+DiffDelegate::DiffDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+/******************************************************************************
+ * @brief Paints one row, highlighting its changed spans.
+ * @param painter Painter of the view.
+ * @param option Style options of the row.
+ * @param index Row to paint.
+ ******************************************************************************/
+void DiffDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const
+{
+    const QVector<InlineSpan> spans = index.data(DiffModel::SpansRole).value<QVector<InlineSpan>>();
+    if (spans.isEmpty())
+    {
+        QStyledItemDelegate::paint(painter, option, index);
+        return;
+    }
+
+    QStyleOptionViewItem opt(option);
+    initStyleOption(&opt, index);
+    const QString text = opt.text;
+    opt.text.clear();
+    const QWidget *widget = opt.widget;
+    QStyle *style = widget ? widget->style() : QApplication::style();
+    style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, widget);
+
+    const int margin = style->pixelMetric(QStyle::PM_FocusFrameHMargin, nullptr, widget) + 1;
+    const QRect textRect = style->subElementRect(QStyle::SE_ItemViewItemText, &opt, widget).adjusted(margin, 0, -margin, 0);
+
+    QTextCharFormat changed;
+    changed.setBackground(DiffRenderer::highlight(index.data(DiffModel::MarkerRole).toString().at(0)));
+    QList<QTextLayout::FormatRange> ranges;
+    for (int i = 0; i < spans.size(); ++i)
+    {
+        QTextLayout::FormatRange range;
+        range.start = spans.at(i).start;
+        range.length = spans.at(i).length;
+        range.format = changed;
+        ranges.append(range);
+    }
+    QTextOption textOption;
+    textOption.setWrapMode(QTextOption::NoWrap);
+    QTextLayout layout(text, opt.font);
+    layout.setTextOption(textOption);
+    layout.setFormats(ranges);
+    layout.beginLayout();
+    QTextLine line = layout.createLine();
+    line.setLineWidth(textRect.width());
+    layout.endLayout();
+
+    painter->save();
+    painter->setClipRect(textRect);
+    const bool selected = opt.state & QStyle::State_Selected;
+    painter->setPen(selected ? opt.palette.color(QPalette::HighlightedText) : opt.palette.color(QPalette::Text));
+    layout.draw(painter, QPointF(textRect.left(), textRect.top() + (textRect.height() - line.height()) / 2.0));
+    painter->restore();
+}
+
+/*************** End of DiffDelegate.cpp *************************************/
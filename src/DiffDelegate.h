@@ -0,0 +1,41 @@
+/******************************************************************************
+ * @file DiffDelegate.h
+ * @brief Declares the DiffDelegate that paints intra-line changes.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Paints DiffView rows. Rows with DiffModel::SpansRole data get the
+ * changed spans highlighted behind the text; every other row is left to
+ * QStyledItemDelegate. Spans are asked for only when a row is painted,
+ * so only visible rows are refined.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QStyledItemDelegate>
+
+/******************************************************************************
+ * @class DiffDelegate
+ * @brief Item delegate highlighting changed spans inside diff rows.
+ ******************************************************************************/
+class DiffDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    /**************************************************************************
+     * @brief Constructor.
+     * @param parent Parent object.
+     *************************************************************************/
+    explicit DiffDelegate(QObject *parent = nullptr);
+
+    /**************************************************************************
+     * @brief Paints one row, highlighting its changed spans.
+     *************************************************************************/
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+/*************** End of DiffDelegate.h ***************************************/
@@ -0,0 +1,780 @@
+/******************************************************************************
+ * @file DiffKernels.cpp
+ * @brief Implements the line diff kernels used by CompareEngine.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.7
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Myers O((N+M)D) diff with the linear-space middle snake, patience
+ * and histogram diffs that anchor on rare lines, a bit-parallel LCS
+ * for dense edits, plus the original O(N*M) LCS table as a reference
+ * implementation. The Myers search, and through it the anchored
+ * diffs, can be cut short by a Budget.
+ ******************************************************************************/
+
+#include "DiffKernels.h"
+#include <algorithm>
+
+/******************************************************************************
+ * @brief Appends count copies of op to the script.
+ ******************************************************************************/
+static void appendRun(QByteArray &script, char op, int count)
+{
+    if (count > 0)
+    {
+        script.append(count, op);
+    }
+}
+
+/******************************************************************************
+ * @brief Rewrites the deletions and insertions from start on as their
+ *        approximate ops, marking the range as cut short by the budget.
+ ******************************************************************************/
+static void markApproximate(QByteArray &script, int start)
+{
+    char *ops = script.data();
+    for (int pos = start; pos < script.size(); ++pos)
+    {
+        if (ops[pos] == DiffKernels::OpDelete)
+        {
+            ops[pos] = DiffKernels::OpDeleteApprox;
+        }
+        else if (ops[pos] == DiffKernels::OpInsert)
+        {
+            ops[pos] = DiffKernels::OpInsertApprox;
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief Returns true if the budget's deadline has passed.
+ ******************************************************************************/
+bool DiffKernels::outOfTime(const Budget *budget)
+{
+    return budget != nullptr && budget->deadline.hasExpired();
+}
+
+/******************************************************************************
+ * @brief Emits the common prefix of a range and trims the range.
+ ******************************************************************************/
+void DiffKernels::trimPrefix(const quint32 *&a, int &n, const quint32 *&b, int &m,
+                             QByteArray &script)
+{
+    int prefix = 0;
+    while (prefix < n && prefix < m && a[prefix] == b[prefix])
+    {
+        ++prefix;
+    }
+    appendRun(script, OpEqual, prefix);
+    a += prefix;
+    b += prefix;
+    n -= prefix;
+    m -= prefix;
+}
+
+/******************************************************************************
+ * @brief Trims the common suffix of a range.
+ * @return Number of trimmed lines, to be emitted after the range.
+ ******************************************************************************/
+int DiffKernels::trimSuffix(const quint32 *a, int &n, const quint32 *b, int &m)
+{
+    int suffix = 0;
+    while (suffix < n && suffix < m && a[n - 1 - suffix] == b[m - 1 - suffix])
+    {
+        ++suffix;
+    }
+    n -= suffix;
+    m -= suffix;
+    return suffix;
+}
+
+/******************************************************************************
+ * @brief Myers O((N+M)D) diff using the linear-space middle snake.
+ * @param a Interned original line IDs.
+ * @param b Interned new line IDs.
+ * @param script Receives the edit script.
+ * @param budget Optional limits; nullptr searches until done.
+ ******************************************************************************/
+void DiffKernels::myers(const QVector<quint32> &a, const QVector<quint32> &b, QByteArray &script,
+                        const Budget *budget)
+{
+    script.reserve(script.size() + a.size() + b.size());
+    QVector<int> v1;
+    QVector<int> v2;
+    myersRange(a.constData(), int(a.size()), b.constData(), int(b.size()), v1, v2, script, budget);
+}
+
+/******************************************************************************
+ * @brief Diffs a[0..n) against b[0..m). Common prefix and suffix are
+ *        emitted directly; the rest is split at the middle snake and
+ *        both halves are diffed recursively. Past the budget's deadline
+ *        the rest is emitted as one approximate block instead, and a
+ *        split the budget cut short marks both halves approximate.
+ ******************************************************************************/
+void DiffKernels::myersRange(const quint32 *a, int n, const quint32 *b, int m,
+                             QVector<int> &v1, QVector<int> &v2, QByteArray &script,
+                             const Budget *budget)
+{
+    trimPrefix(a, n, b, m, script);
+    const int suffix = trimSuffix(a, n, b, m);
+
+    int splitX = 0;
+    int splitY = 0;
+    bool approximate = false;
+    if (n == 0 || m == 0)
+    {
+        appendRun(script, OpDelete, n);
+        appendRun(script, OpInsert, m);
+    }
+    else if (outOfTime(budget))
+    {
+        appendRun(script, OpDeleteApprox, n);
+        appendRun(script, OpInsertApprox, m);
+    }
+    else if (myersBisect(a, n, b, m, v1, v2, splitX, splitY, budget, approximate))
+    {
+        const int start = int(script.size());
+        myersRange(a, splitX, b, splitY, v1, v2, script, budget);
+        myersRange(a + splitX, n - splitX, b + splitY, m - splitY, v1, v2, script, budget);
+        if (approximate)
+        {
+            markApproximate(script, start);
+        }
+    }
+    else
+    {
+        appendRun(script, approximate ? OpDeleteApprox : OpDelete, n);
+        appendRun(script, approximate ? OpInsertApprox : OpInsert, m);
+    }
+    appendRun(script, OpEqual, suffix);
+}
+
+/******************************************************************************
+ * @brief Finds the middle snake of an optimal edit path by running the
+ *        forward and reverse searches until they overlap. Uses O(N+M)
+ *        space; v1/v2 are reused across the whole recursion. When the
+ *        budget runs out first, the furthest point any forward path
+ *        reached becomes the split, as in xdiff's heuristic.
+ * @param approximate Set if the split came from the budget heuristic.
+ * @return false if the ranges share no line at all, or the budget ran
+ *         out before any usable split.
+ ******************************************************************************/
+bool DiffKernels::myersBisect(const quint32 *a, int n, const quint32 *b, int m,
+                              QVector<int> &v1, QVector<int> &v2,
+                              int &splitX, int &splitY,
+                              const Budget *budget, bool &approximate)
+{
+    const int maxD = (n + m + 1) / 2;
+    const int vOffset = maxD;
+    const int vLength = 2 * maxD + 2;
+    if (v1.size() < vLength)
+    {
+        v1.resize(vLength);
+        v2.resize(vLength);
+    }
+    int *f = v1.data();
+    int *r = v2.data();
+    std::fill(f, f + vLength, -1);
+    std::fill(r, r + vLength, -1);
+    f[vOffset + 1] = 0;
+    r[vOffset + 1] = 0;
+
+    const int delta = n - m;
+    // With an odd delta the forward path detects the overlap, else the reverse.
+    const bool front = (delta % 2 != 0);
+    int k1start = 0;
+    int k1end = 0;
+    int k2start = 0;
+    int k2end = 0;
+    for (int d = 0; d < maxD; ++d)
+    {
+        // Out of budget: split where the forward search got furthest
+        if (budget != nullptr && d > 0
+            && ((budget->maxCost > 0 && d >= budget->maxCost) || ((d & 15) == 0 && outOfTime(budget))))
+        {
+            approximate = true;
+            int best = 0;
+            for (int k = -(d - 1); k <= d - 1; k += 2)
+            {
+                const int x = f[vOffset + k];
+                const int y = x - k;
+                if (x >= 0 && x <= n && y >= 0 && y <= m && x + y > best && x + y < n + m)
+                {
+                    best = x + y;
+                    splitX = x;
+                    splitY = y;
+                }
+            }
+            return best > 0;
+        }
+
+        // Forward path
+        for (int k1 = -d + k1start; k1 <= d - k1end; k1 += 2)
+        {
+            const int k1Offset = vOffset + k1;
+            int x1;
+            if (k1 == -d || (k1 != d && f[k1Offset - 1] < f[k1Offset + 1]))
+            {
+                x1 = f[k1Offset + 1];
+            }
+            else
+            {
+                x1 = f[k1Offset - 1] + 1;
+            }
+            int y1 = x1 - k1;
+            while (x1 < n && y1 < m && a[x1] == b[y1])
+            {
+                ++x1;
+                ++y1;
+            }
+            f[k1Offset] = x1;
+            if (x1 > n)
+            {
+                k1end += 2; // Ran off the right of the graph
+            }
+            else if (y1 > m)
+            {
+                k1start += 2; // Ran off the bottom of the graph
+            }
+            else if (front)
+            {
+                const int k2Offset = vOffset + delta - k1;
+                if (k2Offset >= 0 && k2Offset < vLength && r[k2Offset] != -1)
+                {
+                    if (x1 >= n - r[k2Offset])
+                    {
+                        splitX = x1;
+                        splitY = y1;
+                        return true;
+                    }
+                }
+            }
+        }
+
+        // Reverse path
+        for (int k2 = -d + k2start; k2 <= d - k2end; k2 += 2)
+        {
+            const int k2Offset = vOffset + k2;
+            int x2;
+            if (k2 == -d || (k2 != d && r[k2Offset - 1] < r[k2Offset + 1]))
+            {
+                x2 = r[k2Offset + 1];
+            }
+            else
+            {
+                x2 = r[k2Offset - 1] + 1;
+            }
+            int y2 = x2 - k2;
+            while (x2 < n && y2 < m && a[n - x2 - 1] == b[m - y2 - 1])
+            {
+                ++x2;
+                ++y2;
+            }
+            r[k2Offset] = x2;
+            if (x2 > n)
+            {
+                k2end += 2;
+            }
+            else if (y2 > m)
+            {
+                k2start += 2;
+            }
+            else if (!front)
+            {
+                const int k1Offset = vOffset + delta - k2;
+                if (k1Offset >= 0 && k1Offset < vLength && f[k1Offset] != -1)
+                {
+                    const int x1 = f[k1Offset];
+                    const int y1 = vOffset + x1 - k1Offset;
+                    if (x1 >= n - x2)
+                    {
+                        splitX = x1;
+                        splitY = y1;
+                        return true;
+                    }
+                }
+            }
+        }
+    }
+    return false;
+}
+
+/******************************************************************************
+ * @brief Reference O(N*M) LCS table diff, kept for tests. Too large a
+ *        table falls back to Myers, flagged approximate.
+ * @param a Interned original line IDs.
+ * @param b Interned new line IDs.
+ * @param script Receives the edit script.
+ * @param budget Optional limits; only the deadline is checked.
+ ******************************************************************************/
+void DiffKernels::lcs(const QVector<quint32> &a, const QVector<quint32> &b, QByteArray &script,
+                      const Budget *budget)
+{
+    const int n = int(a.size());
+    const int m = int(b.size());
+    if (qint64(n + 1) * (m + 1) > LcsMaxCells)
+    {
+        const int start = int(script.size());
+        myers(a, b, script, budget);
+        markApproximate(script, start);
+        return;
+    }
+    QVector<QVector<int>> dp(n + 1, QVector<int>(m + 1, 0));
+    for (int i = n - 1; i >= 0; --i)
+    {
+        if (outOfTime(budget))
+        {
+            appendRun(script, OpDeleteApprox, n);
+            appendRun(script, OpInsertApprox, m);
+            return;
+        }
+        for (int j = m - 1; j >= 0; --j)
+        {
+            if (a[i] == b[j])
+            {
+                dp[i][j] = 1 + dp[i + 1][j + 1];
+            }
+            else
+            {
+                dp[i][j] = qMax(dp[i + 1][j], dp[i][j + 1]);
+            }
+        }
+    }
+    script.reserve(script.size() + n + m);
+    int i = 0;
+    int j = 0;
+    while (i < n && j < m)
+    {
+        if (a[i] == b[j])
+        {
+            script.append(OpEqual);
+            i++;
+            j++;
+        }
+        else if (dp[i + 1][j] >= dp[i][j + 1])
+        {
+            script.append(OpDelete);
+            i++;
+        }
+        else
+        {
+            script.append(OpInsert);
+            j++;
+        }
+    }
+    appendRun(script, OpDelete, n - i);
+    appendRun(script, OpInsert, m - j);
+}
+
+/******************************************************************************
+ * @brief Patience diff: anchors on lines unique to both sides, then diffs
+ *        the gaps; gaps without unique lines fall back to Myers.
+ * @param a Interned original line IDs.
+ * @param b Interned new line IDs.
+ * @param script Receives the edit script.
+ * @param budget Optional limits; nullptr searches until done.
+ ******************************************************************************/
+void DiffKernels::patience(const QVector<quint32> &a, const QVector<quint32> &b, QByteArray &script,
+                           const Budget *budget)
+{
+    script.reserve(script.size() + a.size() + b.size());
+    QVector<int> v1;
+    QVector<int> v2;
+    patienceRange(a.constData(), int(a.size()), b.constData(), int(b.size()), 0, v1, v2, script, budget);
+}
+
+/******************************************************************************
+ * @brief Patience diff of a[0..n) against b[0..m). Lines that occur once
+ *        in each side are paired, the longest increasing run of pairs
+ *        becomes the anchors, and every gap between anchors is diffed
+ *        recursively.
+ ******************************************************************************/
+void DiffKernels::patienceRange(const quint32 *a, int n, const quint32 *b, int m, int depth,
+                                QVector<int> &v1, QVector<int> &v2, QByteArray &script,
+                                const Budget *budget)
+{
+    trimPrefix(a, n, b, m, script);
+    const int suffix = trimSuffix(a, n, b, m);
+    if (n == 0 || m == 0)
+    {
+        appendRun(script, OpDelete, n);
+        appendRun(script, OpInsert, m);
+        appendRun(script, OpEqual, suffix);
+        return;
+    }
+    if (depth > MaxAnchorDepth || outOfTime(budget))
+    {
+        myersRange(a, n, b, m, v1, v2, script, budget);
+        appendRun(script, OpEqual, suffix);
+        return;
+    }
+
+    // Count occurrences; posA/posB remember the last position seen
+    struct Occurrence
+    {
+        int countA = 0;
+        int countB = 0;
+        int posA = -1;
+        int posB = -1;
+    };
+    QHash<quint32, Occurrence> table;
+    table.reserve(n);
+    for (int i = 0; i < n; ++i)
+    {
+        Occurrence &o = table[a[i]];
+        o.countA++;
+        o.posA = i;
+    }
+    for (int j = 0; j < m; ++j)
+    {
+        auto it = table.find(b[j]);
+        if (it != table.end())
+        {
+            it->countB++;
+            it->posB = j;
+        }
+    }
+
+    // Unique pairs in new-side order
+    QVector<int> pairA;
+    QVector<int> pairB;
+    for (int j = 0; j < m; ++j)
+    {
+        auto it = table.constFind(b[j]);
+        if (it != table.constEnd() && it->countA == 1 && it->countB == 1)
+        {
+            pairA.append(it->posA);
+            pairB.append(j);
+        }
+    }
+    if (pairA.isEmpty())
+    {
+        myersRange(a, n, b, m, v1, v2, script, budget);
+        appendRun(script, OpEqual, suffix);
+        return;
+    }
+
+    // Longest increasing subsequence of pairA by patience sorting
+    QVector<int> pileTops;            // index into pairs of each pile top
+    QVector<int> previous(pairA.size(), -1);
+    for (int p = 0; p < pairA.size(); ++p)
+    {
+        int lo = 0;
+        int hi = int(pileTops.size());
+        while (lo < hi)
+        {
+            const int mid = (lo + hi) / 2;
+            if (pairA.at(pileTops.at(mid)) < pairA.at(p))
+            {
+                lo = mid + 1;
+            }
+            else
+            {
+                hi = mid;
+            }
+        }
+        if (lo > 0)
+        {
+            previous[p] = pileTops.at(lo - 1);
+        }
+        if (lo == pileTops.size())
+        {
+            pileTops.append(p);
+        }
+        else
+        {
+            pileTops[lo] = p;
+        }
+    }
+    QVector<int> anchors(pileTops.size());
+    for (int p = pileTops.last(), k = int(anchors.size()) - 1; p >= 0; p = previous.at(p), --k)
+    {
+        anchors[k] = p;
+    }
+
+    int lastA = 0;
+    int lastB = 0;
+    for (int k = 0; k < anchors.size(); ++k)
+    {
+        const int ai = pairA.at(anchors.at(k));
+        const int bj = pairB.at(anchors.at(k));
+        patienceRange(a + lastA, ai - lastA, b + lastB, bj - lastB, depth + 1, v1, v2, script, budget);
+        script.append(OpEqual);
+        lastA = ai + 1;
+        lastB = bj + 1;
+    }
+    patienceRange(a + lastA, n - lastA, b + lastB, m - lastB, depth + 1, v1, v2, script, budget);
+    appendRun(script, OpEqual, suffix);
+}
+
+/******************************************************************************
+ * @brief Histogram diff: anchors on the longest match around the least
+ *        frequent common line, then recurses on both sides.
+ * @param a Interned original line IDs.
+ * @param b Interned new line IDs.
+ * @param script Receives the edit script.
+ * @param budget Optional limits; nullptr searches until done.
+ ******************************************************************************/
+void DiffKernels::histogram(const QVector<quint32> &a, const QVector<quint32> &b, QByteArray &script,
+                            const Budget *budget)
+{
+    script.reserve(script.size() + a.size() + b.size());
+    QVector<int> v1;
+    QVector<int> v2;
+    histogramRange(a.constData(), int(a.size()), b.constData(), int(b.size()), 0, v1, v2, script, budget);
+}
+
+/******************************************************************************
+ * @brief Histogram diff of a[0..n) against b[0..m), as in git: every new
+ *        line that also occurs in the original is tried as an anchor, the
+ *        match is extended both ways, and the region whose line is rarest
+ *        in the original (then longest) wins. Lines occurring more than
+ *        HistogramMaxChain times are never anchors.
+ ******************************************************************************/
+void DiffKernels::histogramRange(const quint32 *a, int n, const quint32 *b, int m, int depth,
+                                 QVector<int> &v1, QVector<int> &v2, QByteArray &script,
+                                 const Budget *budget)
+{
+    trimPrefix(a, n, b, m, script);
+    const int suffix = trimSuffix(a, n, b, m);
+    if (n == 0 || m == 0)
+    {
+        appendRun(script, OpDelete, n);
+        appendRun(script, OpInsert, m);
+        appendRun(script, OpEqual, suffix);
+        return;
+    }
+    if (depth > MaxAnchorDepth || outOfTime(budget))
+    {
+        myersRange(a, n, b, m, v1, v2, script, budget);
+        appendRun(script, OpEqual, suffix);
+        return;
+    }
+
+    QHash<quint32, QVector<int>> positions;
+    positions.reserve(n);
+    for (int i = 0; i < n; ++i)
+    {
+        positions[a[i]].append(i);
+    }
+
+    int bestA = -1;
+    int bestB = -1;
+    int bestLen = 0;
+    int bestCount = HistogramMaxChain; // Ties are taken, so a chain of exactly the cap still anchors
+    int j = 0;
+    while (j < m)
+    {
+        auto it = positions.constFind(b[j]);
+        if (it == positions.constEnd() || it->size() > bestCount)
+        {
+            ++j;
+            continue;
+        }
+        const int count = int(it->size());
+        int nextJ = j + 1;
+        for (int p = 0; p < it->size(); ++p)
+        {
+            int s = it->at(p);
+            int t = j;
+            while (s > 0 && t > 0 && a[s - 1] == b[t - 1])
+            {
+                --s;
+                --t;
+            }
+            int e = it->at(p) + 1;
+            int f = j + 1;
+            while (e < n && f < m && a[e] == b[f])
+            {
+                ++e;
+                ++f;
+            }
+            const int len = e - s;
+            if (count < bestCount || (count == bestCount && len > bestLen))
+            {
+                bestA = s;
+                bestB = t;
+                bestLen = len;
+                bestCount = count;
+            }
+            nextJ = qMax(nextJ, f);
+        }
+        j = nextJ;
+    }
+
+    if (bestLen == 0)
+    {
+        myersRange(a, n, b, m, v1, v2, script, budget);
+    }
+    else
+    {
+        histogramRange(a, bestA, b, bestB, depth + 1, v1, v2, script, budget);
+        appendRun(script, OpEqual, bestLen);
+        histogramRange(a + bestA + bestLen, n - bestA - bestLen,
+                       b + bestB + bestLen, m - bestB - bestLen, depth + 1, v1, v2, script, budget);
+    }
+    appendRun(script, OpEqual, suffix);
+}
+
+/******************************************************************************
+ * @brief Bit-parallel LCS (Allison-Dix, Hyyro). Bit i of row j is 0 when
+ *        LCS(a[0..i], b[0..j)) is one longer than LCS(a[0..i), b[0..j)).
+ *        Each row is V' = (V + (V & M)) | (V & ~M), where M marks the
+ *        original lines equal to b[j-1], with the carry rippling across
+ *        64-bit words. The traceback then needs one bit per step: a
+ *        match is always taken diagonally, a 1 bit means the original
+ *        line can be dropped, and a 0 bit means the new line was added.
+ * @param a Interned original line IDs.
+ * @param b Interned new line IDs.
+ * @param script Receives the edit script.
+ * @param budget Optional limits; only the deadline is checked.
+ ******************************************************************************/
+void DiffKernels::bitParallel(const QVector<quint32> &a, const QVector<quint32> &b, QByteArray &script,
+                              const Budget *budget)
+{
+    script.reserve(script.size() + a.size() + b.size());
+    const quint32 *pa = a.constData();
+    const quint32 *pb = b.constData();
+    int n = int(a.size());
+    int m = int(b.size());
+    trimPrefix(pa, n, pb, m, script);
+    const int suffix = trimSuffix(pa, n, pb, m);
+    if (n == 0 || m == 0)
+    {
+        appendRun(script, OpDelete, n);
+        appendRun(script, OpInsert, m);
+        appendRun(script, OpEqual, suffix);
+        return;
+    }
+
+    // One match mask per distinct original line
+    const int words = (n + 63) / 64;
+    if (qint64(m) * words > BitParallelMaxWords)
+    {
+        const int start = int(script.size());
+        QVector<int> v1;
+        QVector<int> v2;
+        myersRange(pa, n, pb, m, v1, v2, script, budget);
+        markApproximate(script, start);
+        appendRun(script, OpEqual, suffix);
+        return;
+    }
+    QHash<quint32, int> maskIndex;
+    maskIndex.reserve(n);
+    QVector<quint64> masks;
+    for (int i = 0; i < n; ++i)
+    {
+        auto it = maskIndex.constFind(pa[i]);
+        int index = 0;
+        if (it == maskIndex.constEnd())
+        {
+            index = int(maskIndex.size());
+            maskIndex.insert(pa[i], index);
+            masks.resize(masks.size() + words);
+        }
+        else
+        {
+            index = it.value();
+        }
+        masks[qsizetype(index) * words + i / 64] |= quint64(1) << (i % 64);
+    }
+
+    QVector<quint64> rows(qsizetype(m + 1) * words);
+    std::fill(rows.begin(), rows.begin() + words, ~quint64(0));
+    for (int j = 1; j <= m; ++j)
+    {
+        if ((j & 63) == 0 && outOfTime(budget))
+        {
+            appendRun(script, OpDeleteApprox, n);
+            appendRun(script, OpInsertApprox, m);
+            appendRun(script, OpEqual, suffix);
+            return;
+        }
+        const quint64 *prev = rows.constData() + qsizetype(j - 1) * words;
+        quint64 *next = rows.data() + qsizetype(j) * words;
+        auto it = maskIndex.constFind(pb[j - 1]);
+        if (it == maskIndex.constEnd())
+        {
+            std::copy(prev, prev + words, next); // No match: the row is unchanged
+            continue;
+        }
+        const quint64 *mask = masks.constData() + qsizetype(it.value()) * words;
+        quint64 carry = 0;
+        for (int w = 0; w < words; ++w)
+        {
+            const quint64 v = prev[w];
+            const quint64 u = v & mask[w];
+            const quint64 sum = v + u + carry;
+            carry = (sum < v || (carry != 0 && sum == v)) ? 1 : 0;
+            next[w] = sum | (v & ~mask[w]);
+        }
+    }
+
+    QByteArray reversed;
+    reversed.reserve(n + m);
+    int i = n;
+    int j = m;
+    while (i > 0 && j > 0)
+    {
+        if (pa[i - 1] == pb[j - 1])
+        {
+            reversed.append(OpEqual);
+            --i;
+            --j;
+        }
+        else if ((rows.at(qsizetype(j) * words + (i - 1) / 64) >> ((i - 1) % 64)) & 1)
+        {
+            reversed.append(OpDelete);
+            --i;
+        }
+        else
+        {
+            reversed.append(OpInsert);
+            --j;
+        }
+    }
+    appendRun(script, OpDelete, i);
+    appendRun(script, OpInsert, j);
+    for (int k = int(reversed.size()) - 1; k >= 0; --k)
+    {
+        script.append(reversed.at(k));
+    }
+    appendRun(script, OpEqual, suffix);
+}
+
+/******************************************************************************
+ * @brief Cheap lower bound on the edit distance: lines that cannot be
+ *        matched because one side has fewer copies of them.
+ * @param a Interned original line IDs.
+ * @param b Interned new line IDs.
+ * @return n + m - 2 * (lines shared, counted with multiplicity).
+ ******************************************************************************/
+int DiffKernels::estimateEditDistance(const QVector<quint32> &a, const QVector<quint32> &b)
+{
+    // IDs are dense, so a flat count table is enough
+    quint32 maxId = 0;
+    for (int i = 0; i < a.size(); ++i)
+    {
+        maxId = qMax(maxId, a.at(i));
+    }
+    QVector<int> counts(qsizetype(maxId) + 1, 0);
+    for (int i = 0; i < a.size(); ++i)
+    {
+        ++counts[a.at(i)];
+    }
+    int shared = 0;
+    for (int j = 0; j < b.size(); ++j)
+    {
+        const quint32 id = b.at(j);
+        if (id <= maxId && counts.at(id) > 0)
+        {
+            --counts[id];
+            ++shared;
+        }
+    }
+    return int(a.size() + b.size()) - 2 * shared;
+}
+
+/*************** End of DiffKernels.cpp **************************************/
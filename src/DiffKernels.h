@@ -0,0 +1,185 @@
+/******************************************************************************
+ * @file DiffKernels.h
+ * @brief Declares the line diff kernels used by CompareEngine.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.9
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Each kernel compares two sequences of interned line IDs (see
+ * LineInterner) and appends an edit script to a QByteArray, one byte
+ * per step: '=' keeps a line, '-' deletes an original line, '+'
+ * inserts a new line. CompareEngine turns the script into diff rows.
+ * Myers, patience and histogram take an optional Budget; ranges they
+ * stop searching early are written with the approximate ops 'd' and
+ * 'i' instead, still a valid script but not a minimal one.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QDeadlineTimer>
+#include <QHash>
+#include <QtGlobal>
+#include <QVector>
+
+/******************************************************************************
+ * @class DiffKernels
+ * @brief Stateless line diff algorithms producing an edit script.
+ ******************************************************************************/
+class DiffKernels
+{
+public:
+    static constexpr char OpEqual = '=';  /**< Line kept in both sides */
+    static constexpr char OpDelete = '-'; /**< Line only in original */
+    static constexpr char OpInsert = '+'; /**< Line only in new */
+    static constexpr char OpDeleteApprox = 'd'; /**< OpDelete in a range cut short by the budget */
+    static constexpr char OpInsertApprox = 'i'; /**< OpInsert in a range cut short by the budget */
+
+    /**************************************************************************
+     * @struct Budget
+     * @brief Limits on one diff. When either runs out the kernel stops
+     *        looking for a minimal script, as git's xdiff does: a Myers
+     *        search past maxCost splits at its furthest-reaching path,
+     *        and ranges reached after the deadline become one block of
+     *        deletions and insertions.
+     *************************************************************************/
+    struct Budget
+    {
+        int maxCost = 0;                                    /**< Edit cost one Myers search may reach, 0 for no limit */
+        QDeadlineTimer deadline{ QDeadlineTimer::Forever }; /**< Wall-clock limit of the whole diff */
+    };
+
+    /**************************************************************************
+     * @brief Myers O((N+M)D) diff using the linear-space middle snake.
+     * @param a Interned original line IDs.
+     * @param b Interned new line IDs.
+     * @param script Receives the edit script.
+     * @param budget Optional limits; nullptr searches until done.
+     *************************************************************************/
+    static void myers(const QVector<quint32> &a, const QVector<quint32> &b, QByteArray &script,
+                      const Budget *budget = nullptr);
+
+    /**************************************************************************
+     * @brief Reference O(N*M) LCS table diff, kept for tests. A table over
+     *        LcsMaxCells is not built: Myers diffs the inputs instead and
+     *        its changes are flagged approximate.
+     * @param a Interned original line IDs.
+     * @param b Interned new line IDs.
+     * @param script Receives the edit script.
+     * @param budget Optional limits; past the deadline the table is
+     *        abandoned and the inputs become one approximate block.
+     *************************************************************************/
+    static void lcs(const QVector<quint32> &a, const QVector<quint32> &b, QByteArray &script,
+                    const Budget *budget = nullptr);
+
+    /**************************************************************************
+     * @brief Patience diff: anchors on lines unique to both sides, then
+     *        diffs the gaps; gaps without unique lines fall back to Myers.
+     * @param a Interned original line IDs.
+     * @param b Interned new line IDs.
+     * @param script Receives the edit script.
+     * @param budget Optional limits; nullptr searches until done.
+     *************************************************************************/
+    static void patience(const QVector<quint32> &a, const QVector<quint32> &b, QByteArray &script,
+                         const Budget *budget = nullptr);
+
+    /**************************************************************************
+     * @brief Histogram diff: anchors on the longest match around the
+     *        least frequent common line, then recurses on both sides.
+     * @param a Interned original line IDs.
+     * @param b Interned new line IDs.
+     * @param script Receives the edit script.
+     * @param budget Optional limits; nullptr searches until done.
+     *************************************************************************/
+    static void histogram(const QVector<quint32> &a, const QVector<quint32> &b, QByteArray &script,
+                          const Budget *budget = nullptr);
+
+    /**************************************************************************
+     * @brief Bit-parallel LCS (Allison-Dix, Hyyro): each row of the LCS
+     *        table is one pass over ceil(n/64) words. Rows are kept for
+     *        the traceback, so memory is 8*m*ceil(n/64) bytes after
+     *        trimming. Above BitParallelMaxWords Myers diffs the trimmed
+     *        range instead and its changes are flagged approximate.
+     * @param a Interned original line IDs.
+     * @param b Interned new line IDs.
+     * @param script Receives the edit script.
+     * @param budget Optional limits; past the deadline the rows are
+     *        abandoned and the trimmed range becomes one approximate block.
+     *************************************************************************/
+    static void bitParallel(const QVector<quint32> &a, const QVector<quint32> &b, QByteArray &script,
+                            const Budget *budget = nullptr);
+
+    /**************************************************************************
+     * @brief Cheap lower bound on the edit distance: lines that cannot be
+     *        matched because one side has fewer copies of them.
+     * @param a Interned original line IDs.
+     * @param b Interned new line IDs.
+     * @return n + m - 2 * (lines shared, counted with multiplicity).
+     *************************************************************************/
+    static int estimateEditDistance(const QVector<quint32> &a, const QVector<quint32> &b);
+
+    static constexpr qint64 BitParallelMaxWords = 256 * 1024; /**< Traceback rows of at most 2 MB */
+    static constexpr qint64 LcsMaxCells = 4 * 1024 * 1024;    /**< LCS table of at most 16 MB */
+    static constexpr int HistogramMaxChain = 64;  /**< Lines seen more often are not anchors */
+
+private:
+    static constexpr int MaxAnchorDepth = 512;    /**< Deeper anchored ranges fall back to Myers */
+
+    /**************************************************************************
+     * @brief Emits the common prefix of a range and trims the range.
+     *************************************************************************/
+    static void trimPrefix(const quint32 *&a, int &n, const quint32 *&b, int &m,
+                           QByteArray &script);
+
+    /**************************************************************************
+     * @brief Trims the common suffix of a range.
+     * @return Number of trimmed lines, to be emitted after the range.
+     *************************************************************************/
+    static int trimSuffix(const quint32 *a, int &n, const quint32 *b, int &m);
+
+    /**************************************************************************
+     * @brief Patience diff of a[0..n) against b[0..m).
+     *************************************************************************/
+    static void patienceRange(const quint32 *a, int n, const quint32 *b, int m, int depth,
+                              QVector<int> &v1, QVector<int> &v2, QByteArray &script,
+                              const Budget *budget);
+
+    /**************************************************************************
+     * @brief Histogram diff of a[0..n) against b[0..m).
+     *************************************************************************/
+    static void histogramRange(const quint32 *a, int n, const quint32 *b, int m, int depth,
+                               QVector<int> &v1, QVector<int> &v2, QByteArray &script,
+                               const Budget *budget);
+
+    /**************************************************************************
+     * @brief Diffs a[0..n) against b[0..m), recursing on middle snakes.
+     *************************************************************************/
+    static void myersRange(const quint32 *a, int n, const quint32 *b, int m,
+                           QVector<int> &v1, QVector<int> &v2, QByteArray &script,
+                           const Budget *budget);
+
+    /**************************************************************************
+     * @brief Finds the middle snake split point of an optimal path, or,
+     *        once the budget runs out, a heuristic split.
+     * @param budget Optional limits; past maxCost or the deadline the
+     *        search stops and splits at its furthest-reaching path.
+     * @param approximate Set if the split came from that heuristic, so
+     *        the caller marks the ranges on both sides approximate.
+     * @return True with an optimal or heuristic split; false if the
+     *         ranges share no line at all, or the budget ran out before
+     *         any usable split.
+     *************************************************************************/
+    static bool myersBisect(const quint32 *a, int n, const quint32 *b, int m,
+                            QVector<int> &v1, QVector<int> &v2,
+                            int &splitX, int &splitY,
+                            const Budget *budget, bool &approximate);
+
+    /**************************************************************************
+     * @brief Returns true if the budget's deadline has passed.
+     *************************************************************************/
+    static bool outOfTime(const Budget *budget);
+};
+
+/*************** End of DiffKernels.h ****************************************/
@@ -0,0 +1,642 @@
+/******************************************************************************
+ * @file DiffModel.cpp
+ * @brief Implements the DiffModel class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.6
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Indexes carry their parent in internalId: 0 for a function row,
+ * entry + 1 for a diff row, FoldBit | fold for a row inside a fold.
+ * A changed function keeps a short list of segments (plain runs and
+ * folds) with prefix child offsets, and the first row of every op, so
+ * mapping a child row to its line is two binary searches no matter how
+ * long the function is. Runs the diff budget cut short are shown in
+ * italics with a tooltip, and their lines are not refined inline since
+ * a coarse block pairs unrelated lines.
+ ******************************************************************************/
+
+#include "DiffModel.h"
+#include "DiffRenderer.h"
+#include <QBrush>
+#include <QFont>
+#include <algorithm>
+
+static constexpr quintptr FoldBit = quintptr(1) << (sizeof(quintptr) * 8 - 1);
+
+/******************************************************************************
+ * @brief Constructor.
+ * @param parent Parent object.
+ ******************************************************************************/
+DiffModel::DiffModel(QObject *parent)
+    : QAbstractItemModel(parent)
+{
+}
+
+/******************************************************************************
+ * @brief Removes all functions.
+ ******************************************************************************/
+void DiffModel::clear()
+{
+    beginResetModel();
+    m_entries.clear();
+    m_byName.clear();
+    m_folds.clear();
+    m_fileName.clear();
+    endResetModel();
+}
+
+/******************************************************************************
+ * @brief Sets the compared file name.
+ ******************************************************************************/
+void DiffModel::setFileName(const QString &fileName)
+{
+    m_fileName = fileName;
+}
+
+/******************************************************************************
+ * @brief Returns the compared file name.
+ ******************************************************************************/
+QString DiffModel::fileName() const
+{
+    return m_fileName;
+}
+
+/******************************************************************************
+ * @brief Lists every function of both sides in name order.
+ * @param orig Original functions.
+ * @param news New functions.
+ ******************************************************************************/
+void DiffModel::setFunctions(const QMap<QString, FunctionBlock> &orig, const QMap<QString, FunctionBlock> &news)
+{
+    beginResetModel();
+    m_entries.clear();
+    m_byName.clear();
+    m_folds.clear();
+    auto o = orig.constBegin();
+    auto n = news.constBegin();
+    while (o != orig.constEnd() || n != news.constEnd())
+    {
+        Entry entry;
+        if (n == news.constEnd() || (o != orig.constEnd() && o.key() < n.key()))
+        {
+            entry.name = o.key();
+            entry.status = FunctionStatus::Missing;
+            entry.block = o.value();
+            ++o;
+        }
+        else if (o == orig.constEnd() || n.key() < o.key())
+        {
+            entry.name = n.key();
+            entry.status = FunctionStatus::Added;
+            entry.block = n.value();
+            ++n;
+        }
+        else
+        {
+            entry.name = o.key();
+            entry.status = o.value().fingerprint == n.value().fingerprint ? FunctionStatus::Unchanged
+                                                                          : FunctionStatus::Changed;
+            entry.block = n.value();
+            if (entry.status == FunctionStatus::Changed)
+            {
+                entry.origBlock = o.value();
+            }
+            ++o;
+            ++n;
+        }
+        m_byName.insert(entry.name, int(m_entries.size()));
+        m_entries.append(entry);
+    }
+    endResetModel();
+}
+
+/******************************************************************************
+ * @brief Sets the edit script of a changed function.
+ * @param name Function name from setFunctions.
+ * @param ops Script over the bodyLines() of the blocks given to
+ *            setFunctions.
+ ******************************************************************************/
+void DiffModel::setFunctionDiff(const QString &name, const QVector<EditOp> &ops)
+{
+    const int entryIndex = m_byName.value(name, -1);
+    if (entryIndex < 0 || m_entries.at(entryIndex).status != FunctionStatus::Changed
+        || m_entries.at(entryIndex).diffed)
+    {
+        return;
+    }
+    Entry &entry = m_entries[entryIndex];
+    entry.ops = ops;
+    entry.approximate = CompareEngine::isApproximate(ops);
+    entry.origLines = entry.origBlock.bodyLines();
+    entry.lines = entry.block.bodyLines();
+    entry.opRows.resize(ops.size());
+    int row = 0;
+    for (int i = 0; i < ops.size(); ++i)
+    {
+        entry.opRows[i] = row;
+        row += ops.at(i).length;
+    }
+    buildSegments(entryIndex);
+    // childCount is 0 until diffed is set, so the rows appear only
+    // between beginInsertRows and endInsertRows
+    const QModelIndex parentIndex = index(entryIndex, 0);
+    const int count = segmentRows(entry.segments);
+    if (count > 0)
+    {
+        beginInsertRows(parentIndex, 0, count - 1);
+        entry.diffed = true;
+        endInsertRows();
+    }
+    else
+    {
+        entry.diffed = true;
+    }
+    emit dataChanged(parentIndex, parentIndex);
+}
+
+/******************************************************************************
+ * @brief Splits the diff rows into segments; a run of unchanged rows
+ *        longer than FoldMinimum plus its context becomes a fold. Runs at
+ *        the start or end of a function keep context only on the side
+ *        facing a change.
+ * @param entryIndex Index into m_entries.
+ ******************************************************************************/
+void DiffModel::buildSegments(int entryIndex)
+{
+    Entry &entry = m_entries[entryIndex];
+    entry.segments.clear();
+    const int opCount = int(entry.ops.size());
+    const int n = opCount > 0 ? entry.opRows.last() + entry.ops.last().length : 0;
+    int child = 0;
+    auto addPlain = [&](int first, int count)
+    {
+        if (count <= 0)
+        {
+            return;
+        }
+        if (!entry.segments.isEmpty() && entry.segments.last().fold < 0)
+        {
+            entry.segments.last().count += count;
+        }
+        else
+        {
+            entry.segments.append({first, count, child, -1});
+        }
+        child += count;
+    };
+
+    // Adjacent Equal ops (split where blank lines were skipped) form one run
+    int k = 0;
+    while (k < opCount)
+    {
+        const int i = entry.opRows.at(k);
+        if (entry.ops.at(k).op != EditOp::Equal)
+        {
+            addPlain(i, entry.ops.at(k).length);
+            ++k;
+            continue;
+        }
+        while (k < opCount && entry.ops.at(k).op == EditOp::Equal)
+        {
+            ++k;
+        }
+        const int j = k < opCount ? entry.opRows.at(k) : n;
+        const int lead = i == 0 ? 0 : FoldContext;
+        const int trail = j == n ? 0 : FoldContext;
+        const int hidden = j - i - lead - trail;
+        if (hidden >= FoldMinimum)
+        {
+            addPlain(i, lead);
+            entry.segments.append({i + lead, hidden, child, int(m_folds.size())});
+            m_folds.append({entryIndex, int(entry.segments.size()) - 1});
+            ++child;
+            addPlain(j - trail, trail);
+        }
+        else
+        {
+            addPlain(i, j - i);
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief Finds the op holding a diff row.
+ * @param entry Changed function row.
+ * @param row Diff row.
+ * @param offset Set to the row's line within the op.
+ * @return Index into entry.ops.
+ ******************************************************************************/
+int DiffModel::opAt(const Entry &entry, int row, int &offset)
+{
+    auto it = std::upper_bound(entry.opRows.cbegin(), entry.opRows.cend(), row);
+    const int op = int(it - entry.opRows.cbegin()) - 1;
+    offset = row - entry.opRows.at(op);
+    return op;
+}
+
+/******************************************************************************
+ * @brief Number of children of a function row.
+ * @param entry Function row.
+ ******************************************************************************/
+int DiffModel::childCount(const Entry &entry) const
+{
+    if (entry.status == FunctionStatus::Changed)
+    {
+        return entry.diffed ? segmentRows(entry.segments) : 0;
+    }
+    return int(entry.lines.size());
+}
+
+/******************************************************************************
+ * @brief Number of child rows a segment layout makes: a fold is one row.
+ * @param segments Segments of a changed function.
+ ******************************************************************************/
+int DiffModel::segmentRows(const QVector<Segment> &segments)
+{
+    if (segments.isEmpty())
+    {
+        return 0;
+    }
+    const Segment &last = segments.last();
+    return last.childStart + (last.fold < 0 ? last.count : 1);
+}
+
+/******************************************************************************
+ * @brief Finds the segment holding a child row.
+ * @param entry Changed function row.
+ * @param child Child row.
+ * @return Index into entry.segments.
+ ******************************************************************************/
+int DiffModel::segmentAt(const Entry &entry, int child)
+{
+    auto it = std::upper_bound(entry.segments.cbegin(), entry.segments.cend(), child,
+                               [](int value, const Segment &segment)
+                               {
+                                   return value < segment.childStart;
+                               });
+    return int(it - entry.segments.cbegin()) - 1;
+}
+
+/******************************************************************************
+ * @brief Returns the changed spans of a deleted or inserted row. The k-th
+ *        deleted line of a hunk pairs with its k-th inserted line; both
+ *        rows are refined and cached together.
+ * @param entry Changed function row.
+ * @param row Diff row.
+ * @return Spans in line coordinates, empty if the row has no partner
+ *         or its run is approximate.
+ ******************************************************************************/
+QVector<InlineSpan> DiffModel::inlineSpans(const Entry &entry, int row)
+{
+    const auto cached = entry.spans.constFind(row);
+    if (cached != entry.spans.constEnd())
+    {
+        return cached.value();
+    }
+    int offset = 0;
+    const int p = opAt(entry, row, offset);
+    int deleted = -1;
+    int inserted = -1;
+    if (entry.ops.at(p).approximate)
+    {
+        return QVector<InlineSpan>();
+    }
+    if (entry.ops.at(p).op == EditOp::Delete && p + 1 < entry.ops.size()
+        && entry.ops.at(p + 1).op == EditOp::Insert && offset < entry.ops.at(p + 1).length)
+    {
+        deleted = p;
+        inserted = p + 1;
+    }
+    else if (entry.ops.at(p).op == EditOp::Insert && p > 0
+             && entry.ops.at(p - 1).op == EditOp::Delete && offset < entry.ops.at(p - 1).length)
+    {
+        deleted = p - 1;
+        inserted = p;
+    }
+    if (deleted < 0)
+    {
+        return QVector<InlineSpan>();
+    }
+    QVector<InlineSpan> originalSpans;
+    QVector<InlineSpan> changedSpans;
+    InlineDiff::diff(entry.origLines.at(entry.ops.at(deleted).origIndex + offset),
+                     entry.lines.at(entry.ops.at(inserted).newIndex + offset), originalSpans, changedSpans);
+    entry.spans.insert(entry.opRows.at(deleted) + offset, originalSpans);
+    entry.spans.insert(entry.opRows.at(inserted) + offset, changedSpans);
+    return p == deleted ? originalSpans : changedSpans;
+}
+
+/******************************************************************************
+ * @brief Returns the index of row under parent.
+ ******************************************************************************/
+QModelIndex DiffModel::index(int row, int column, const QModelIndex &parent) const
+{
+    if (!hasIndex(row, column, parent))
+    {
+        return QModelIndex();
+    }
+    if (!parent.isValid())
+    {
+        return createIndex(row, column, quintptr(0));
+    }
+    if (parent.internalId() == 0)
+    {
+        return createIndex(row, column, quintptr(parent.row() + 1));
+    }
+    const Entry &entry = m_entries.at(int(parent.internalId() - 1));
+    const Segment &segment = entry.segments.at(segmentAt(entry, parent.row()));
+    return createIndex(row, column, FoldBit | quintptr(segment.fold));
+}
+
+/******************************************************************************
+ * @brief Returns the parent of child.
+ ******************************************************************************/
+QModelIndex DiffModel::parent(const QModelIndex &child) const
+{
+    if (!child.isValid() || child.internalId() == 0)
+    {
+        return QModelIndex();
+    }
+    const quintptr id = child.internalId();
+    if (!(id & FoldBit))
+    {
+        return createIndex(int(id - 1), 0, quintptr(0));
+    }
+    const FoldRef &ref = m_folds.at(int(id & ~FoldBit));
+    const Segment &segment = m_entries.at(ref.entry).segments.at(ref.segment);
+    return createIndex(segment.childStart, 0, quintptr(ref.entry + 1));
+}
+
+/******************************************************************************
+ * @brief Returns the number of children of parent.
+ ******************************************************************************/
+int DiffModel::rowCount(const QModelIndex &parent) const
+{
+    if (!parent.isValid())
+    {
+        return int(m_entries.size());
+    }
+    if (parent.column() != 0)
+    {
+        return 0;
+    }
+    const quintptr id = parent.internalId();
+    if (id == 0)
+    {
+        return childCount(m_entries.at(parent.row()));
+    }
+    if (id & FoldBit)
+    {
+        return 0;
+    }
+    const Entry &entry = m_entries.at(int(id - 1));
+    if (entry.status != FunctionStatus::Changed)
+    {
+        return 0;
+    }
+    const Segment &segment = entry.segments.at(segmentAt(entry, parent.row()));
+    return segment.fold < 0 ? 0 : segment.count;
+}
+
+/******************************************************************************
+ * @brief Returns 1; the tree has a single column.
+ ******************************************************************************/
+int DiffModel::columnCount(const QModelIndex &parent) const
+{
+    Q_UNUSED(parent);
+    return 1;
+}
+
+/******************************************************************************
+ * @brief Function rows whose lines are not fetched yet still report
+ *        children, so the view shows an expander.
+ ******************************************************************************/
+bool DiffModel::hasChildren(const QModelIndex &parent) const
+{
+    if (parent.isValid() && parent.internalId() == 0)
+    {
+        const Entry &entry = m_entries.at(parent.row());
+        if (entry.status != FunctionStatus::Changed && !entry.fetched)
+        {
+            return !entry.block.body().isEmpty();
+        }
+    }
+    return rowCount(parent) > 0;
+}
+
+/******************************************************************************
+ * @brief True for a non-changed function whose lines are not listed yet.
+ ******************************************************************************/
+bool DiffModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (!parent.isValid() || parent.internalId() != 0)
+    {
+        return false;
+    }
+    const Entry &entry = m_entries.at(parent.row());
+    return entry.status != FunctionStatus::Changed && !entry.fetched;
+}
+
+/******************************************************************************
+ * @brief Lists the body lines of a non-changed function, as views into its
+ *        source text.
+ ******************************************************************************/
+void DiffModel::fetchMore(const QModelIndex &parent)
+{
+    if (!canFetchMore(parent))
+    {
+        return;
+    }
+    Entry &entry = m_entries[parent.row()];
+    const QVector<QStringView> lines = entry.block.bodyLines();
+    entry.fetched = true;
+    if (lines.isEmpty())
+    {
+        return;
+    }
+    beginInsertRows(parent, 0, int(lines.size()) - 1);
+    entry.lines = lines;
+    endInsertRows();
+}
+
+/******************************************************************************
+ * @brief Formats a row when the view asks for it.
+ ******************************************************************************/
+QVariant DiffModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid())
+    {
+        return QVariant();
+    }
+    const quintptr id = index.internalId();
+
+    if (id == 0)
+    {
+        const Entry &entry = m_entries.at(index.row());
+        switch (role)
+        {
+        case Qt::DisplayRole:
+            switch (entry.status)
+            {
+            case FunctionStatus::Unchanged: return entry.name;
+            case FunctionStatus::Changed:
+                if (!entry.diffed)
+                {
+                    return QString("%1  (diffing...)").arg(entry.name);
+                }
+                return entry.approximate ? QString("%1  (changed, approximate)").arg(entry.name)
+                                         : QString("%1  (changed)").arg(entry.name);
+            case FunctionStatus::Missing: return QString("%1  (missing in new)").arg(entry.name);
+            case FunctionStatus::Added: return QString("%1  (new)").arg(entry.name);
+            }
+            return QVariant();
+        case Qt::ForegroundRole:
+            switch (entry.status)
+            {
+            case FunctionStatus::Unchanged: return QBrush(Qt::darkGray);
+            case FunctionStatus::Changed: return QBrush(Qt::blue);
+            case FunctionStatus::Missing: return DiffRenderer::format('-').foreground();
+            case FunctionStatus::Added: return DiffRenderer::format('+').foreground();
+            }
+            return QVariant();
+        case Qt::ToolTipRole:
+            if (entry.approximate)
+            {
+                return tr("The diff budget ran out; italic hunks are coarse, not minimal.");
+            }
+            return QVariant();
+        case StatusRole:
+            return int(entry.status);
+        default:
+            return QVariant();
+        }
+    }
+
+    // Resolve the diff row, fold or body line behind the index
+    const Entry *entry = nullptr;
+    int row = -1;
+    int hidden = 0;
+    QChar marker(' ');
+    QStringView line;
+    bool approximate = false;
+    if (id & FoldBit)
+    {
+        const FoldRef &ref = m_folds.at(int(id & ~FoldBit));
+        entry = &m_entries.at(ref.entry);
+        row = entry->segments.at(ref.segment).first + index.row();
+    }
+    else
+    {
+        entry = &m_entries.at(int(id - 1));
+        if (entry->status == FunctionStatus::Changed)
+        {
+            const Segment &segment = entry->segments.at(segmentAt(*entry, index.row()));
+            if (segment.fold < 0)
+            {
+                row = segment.first + index.row() - segment.childStart;
+            }
+            else
+            {
+                hidden = segment.count;
+            }
+        }
+        else
+        {
+            marker = entry->status == FunctionStatus::Missing ? QLatin1Char('-')
+                   : entry->status == FunctionStatus::Added   ? QLatin1Char('+')
+                                                               : QLatin1Char(' ');
+            line = entry->lines.at(index.row());
+        }
+    }
+    if (row >= 0)
+    {
+        int offset = 0;
+        const EditOp &op = entry->ops.at(opAt(*entry, row, offset));
+        marker = op.marker();
+        line = op.line(entry->origLines, entry->lines, offset);
+        approximate = op.approximate;
+    }
+
+    switch (role)
+    {
+    case Qt::DisplayRole:
+        if (hidden > 0)
+        {
+            return QString("... %1 unchanged lines ...").arg(hidden);
+        }
+        return DiffRenderer::lineText(marker, line);
+    case Qt::ForegroundRole:
+        if (hidden > 0)
+        {
+            return QBrush(Qt::darkGray);
+        }
+        return DiffRenderer::format(marker).foreground();
+    case Qt::FontRole:
+        if (approximate)
+        {
+            QFont font;
+            font.setItalic(true);
+            return font;
+        }
+        return QVariant();
+    case Qt::ToolTipRole:
+        if (approximate)
+        {
+            return tr("Approximate hunk: the diff budget ran out here.");
+        }
+        return QVariant();
+    case MarkerRole:
+        return hidden > 0 ? QString() : QString(marker);
+    case SpansRole:
+        if (row >= 0)
+        {
+            // Shift past the "- " / "+ " prefix of the display text
+            QVector<InlineSpan> spans = inlineSpans(*entry, row);
+            for (int i = 0; i < spans.size(); ++i)
+            {
+                spans[i].start += 2;
+            }
+            return QVariant::fromValue(spans);
+        }
+        return QVariant();
+    default:
+        return QVariant();
+    }
+}
+
+/******************************************************************************
+ * @brief Returns the diff of every changed function as plain text.
+ ******************************************************************************/
+QString DiffModel::toPlainText() const
+{
+    QString text = m_fileName.isEmpty() ? QString() : QString("File: %1\n\n").arg(m_fileName);
+    for (int i = 0; i < m_entries.size(); ++i)
+    {
+        const Entry &entry = m_entries.at(i);
+        if (!entry.diffed)
+        {
+            continue;
+        }
+        text += entry.approximate ? QString("=== Function: %1 (approximate) ===\n").arg(entry.name)
+                                  : QString("=== Function: %1 ===\n").arg(entry.name);
+        for (int o = 0; o < entry.ops.size(); ++o)
+        {
+            const EditOp &op = entry.ops.at(o);
+            if (op.approximate && (o == 0 || !entry.ops.at(o - 1).approximate))
+            {
+                text += DiffRenderer::ApproximateNote;
+            }
+            for (int k = 0; k < op.length; ++k)
+            {
+                text += DiffRenderer::lineText(op.marker(), op.line(entry.origLines, entry.lines, k));
+                text += QLatin1Char('\n');
+            }
+        }
+        text += QLatin1Char('\n');
+    }
+    return text;
+}
+
+/*************** End of DiffModel.cpp ****************************************/
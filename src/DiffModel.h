@@ -0,0 +1,211 @@
+/******************************************************************************
+ * @file DiffModel.h
+ * @brief Declares the DiffModel item model behind the diff viewer.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.6
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * A three-level tree: functions, then their diff rows, then the lines
+ * hidden in a folded run of unchanged rows. Nothing is rendered up
+ * front; data() formats a row only when the view paints it. Changed
+ * functions hold their EditOp script and line views of both bodies;
+ * unchanged, missing and new functions hold only their FunctionBlock
+ * and list their lines on first expand (fetchMore). All line text stays
+ * in the shared source the blocks point to. A deleted line and the
+ * inserted line paired with it are refined by InlineDiff the first time
+ * either is painted (SpansRole); the result is cached per row.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QMap>
+#include <QString>
+#include <QStringView>
+#include <QVector>
+#include "CompareEngine.h"
+#include "InlineDiff.h"
+
+/******************************************************************************
+ * @enum FunctionStatus
+ * @brief How a function differs between the original and new side.
+ ******************************************************************************/
+enum class FunctionStatus
+{
+    Unchanged, /**< Equal fingerprints; folded by default */
+    Changed,   /**< Diffed; rows arrive via setFunctionDiff */
+    Missing,   /**< Only in the original */
+    Added      /**< Only in the new side */
+};
+
+/******************************************************************************
+ * @class DiffModel
+ * @brief Lazy tree model over the functions and diff rows of one compare.
+ ******************************************************************************/
+class DiffModel : public QAbstractItemModel
+{
+    Q_OBJECT
+
+public:
+    /**************************************************************************
+     * @enum Role
+     * @brief Extra data roles.
+     *************************************************************************/
+    enum Role
+    {
+        MarkerRole = Qt::UserRole + 1, /**< Row marker: " ", "-", "+", "~"; empty for folds */
+        StatusRole,                    /**< FunctionStatus of a function row, as int */
+        SpansRole                      /**< QVector<InlineSpan> of changed text in DisplayRole */
+    };
+
+    static constexpr int FoldMinimum = 8; ///< Fewest hidden rows worth a fold
+    static constexpr int FoldContext = 3; ///< Unchanged rows kept around a change
+
+    /**************************************************************************
+     * @brief Constructor.
+     * @param parent Parent object.
+     *************************************************************************/
+    explicit DiffModel(QObject *parent = nullptr);
+
+    /**************************************************************************
+     * @brief Removes all functions.
+     *************************************************************************/
+    void clear();
+
+    /**************************************************************************
+     * @brief Sets the compared file name, written at the top of toPlainText.
+     * @param fileName File name; empty for none.
+     *************************************************************************/
+    void setFileName(const QString &fileName);
+
+    /**************************************************************************
+     * @brief Returns the compared file name.
+     *************************************************************************/
+    QString fileName() const;
+
+    /**************************************************************************
+     * @brief Lists every function of both sides in name order. Changed
+     *        functions get their rows later from setFunctionDiff.
+     * @param orig Original functions.
+     * @param news New functions.
+     *************************************************************************/
+    void setFunctions(const QMap<QString, FunctionBlock> &orig, const QMap<QString, FunctionBlock> &news);
+
+    /**************************************************************************
+     * @brief Sets the edit script of a changed function; long unchanged
+     *        runs are folded.
+     * @param name Function name from setFunctions.
+     * @param ops Script over the bodyLines() of the blocks given to
+     *            setFunctions.
+     *************************************************************************/
+    void setFunctionDiff(const QString &name, const QVector<EditOp> &ops);
+
+    /**************************************************************************
+     * @brief Returns the diff of every changed function as plain text,
+     *        folds expanded, for saving, after a "File:" line if a file
+     *        name is set.
+     *************************************************************************/
+    QString toPlainText() const;
+
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const override;
+    QModelIndex parent(const QModelIndex &child) const override;
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    bool hasChildren(const QModelIndex &parent = QModelIndex()) const override;
+    bool canFetchMore(const QModelIndex &parent) const override;
+    void fetchMore(const QModelIndex &parent) override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+private:
+    /**************************************************************************
+     * @struct Segment
+     * @brief Consecutive diff rows shown either one child each or, for a
+     *        fold, as one child whose children are the rows.
+     *************************************************************************/
+    struct Segment
+    {
+        int first;      ///< First diff row
+        int count;      ///< Number of diff rows
+        int childStart; ///< Child row of the first diff row, or of the fold
+        int fold;       ///< Index into m_folds, -1 for plain rows
+    };
+
+    /**************************************************************************
+     * @struct Entry
+     * @brief One function row.
+     *************************************************************************/
+    struct Entry
+    {
+        QString name;                   ///< Function name
+        FunctionStatus status;          ///< How it differs
+        FunctionBlock block;            ///< Only block, or the new one if changed
+        FunctionBlock origBlock;        ///< Original block of a changed function
+        QVector<EditOp> ops;            ///< Edit script of a changed function
+        QVector<int> opRows;            ///< First diff row of each op
+        QVector<Segment> segments;      ///< Child layout of the diff rows
+        QVector<QStringView> origLines; ///< Original lines ops index
+        QVector<QStringView> lines;     ///< Body lines, or new lines ops index
+        mutable QHash<int, QVector<InlineSpan>> spans; ///< InlineDiff result per diff row
+        bool diffed = false;            ///< ops are set
+        bool approximate = false;       ///< Some op came from the budget fallback
+        bool fetched = false;           ///< lines of a non-changed function are set
+    };
+
+    /**************************************************************************
+     * @struct FoldRef
+     * @brief Locates a fold segment, so grandchild indexes fit in one id.
+     *************************************************************************/
+    struct FoldRef
+    {
+        int entry;   ///< Index into m_entries
+        int segment; ///< Index into Entry::segments
+    };
+
+    /**************************************************************************
+     * @brief Number of children of a function row; 0 for a changed
+     *        function until its diff is set.
+     *************************************************************************/
+    int childCount(const Entry &entry) const;
+
+    /**************************************************************************
+     * @brief Number of child rows a segment layout makes.
+     *************************************************************************/
+    static int segmentRows(const QVector<Segment> &segments);
+
+    /**************************************************************************
+     * @brief Finds the segment holding a child row.
+     *************************************************************************/
+    static int segmentAt(const Entry &entry, int child);
+
+    /**************************************************************************
+     * @brief Finds the op holding a diff row.
+     * @param entry Changed function row.
+     * @param row Diff row.
+     * @param offset Set to the row's line within the op.
+     * @return Index into entry.ops.
+     *************************************************************************/
+    static int opAt(const Entry &entry, int row, int &offset);
+
+    /**************************************************************************
+     * @brief Returns the changed spans of a deleted or inserted row, or an
+     *        empty list if it has no partner row.
+     * @param entry Changed function row.
+     * @param row Diff row.
+     *************************************************************************/
+    static QVector<InlineSpan> inlineSpans(const Entry &entry, int row);
+
+    /**************************************************************************
+     * @brief Splits the diff rows into plain and folded segments.
+     *************************************************************************/
+    void buildSegments(int entryIndex);
+
+    QVector<Entry> m_entries;   ///< Function rows in name order
+    QHash<QString, int> m_byName; ///< Function name -> m_entries index
+    QString m_fileName;           ///< Compared file name
+    QVector<FoldRef> m_folds;   ///< Every fold of every entry
+};
+
+/*************** End of DiffModel.h ******************************************/
@@ -0,0 +1,76 @@
+/******************************************************************************
+ * @file DiffRenderer.cpp
+ * @brief Implements the DiffRenderer class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.5
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Formats are created once and shared by every row and thread
+ * (QTextCharFormat is implicitly shared).
+ ******************************************************************************/
+
+#include "DiffRenderer.h"
+
+/******************************************************************************
+ * @brief Builds a format with the given foreground color.
+ ******************************************************************************/
+static QTextCharFormat colorFormat(Qt::GlobalColor color)
+{
+    QTextCharFormat fmt;
+    fmt.setForeground(color);
+    return fmt;
+}
+
+/******************************************************************************
+ * @brief Returns the shared format for a marker.
+ * @param marker First character of the row marker.
+ * @return Red for '-', green for '+', magenta for '~', black otherwise.
+ ******************************************************************************/
+const QTextCharFormat &DiffRenderer::format(QChar marker)
+{
+    static const QTextCharFormat added = colorFormat(Qt::green);
+    static const QTextCharFormat deleted = colorFormat(Qt::red);
+    static const QTextCharFormat moved = colorFormat(Qt::magenta);
+    static const QTextCharFormat same = colorFormat(Qt::black);
+    switch (marker.unicode())
+    {
+    case '+': return added;
+    case '-': return deleted;
+    case '~': return moved;
+    default: return same;
+    }
+}
+
+/******************************************************************************
+ * @brief Returns the background of changed text inside a line.
+ * @param marker Row marker.
+ * @return Light red for '-', light green otherwise.
+ ******************************************************************************/
+QColor DiffRenderer::highlight(QChar marker)
+{
+    return marker == QLatin1Char('-') ? QColor(255, 196, 196) : QColor(196, 240, 196);
+}
+
+/******************************************************************************
+ * @brief Returns the text of one row.
+ * @param marker Row marker from EditOp::marker.
+ * @param line Line text.
+ * @return Marker and text, e.g. "+ added line"; unchanged rows get only
+ *         a leading space.
+ ******************************************************************************/
+QString DiffRenderer::lineText(QChar marker, QStringView line)
+{
+    QString text;
+    text.reserve(line.size() + 2);
+    text += marker;
+    if (marker != QLatin1Char(' '))
+    {
+        text += QLatin1Char(' ');
+    }
+    text += line;
+    return text;
+}
+
+/*************** End of DiffRenderer.cpp *************************************/
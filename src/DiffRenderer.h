@@ -0,0 +1,55 @@
+/******************************************************************************
+ * @file DiffRenderer.h
+ * @brief Declares the DiffRenderer class that formats diff rows.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.5
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * The row text and colors shared by DiffModel, DiffDelegate and the
+ * saved diff text: "+ line" style row text, one shared format per
+ * marker, the inline highlight colors, and the ApproximateNote put
+ * before runs the diff budget cut short.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QColor>
+#include <QString>
+#include <QStringView>
+#include <QTextCharFormat>
+
+/******************************************************************************
+ * @class DiffRenderer
+ * @brief Stateless text and colors of diff rows.
+ ******************************************************************************/
+class DiffRenderer
+{
+public:
+    /** Line put before a run of approximate rows in shown and saved diffs */
+    static constexpr const char *ApproximateNote = "@@ approximate: diff budget exceeded @@\n";
+
+    /**************************************************************************
+     * @brief Returns the text of one row, e.g. "+ added line".
+     * @param marker Row marker from EditOp::marker.
+     * @param line Line text.
+     *************************************************************************/
+    static QString lineText(QChar marker, QStringView line);
+
+    /**************************************************************************
+     * @brief Returns the shared format for a marker: red for '-', green
+     *        for '+', magenta for '~', black otherwise.
+     * @param marker First character of the row marker.
+     *************************************************************************/
+    static const QTextCharFormat &format(QChar marker);
+
+    /**************************************************************************
+     * @brief Returns the background of changed text inside a line: light
+     *        red for '-', light green for '+'.
+     * @param marker Row marker.
+     *************************************************************************/
+    static QColor highlight(QChar marker);
+};
+
+/*************** End of DiffRenderer.h ***************************************/
@@ -0,0 +1,61 @@
+/******************************************************************************
+ * @file DiffView.cpp
+ * @brief Implements the DiffView class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.2
+ * @date 2026-10-16
+ * @section License MIT
+ ******************************************************************************/
+
+#include "DiffView.h"
+#include "DiffDelegate.h"
+#include "DiffModel.h"
+#include <QFontDatabase>
+
+/******************************************************************************
+ * @brief Constructor.
+ * @param parent Parent widget.
+ ******************************************************************************/
+DiffView::DiffView(QWidget *parent)
+    : QTreeView(parent)
+{
+    setUniformRowHeights(true);
+    setHeaderHidden(true);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    setSelectionMode(QAbstractItemView::ExtendedSelection);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setItemDelegate(new DiffDelegate(this));
+}
+
+/******************************************************************************
+ * @brief Sets the model and follows its row inserts.
+ * @param model A DiffModel.
+ ******************************************************************************/
+void DiffView::setModel(QAbstractItemModel *model)
+{
+    if (this->model())
+    {
+        disconnect(this->model(), &QAbstractItemModel::rowsInserted, this, &DiffView::onRowsInserted);
+    }
+    QTreeView::setModel(model);
+    if (model)
+    {
+        connect(model, &QAbstractItemModel::rowsInserted, this, &DiffView::onRowsInserted);
+    }
+}
+
+/******************************************************************************
+ * @brief Expands a changed function once its diff rows are inserted.
+ * @param parent Parent of the inserted rows.
+ ******************************************************************************/
+void DiffView::onRowsInserted(const QModelIndex &parent)
+{
+    if (parent.isValid() && !parent.parent().isValid()
+        && parent.data(DiffModel::StatusRole).toInt() == int(FunctionStatus::Changed))
+    {
+        expand(parent);
+    }
+}
+
+/*************** End of DiffView.cpp *****************************************/
@@ -0,0 +1,50 @@
+/******************************************************************************
+ * @file DiffView.h
+ * @brief Declares the DiffView tree that shows a DiffModel.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.2
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * A QTreeView set up for very long diffs: uniform row heights, so the
+ * view lays out and paints only the visible rows, a fixed-pitch font
+ * and no header. Changed functions expand as their rows arrive; folds
+ * and unchanged functions stay collapsed until clicked. DiffDelegate
+ * highlights the changed text inside paired -/+ rows.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QTreeView>
+
+/******************************************************************************
+ * @class DiffView
+ * @brief Tree view over a DiffModel.
+ ******************************************************************************/
+class DiffView : public QTreeView
+{
+    Q_OBJECT
+
+public:
+    /**************************************************************************
+     * @brief Constructor.
+     * @param parent Parent widget.
+     *************************************************************************/
+    explicit DiffView(QWidget *parent = nullptr);
+
+    /**************************************************************************
+     * @brief Sets the model and follows its row inserts.
+     * @param model A DiffModel.
+     *************************************************************************/
+    void setModel(QAbstractItemModel *model) override;
+
+private slots:
+    /**************************************************************************
+     * @brief Expands a changed function once its diff rows are inserted.
+     * @param parent Parent of the inserted rows.
+     *************************************************************************/
+    void onRowsInserted(const QModelIndex &parent);
+};
+
+/*************** End of DiffView.h *******************************************/
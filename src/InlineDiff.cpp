@@ -0,0 +1,145 @@
+/******************************************************************************
+ * @file InlineDiff.cpp
+ * @brief Implements the InlineDiff class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Lines are short, so a per-call QHash interner and Myers are plenty;
+ * the cost is only paid for rows a view actually shows.
+ ******************************************************************************/
+
+#include "InlineDiff.h"
+#include "CppLexer.h"
+#include "DiffKernels.h"
+#include <QHash>
+
+/******************************************************************************
+ * @brief Interns the text of each token.
+ * @param line Tokenized line.
+ * @param tokens Tokens of line.
+ * @param ids Shared token text -> ID table.
+ * @return One ID per token.
+ ******************************************************************************/
+static QVector<quint32> internTokens(QStringView line, const QVector<CppToken> &tokens,
+                                     QHash<QStringView, quint32> &ids)
+{
+    QVector<quint32> result;
+    result.reserve(tokens.size());
+    for (int i = 0; i < tokens.size(); ++i)
+    {
+        const QStringView text = line.mid(tokens.at(i).start, tokens.at(i).length);
+        auto it = ids.constFind(text);
+        if (it == ids.constEnd())
+        {
+            it = ids.insert(text, quint32(ids.size()));
+        }
+        result.append(it.value());
+    }
+    return result;
+}
+
+/******************************************************************************
+ * @brief Returns true for tokens worth narrowing to characters.
+ ******************************************************************************/
+static bool isOpaque(CppTokenKind kind)
+{
+    return kind == CppTokenKind::String || kind == CppTokenKind::RawString || kind == CppTokenKind::Char
+        || kind == CppTokenKind::Number || kind == CppTokenKind::Preprocessor;
+}
+
+/******************************************************************************
+ * @brief Appends the span covering tokens [first, last], including the
+ *        whitespace between them.
+ ******************************************************************************/
+static void addSpan(QVector<InlineSpan> &spans, const QVector<CppToken> &tokens, int first, int last)
+{
+    const int start = tokens.at(first).start;
+    const int end = tokens.at(last).end();
+    spans.append({ start, end - start });
+}
+
+/******************************************************************************
+ * @brief Finds the spans that differ between a line and its replacement.
+ * @param original Deleted line.
+ * @param changed Inserted line.
+ * @param originalSpans Receives the changed spans of original.
+ * @param changedSpans Receives the changed spans of changed.
+ * @return false if a line is too long to refine; both lists are empty.
+ ******************************************************************************/
+bool InlineDiff::diff(QStringView original, QStringView changed,
+                      QVector<InlineSpan> &originalSpans, QVector<InlineSpan> &changedSpans)
+{
+    originalSpans.clear();
+    changedSpans.clear();
+    if (original.size() > MaxLineLength || changed.size() > MaxLineLength)
+    {
+        return false;
+    }
+    const QVector<CppToken> a = CppLexer::tokenize(original);
+    const QVector<CppToken> b = CppLexer::tokenize(changed);
+    QHash<QStringView, quint32> ids;
+    const QVector<quint32> aIds = internTokens(original, a, ids);
+    const QVector<quint32> bIds = internTokens(changed, b, ids);
+    QByteArray script;
+    DiffKernels::myers(aIds, bIds, script);
+
+    // Each run of edits becomes one span per side
+    int i = 0, j = 0;
+    int pos = 0;
+    while (pos < script.size())
+    {
+        if (script.at(pos) == DiffKernels::OpEqual)
+        {
+            ++i; ++j; ++pos;
+            continue;
+        }
+        const int firstA = i;
+        const int firstB = j;
+        while (pos < script.size() && script.at(pos) != DiffKernels::OpEqual)
+        {
+            if (script.at(pos) == DiffKernels::OpDelete) { ++i; }
+            else { ++j; }
+            ++pos;
+        }
+        if (i - firstA == 1 && j - firstB == 1 && a.at(firstA).kind == b.at(firstB).kind && isOpaque(a.at(firstA).kind))
+        {
+            // One literal for another: keep only the differing middle
+            const QStringView x = original.mid(a.at(firstA).start, a.at(firstA).length);
+            const QStringView y = changed.mid(b.at(firstB).start, b.at(firstB).length);
+            int prefix = 0;
+            while (prefix < x.size() && prefix < y.size() && x.at(prefix) == y.at(prefix))
+            {
+                ++prefix;
+            }
+            int suffix = 0;
+            while (suffix < x.size() - prefix && suffix < y.size() - prefix
+                   && x.at(x.size() - 1 - suffix) == y.at(y.size() - 1 - suffix))
+            {
+                ++suffix;
+            }
+            if (x.size() - prefix - suffix > 0)
+            {
+                originalSpans.append({ a.at(firstA).start + prefix, int(x.size()) - prefix - suffix });
+            }
+            if (y.size() - prefix - suffix > 0)
+            {
+                changedSpans.append({ b.at(firstB).start + prefix, int(y.size()) - prefix - suffix });
+            }
+            continue;
+        }
+        if (i > firstA)
+        {
+            addSpan(originalSpans, a, firstA, i - 1);
+        }
+        if (j > firstB)
+        {
+            addSpan(changedSpans, b, firstB, j - 1);
+        }
+    }
+    return true;
+}
+
+/*************** End of InlineDiff.cpp ***************************************/
@@ -0,0 +1,54 @@
+/******************************************************************************
+ * @file InlineDiff.h
+ * @brief Declares the InlineDiff class that finds changed spans in a line.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Refines a deleted line and the inserted line paired with it: both are
+ * tokenized by CppLexer, the token texts are interned and diffed with
+ * the Myers kernel, and the tokens that differ become spans. A literal
+ * or directive replaced by another one is narrowed further to the
+ * characters that differ. Whitespace only matters inside a span.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QStringView>
+#include <QVector>
+
+/******************************************************************************
+ * @struct InlineSpan
+ * @brief Changed characters of one line.
+ ******************************************************************************/
+struct InlineSpan
+{
+    int start = 0;  /**< Offset of the first changed character */
+    int length = 0; /**< Number of characters */
+};
+
+/******************************************************************************
+ * @class InlineDiff
+ * @brief Stateless token-level diff of two lines.
+ ******************************************************************************/
+class InlineDiff
+{
+public:
+    static constexpr int MaxLineLength = 2000; ///< Longer lines are not refined
+
+    /**************************************************************************
+     * @brief Finds the spans that differ between a line and its
+     *        replacement.
+     * @param original Deleted line.
+     * @param changed Inserted line.
+     * @param originalSpans Receives the changed spans of original.
+     * @param changedSpans Receives the changed spans of changed.
+     * @return false if a line is too long to refine; both lists are empty.
+     *************************************************************************/
+    static bool diff(QStringView original, QStringView changed,
+                     QVector<InlineSpan> &originalSpans, QVector<InlineSpan> &changedSpans);
+};
+
+/*************** End of InlineDiff.h *****************************************/
@@ -0,0 +1,150 @@
+/******************************************************************************
+ * @file LineInterner.cpp
+ * @brief Implements the LineInterner class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.4
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Every line is normalized by Normalizer, whose flag-free scan is its
+ * own specialization, so lines compare the same way whichever policies
+ * are on; the text is then hashed with FNV-1a into an open-addressing
+ * table keyed by that hash.
+ ******************************************************************************/
+
+#include "LineInterner.h"
+#include "Normalizer.h"
+
+/******************************************************************************
+ * @brief Constructor.
+ * @param normalizeFlags Normalizer::Flag policies applied to each line.
+ ******************************************************************************/
+LineInterner::LineInterner(unsigned normalizeFlags)
+    : m_slots(64, 0)
+    , m_flags(normalizeFlags & ~unsigned(Normalizer::JoinLines))
+{
+}
+
+/******************************************************************************
+ * @brief Normalizes a line into m_scratch with Normalizer and hashes it.
+ * @param line Raw line text.
+ * @return FNV-1a hash of the normalized text.
+ ******************************************************************************/
+quint32 LineInterner::normalize(QStringView line)
+{
+    Normalizer::normalizeInto(line, m_flags, m_scratch);
+    quint32 h = 2166136261u;
+    for (qsizetype i = 0; i < m_scratch.size(); ++i)
+    {
+        h = (h ^ m_scratch.at(i).unicode()) * 16777619u;
+    }
+    return h;
+}
+
+/******************************************************************************
+ * @brief Normalizes and interns one line.
+ * @param line Raw line text.
+ * @return ID shared by every line with the same normalized text.
+ ******************************************************************************/
+quint32 LineInterner::intern(QStringView line)
+{
+    const quint32 h = normalize(line);
+    const quint32 mask = quint32(m_slots.size() - 1);
+    quint32 slot = h & mask;
+    while (m_slots.at(slot) != 0)
+    {
+        const quint32 id = m_slots.at(slot) - 1;
+        if (m_hashes.at(id) == h && m_texts.at(id) == m_scratch)
+        {
+            return id;
+        }
+        slot = (slot + 1) & mask;
+    }
+    const quint32 id = quint32(m_texts.size());
+    m_texts.append(m_scratch);
+    m_hashes.append(h);
+    m_slots[slot] = id + 1;
+    // Keep the table at most half full so probes stay short
+    if (m_texts.size() * 2 > m_slots.size())
+    {
+        grow();
+    }
+    return id;
+}
+
+/******************************************************************************
+ * @brief Interns every line of a list.
+ * @param lines Raw lines.
+ * @return One ID per line.
+ ******************************************************************************/
+QVector<quint32> LineInterner::internLines(const QStringList &lines)
+{
+    QVector<quint32> ids;
+    ids.reserve(lines.size());
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        ids.append(intern(lines.at(i)));
+    }
+    return ids;
+}
+
+/******************************************************************************
+ * @brief Interns every line of a list of views.
+ * @param lines Raw lines.
+ * @return One ID per line.
+ ******************************************************************************/
+QVector<quint32> LineInterner::internLines(const QVector<QStringView> &lines)
+{
+    QVector<quint32> ids;
+    ids.reserve(lines.size());
+    for (int i = 0; i < lines.size(); ++i)
+    {
+        ids.append(intern(lines.at(i)));
+    }
+    return ids;
+}
+
+/******************************************************************************
+ * @brief Returns the hash of the normalized text for an ID.
+ ******************************************************************************/
+quint32 LineInterner::hash(quint32 id) const
+{
+    return m_hashes.at(id);
+}
+
+/******************************************************************************
+ * @brief Returns the normalized text for an ID.
+ ******************************************************************************/
+const QString &LineInterner::text(quint32 id) const
+{
+    return m_texts.at(id);
+}
+
+/******************************************************************************
+ * @brief Returns the number of distinct lines interned so far.
+ ******************************************************************************/
+int LineInterner::size() const
+{
+    return int(m_texts.size());
+}
+
+/******************************************************************************
+ * @brief Doubles the slot table and reinserts all IDs.
+ ******************************************************************************/
+void LineInterner::grow()
+{
+    m_slots.fill(0, m_slots.size() * 2);
+    const quint32 mask = quint32(m_slots.size() - 1);
+    for (int id = 0; id < m_hashes.size(); ++id)
+    {
+        quint32 slot = m_hashes.at(id) & mask;
+        while (m_slots.at(slot) != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        m_slots[slot] = quint32(id) + 1;
+    }
+}
+
+/*************** End of LineInterner.cpp *************************************/
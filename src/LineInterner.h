@@ -0,0 +1,95 @@
+/******************************************************************************
+ * @file LineInterner.h
+ * @brief Declares the LineInterner class that maps lines to integer IDs.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.4
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Normalizes each line exactly once with Normalizer (collapses
+ * whitespace, trims, tightens braces) and
+ * assigns it a dense 32-bit ID plus a 32-bit hash. Lines that are
+ * equal after normalization get the same ID, so the diff kernels only
+ * compare integers. One interner is shared by both sides of a compare.
+ * Normalizer flags add policies such as dropping trailing semicolons;
+ * without any, lines compare by the same rules as with them.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QStringView>
+#include <QVector>
+
+/******************************************************************************
+ * @class LineInterner
+ * @brief Interns normalized lines into dense IDs with precomputed hashes.
+ ******************************************************************************/
+class LineInterner
+{
+public:
+    /**************************************************************************
+     * @brief Constructor.
+     * @param normalizeFlags Normalizer::Flag policies applied to each line.
+     *************************************************************************/
+    explicit LineInterner(unsigned normalizeFlags = 0);
+
+    /**************************************************************************
+     * @brief Normalizes and interns one line.
+     * @param line Raw line text.
+     * @return ID shared by every line with the same normalized text.
+     *************************************************************************/
+    quint32 intern(QStringView line);
+
+    /**************************************************************************
+     * @brief Interns every line of a list.
+     * @param lines Raw lines.
+     * @return One ID per line.
+     *************************************************************************/
+    QVector<quint32> internLines(const QStringList &lines);
+
+    /**************************************************************************
+     * @brief Interns every line of a list of views.
+     * @param lines Raw lines.
+     * @return One ID per line.
+     *************************************************************************/
+    QVector<quint32> internLines(const QVector<QStringView> &lines);
+
+    /**************************************************************************
+     * @brief Returns the hash of the normalized text for an ID.
+     *************************************************************************/
+    quint32 hash(quint32 id) const;
+
+    /**************************************************************************
+     * @brief Returns the normalized text for an ID.
+     *************************************************************************/
+    const QString &text(quint32 id) const;
+
+    /**************************************************************************
+     * @brief Returns the number of distinct lines interned so far.
+     *************************************************************************/
+    int size() const;
+
+private:
+    /**************************************************************************
+     * @brief Normalizes a line into m_scratch with Normalizer and hashes
+     *        the result.
+     * @return FNV-1a hash of the normalized text.
+     *************************************************************************/
+    quint32 normalize(QStringView line);
+
+    /**************************************************************************
+     * @brief Doubles the slot table and reinserts all IDs.
+     *************************************************************************/
+    void grow();
+
+    QVector<QString> m_texts;  ///< Normalized text per ID
+    QVector<quint32> m_hashes; ///< Hash per ID
+    QVector<quint32> m_slots;  ///< Open-addressing table of ID + 1 (0 = empty)
+    QString m_scratch;         ///< Reused normalization buffer
+    unsigned m_flags;          ///< Normalizer::Flag policies
+};
+
+/*************** End of LineInterner.h ***************************************/
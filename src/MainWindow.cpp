@@ -3,8 +3,8 @@
  * @brief Implements the main application window for DiffCheckAI.
  *
  * @author Jeffrey Scott Flesher with the help of AI: Copilot
- * @version 0.8
- * @date 2025-11-07
+ * @version 0.33
+ * @date 2026-10-16
  * @section License MIT
  * @section DESCRIPTION
  * Dynamic UI, function-aware compare, colorization:
@@ -15,11 +15,27 @@
  * Editable panes with undo/redo, save/open, overwrite warning.
  * Settings tab for CMake path, Temp path, Backup path.
  * Basic Temp/Projects scaffolding with file viewing/editing.
+ * Compare, project load and compile are timed per phase when
+ * Tools > Profile Phases is on. Project load copies with a background
+ * CopyJob and reports every failed file in one dialog; Incremental
+ * Load syncs Temp in place with TempSync. Backups are BackupStore
+ * snapshots, and Temp > Restore brings back one file from any of them.
+ * Link Temp Files shares project files with Temp; every save under the
+ * Temp root goes through CopyJob::unshareFile so it never writes into the
+ * project.
  ******************************************************************************/
 
 #include "MainWindow.h"
+#include "Config.h"
+#include "BackupStore.h"
+#include "CopyJob.h"
+#include "TempSync.h"
+#include "DiffModel.h"
+#include "DiffView.h"
+#include "Normalizer.h"
 #include <QApplication>
 #include <QClipboard>
+#include <QComboBox>
 #include <QDateTime>
 #include <QDir>
 #include <QElapsedTimer>
@@ -29,12 +45,15 @@
 #include <QFormLayout>
 #include <QHBoxLayout>
 #include <QIcon>
+#include <QInputDialog>
 #include <QLabel>
 #include <QMenu>
 #include <QMessageBox>
 #include <QProcess>
 #include <QProgressBar>
 #include <QRegularExpression>
+#include <QSharedPointer>
+#include <QSpinBox>
 #include <QSplitter>
 #include <QStatusBar>
 #include <QTextBlock>
@@ -64,8 +83,13 @@ MainWindow::MainWindow(QWidget *parent)
     compareTopSplitter(nullptr),
     originalEdit(nullptr),
     newEdit(nullptr),
+    comparisonTabs(nullptr),
+    diffModel(nullptr),
+    diffView(nullptr),
     comparisonEdit(nullptr),
     compareButton(nullptr),
+    cancelCompareButton(nullptr),
+    algorithmCombo(nullptr),
     cmakePathEdit(nullptr),
     cmakeBrowseButton(nullptr),
     cmakeLoadButton(nullptr),
@@ -79,6 +103,7 @@ MainWindow::MainWindow(QWidget *parent)
     tempSaveButton(nullptr),
     tempCopyButton(nullptr),
     tempPasteButton(nullptr),
+    tempRestoreButton(nullptr),
     tempClearButton(nullptr),
     projectsList(nullptr),
     projectsAddButton(nullptr),
@@ -101,6 +126,18 @@ MainWindow::MainWindow(QWidget *parent)
     actSaveNewAs(nullptr),
     actCompile(nullptr),
     actOverwriteWarn(nullptr),
+    actIgnoreBlankLines(nullptr),
+    actIgnoreSemicolons(nullptr),
+    actIgnoreComments(nullptr),
+    actCancelCompare(nullptr),
+    actProfilePhases(nullptr),
+    actSaveTrace(nullptr),
+    actIncrementalLoad(nullptr),
+    actLinkTemp(nullptr),
+    compareJob(nullptr),
+    compareProgress(nullptr),
+    copyJob(nullptr),
+    copyProgress(nullptr),
     overwriteWarn(true),
     originalPath(),
     newPath(),
@@ -125,6 +162,8 @@ MainWindow::MainWindow(QWidget *parent)
  ******************************************************************************/
 MainWindow::~MainWindow()
 {
+    delete compareJob; // Its pool tasks finish on their own copies
+    delete copyJob;
     delete compareEngine;
     delete appSettings;
     // Status bar queue
@@ -164,6 +203,8 @@ void MainWindow::setupUi()
     actSaveNewAs = new QAction(QIcon(":/icons/icons/save.svg"), tr("Save New As..."), this);
     actSaveComparison = new QAction(QIcon(":/icons/icons/save.svg"), tr("Save Comparison..."), this);
     actCompare = new QAction(QIcon(":/icons/icons/compare.svg"), tr("Compare"), this);
+    actCancelCompare = new QAction(QIcon(":/icons/icons/stop.svg"), tr("Cancel Compare"), this);
+    actCancelCompare->setEnabled(false);
     actAbout = new QAction(QIcon(":/icons/icons/about.svg"), tr("About"), this);
     actHelp = new QAction(QIcon(":/icons/icons/help.svg"), tr("Help"), this);
     actAddSelected = new QAction(tr("Add Selected Code"), this);
@@ -173,6 +214,30 @@ void MainWindow::setupUi()
     actOverwriteWarn = new QAction(tr("Warn on Overwrite"), this);
     actOverwriteWarn->setCheckable(true);
     actOverwriteWarn->setChecked(overwriteWarn);
+    actIgnoreBlankLines = new QAction(tr("Ignore Blank Lines"), this);
+    actIgnoreBlankLines->setCheckable(true);
+    actIgnoreBlankLines->setChecked(appSettings->value("compare/ignoreBlankLines", false).toBool());
+    actIgnoreSemicolons = new QAction(tr("Ignore Trailing Semicolons"), this);
+    actIgnoreSemicolons->setCheckable(true);
+    actIgnoreSemicolons->setChecked(appSettings->value("compare/ignoreTrailingSemicolons", false).toBool());
+    actIgnoreComments = new QAction(tr("Ignore Comment-Only Changes"), this);
+    actIgnoreComments->setCheckable(true);
+    actIgnoreComments->setChecked(appSettings->value("compare/ignoreCommentOnlyChanges", true).toBool());
+    compareEngine->setNormalizeFlags(normalizeFlagsFromActions());
+    actProfilePhases = new QAction(tr("Profile Phases"), this);
+    actProfilePhases->setCheckable(true);
+    actProfilePhases->setChecked(appSettings->value("profile/enabled", false).toBool());
+    actSaveTrace = new QAction(tr("Save Trace..."), this);
+    actSaveTrace->setEnabled(actProfilePhases->isChecked());
+    Profiler::setEnabled(actProfilePhases->isChecked());
+    actIncrementalLoad = new QAction(tr("Incremental Load"), this);
+    actIncrementalLoad->setCheckable(true);
+    actIncrementalLoad->setChecked(appSettings->value("load/incremental", true).toBool());
+    actLinkTemp = new QAction(tr("Link Temp Files (Copy on Write)"), this);
+    actLinkTemp->setCheckable(true);
+    actLinkTemp->setChecked(appSettings->value("load/link", false).toBool());
+    actLinkTemp->setToolTip(tr("Load shares project files with Temp (reflink or hard link); "
+                               "DiffCheckAI copies a file only when it first saves it"));
 
     // Menus
     QMenu *fileMenu = mb->addMenu(tr("&File"));
@@ -194,7 +259,17 @@ void MainWindow::setupUi()
 
     QMenu *toolsMenu = mb->addMenu(tr("&Tools"));
     toolsMenu->addAction(actCompare);
+    toolsMenu->addAction(actCancelCompare);
     toolsMenu->addAction(actCompile);
+    toolsMenu->addAction(actIncrementalLoad);
+    toolsMenu->addAction(actLinkTemp);
+    toolsMenu->addSeparator();
+    toolsMenu->addAction(actIgnoreBlankLines);
+    toolsMenu->addAction(actIgnoreSemicolons);
+    toolsMenu->addAction(actIgnoreComments);
+    toolsMenu->addSeparator();
+    toolsMenu->addAction(actProfilePhases);
+    toolsMenu->addAction(actSaveTrace);
 
     QMenu *helpMenu = mb->addMenu(tr("&Help"));
     helpMenu->addAction(actHelp);
@@ -204,6 +279,7 @@ void MainWindow::setupUi()
     tb->addAction(actOpenOriginal);
     tb->addAction(actOpenNew);
     tb->addAction(actCompare);
+    tb->addAction(actCancelCompare);
     tb->addAction(actSaveComparison);
     tb->addAction(actCompile);
     tb->addAction(actAbout);
@@ -243,11 +319,37 @@ void MainWindow::setupUi()
     QWidget *bottomPanel = new QWidget(verticalSplitter);
     QVBoxLayout *bottomPanelLayout = new QVBoxLayout(bottomPanel);
     compareButton = new QPushButton(tr("Compare"), bottomPanel);
-    comparisonEdit = new QPlainTextEdit(bottomPanel);
+    cancelCompareButton = new QPushButton(QIcon(":/icons/icons/cancel.svg"), tr("Cancel"), bottomPanel);
+    cancelCompareButton->setEnabled(false);
+    algorithmCombo = new QComboBox(bottomPanel);
+    algorithmCombo->setObjectName("algorithmCombo");
+    algorithmCombo->addItem(tr("Auto"), CompareEngine::diffAlgorithmName(DiffAlgorithm::Auto));
+    algorithmCombo->addItem(tr("Myers"), CompareEngine::diffAlgorithmName(DiffAlgorithm::Myers));
+    algorithmCombo->addItem(tr("Patience"), CompareEngine::diffAlgorithmName(DiffAlgorithm::Patience));
+    algorithmCombo->addItem(tr("Histogram"), CompareEngine::diffAlgorithmName(DiffAlgorithm::Histogram));
+    algorithmCombo->addItem(tr("Bit-parallel LCS"), CompareEngine::diffAlgorithmName(DiffAlgorithm::BitParallel));
+    // The reference LCS table is kept for tests only; an old setting naming it means Auto
+    const QString algorithmName = appSettings->value("compare/algorithm", "auto").toString();
+    const DiffAlgorithm algorithm = CompareEngine::diffAlgorithmFromName(algorithmName);
+    compareEngine->setDiffAlgorithm(algorithm == DiffAlgorithm::Lcs ? DiffAlgorithm::Auto : algorithm);
+    algorithmCombo->setCurrentIndex(qMax(0, algorithmCombo->findData(CompareEngine::diffAlgorithmName(compareEngine->diffAlgorithm()))));
+    QHBoxLayout *compareRowLayout = new QHBoxLayout();
+    compareRowLayout->addWidget(compareButton, 1);
+    compareRowLayout->addWidget(cancelCompareButton);
+    compareRowLayout->addWidget(new QLabel(tr("Algorithm:"), bottomPanel));
+    compareRowLayout->addWidget(algorithmCombo);
+    // Diffs go to a virtualized tree; the text pane keeps summaries and build logs
+    comparisonTabs = new QTabWidget(bottomPanel);
+    diffModel = new DiffModel(this);
+    diffView = new DiffView(comparisonTabs);
+    diffView->setModel(diffModel);
+    comparisonEdit = new QPlainTextEdit(comparisonTabs);
     comparisonEdit->setPlaceholderText(tr("Comparison output and summary..."));
     comparisonEdit->setReadOnly(false);
-    bottomPanelLayout->addWidget(compareButton);
-    bottomPanelLayout->addWidget(comparisonEdit);
+    comparisonTabs->addTab(diffView, tr("Diff"));
+    comparisonTabs->addTab(comparisonEdit, tr("Output"));
+    bottomPanelLayout->addLayout(compareRowLayout);
+    bottomPanelLayout->addWidget(comparisonTabs);
 
     verticalSplitter->addWidget(topPanel);
     verticalSplitter->addWidget(bottomPanel);
@@ -296,6 +398,22 @@ void MainWindow::setupUi()
     setForm->addRow(tr("Backup Path:"), backupRow);
     backupPathEdit->setEnabled(false);
 
+    // Diff budget rows; past either limit a hunk is diffed coarsely
+    maxEditCostSpin = new QSpinBox(tabSettings);
+    maxEditCostSpin->setObjectName("maxEditCostSpin");
+    maxEditCostSpin->setRange(0, 1000000);
+    maxEditCostSpin->setSpecialValueText(tr("Unlimited"));
+    maxEditCostSpin->setValue(appSettings->value("compare/maxEditCost", CompareEngine::DefaultMaxEditCost).toInt());
+    setForm->addRow(tr("Diff Edit Budget:"), maxEditCostSpin);
+    maxDiffTimeSpin = new QSpinBox(tabSettings);
+    maxDiffTimeSpin->setObjectName("maxDiffTimeSpin");
+    maxDiffTimeSpin->setRange(0, 600000);
+    maxDiffTimeSpin->setSuffix(tr(" ms"));
+    maxDiffTimeSpin->setSpecialValueText(tr("Unlimited"));
+    maxDiffTimeSpin->setValue(appSettings->value("compare/maxMilliseconds", CompareEngine::DefaultMaxMilliseconds).toInt());
+    setForm->addRow(tr("Diff Time Budget:"), maxDiffTimeSpin);
+    compareEngine->setDiffBudget(maxEditCostSpin->value(), maxDiffTimeSpin->value());
+
     // Save button for settings
     saveSettingsButton = new QPushButton(tr("Save"), tabSettings);
     saveSettingsButton->setObjectName("saveSettingsButton");
@@ -327,10 +445,13 @@ void MainWindow::setupUi()
     tempSaveButton = new QPushButton(tr("Save"), tabTemp);
     tempCopyButton = new QPushButton(tr("Copy"), tabTemp);
     tempPasteButton = new QPushButton(tr("Paste"), tabTemp);
+    tempRestoreButton = new QPushButton(tr("Restore..."), tabTemp);
+    tempRestoreButton->setToolTip(tr("Restore the selected file from a backup"));
     tempClearButton = new QPushButton(tr("Clear Temp Folder"), tabTemp);
     tempButtons->addWidget(tempSaveButton);
     tempButtons->addWidget(tempCopyButton);
     tempButtons->addWidget(tempPasteButton);
+    tempButtons->addWidget(tempRestoreButton);
     tempButtons->addWidget(tempClearButton);
 
     tempLayout->addWidget(tempSplitter);
@@ -367,6 +488,16 @@ void MainWindow::wireActions()
     connect(openButton, &QPushButton::clicked, this, &MainWindow::actionOpenOriginal);
     connect(openNewButton, &QPushButton::clicked, this, &MainWindow::actionOpenNew);
     connect(compareButton, &QPushButton::clicked, this, &MainWindow::actionCompare);
+    connect(cancelCompareButton, &QPushButton::clicked, this, &MainWindow::actionCancelCompare);
+    connect(actCompare, &QAction::triggered, this, &MainWindow::actionCompare);
+    connect(actCancelCompare, &QAction::triggered, this, &MainWindow::actionCancelCompare);
+    connect(algorithmCombo, &QComboBox::currentIndexChanged, this, &MainWindow::onDiffAlgorithmChanged);
+    connect(maxEditCostSpin, &QSpinBox::valueChanged, this, &MainWindow::onDiffBudgetChanged);
+    connect(maxDiffTimeSpin, &QSpinBox::valueChanged, this, &MainWindow::onDiffBudgetChanged);
+    connect(actProfilePhases, &QAction::toggled, this, &MainWindow::actionToggleProfiling);
+    connect(actSaveTrace, &QAction::triggered, this, &MainWindow::actionSaveTrace);
+    connect(actIncrementalLoad, &QAction::toggled, this, &MainWindow::onLoadOptionsChanged);
+    connect(actLinkTemp, &QAction::toggled, this, &MainWindow::onLoadOptionsChanged);
 
     // Settings tab
     connect(cmakeBrowseButton, &QPushButton::clicked, this, &MainWindow::browseCMakePath);
@@ -390,6 +521,7 @@ void MainWindow::wireActions()
             });
     connect(tempCopyButton, &QPushButton::clicked, this, &MainWindow::actionCopyTempFile);
     connect(tempPasteButton, &QPushButton::clicked, this, &MainWindow::actionPasteTempFile);
+    connect(tempRestoreButton, &QPushButton::clicked, this, &MainWindow::actionRestoreTempFile);
     connect(tempClearButton, &QPushButton::clicked, this, &MainWindow::clearTempFolder);
 
     // Projects tab
@@ -398,6 +530,9 @@ void MainWindow::wireActions()
     connect(projectsLoadButton, &QPushButton::clicked, this, &MainWindow::actionLoadProject);
 
     connect(actCompile, &QAction::triggered, this, &MainWindow::actionCompile);
+    connect(actIgnoreBlankLines, &QAction::toggled, this, &MainWindow::onNormalizeOptionsChanged);
+    connect(actIgnoreSemicolons, &QAction::toggled, this, &MainWindow::onNormalizeOptionsChanged);
+    connect(actIgnoreComments, &QAction::toggled, this, &MainWindow::onNormalizeOptionsChanged);
     // Cmake path change
     connect(cmakePathEdit, &QLineEdit::textChanged, this, &MainWindow::onCmakePathChanged);
     // Other connects as needed (menus, toolbar, etc.)
@@ -547,7 +682,7 @@ void MainWindow::actionSaveComparison()
     QString path = QFileDialog::getSaveFileName(this, tr("Save Comparison"), dir, tr("Text Files (*.txt);;All Files (*)"));
     if (path.isEmpty()) { return; }
     warnOverwriteIfNeeded(path, [this, path]() {
-        saveTextToFile(path, comparisonEdit->toPlainText());
+        saveTextToFile(path, diffModel->toPlainText() + comparisonEdit->toPlainText());
         queueStatusMessage(tr("Saved comparison: %1").arg(path), 2000);
     });
 }
@@ -557,134 +692,124 @@ void MainWindow::actionSaveComparison()
  ******************************************************************************/
 void MainWindow::actionCompare()
 {
+    if (compareJob)
+    {
+        return; // One compare at a time
+    }
     // Switch to Compare tab
     tabs->setCurrentWidget(tabCompare);
 
     // Clear comparison panel
+    diffModel->clear();
     comparisonEdit->clear();
+    comparisonTabs->setCurrentWidget(diffView);
 
-    // Get the code from the editors
-    QString orig = originalEdit->toPlainText();
-    QString news = newEdit->toPlainText();
-
-    // Extract functions before using origMap and newMap
-    auto origMap = compareEngine->extractFunctions(orig);
-    auto newMap = compareEngine->extractFunctions(news);
+    beginProfile();
 
     // Get file name from originalPath (or fallback)
-    QString fileName = originalPath.isEmpty() ? tr("Original") : QFileInfo(originalPath).fileName();
-
-    // Show progress bar in status bar
-    int totalSteps = origMap.size();
-    QProgressBar *progress = new QProgressBar(this);
-    progress->setRange(0, totalSteps);
-    statusBar()->addPermanentWidget(progress);
+    compareFileName = originalPath.isEmpty() ? tr("Original") : QFileInfo(originalPath).fileName();
+    diffModel->setFileName(compareFileName);
+    comparisonTabs->setTabText(comparisonTabs->indexOf(diffView), tr("Diff: %1").arg(compareFileName));
+
+    // Show progress bar in status bar; busy until the functions are known
+    compareProgress = new QProgressBar(this);
+    compareProgress->setRange(0, 0);
+    statusBar()->addPermanentWidget(compareProgress);
     queueStatusMessage(tr("Comparison started..."));
 
-    int step = 0;
-    for (auto it = origMap.constBegin(); it != origMap.constEnd(); ++it)
+    compareButton->setEnabled(false);
+    actCompare->setEnabled(false);
+    cancelCompareButton->setEnabled(true);
+    actCancelCompare->setEnabled(true);
+
+    // Extraction and diffs run on the thread pool; results come back queued
+    compareJob = new CompareJob(*compareEngine, originalEdit->toPlainText(), newEdit->toPlainText());
+    connect(compareJob, &CompareJob::extracted, this, &MainWindow::onCompareExtracted);
+    connect(compareJob, &CompareJob::functionDiffed, this, &MainWindow::onCompareFunctionDiffed);
+    connect(compareJob, &CompareJob::finished, this, &MainWindow::onCompareFinished);
+    connect(compareJob, &CompareJob::canceled, this, &MainWindow::onCompareCanceled);
+    compareJob->start();
+}
+
+/******************************************************************************
+ * @brief Cancels the running compare, keeping the functions diffed so far.
+ ******************************************************************************/
+void MainWindow::actionCancelCompare()
+{
+    if (compareJob)
     {
-        const QString &fname = it.key();
-        if (!newMap.contains(fname)) { continue; }
-        const auto &fo = it.value();
-        const auto &fn = newMap.value(fname);
-        auto diff = compareEngine->diffLines(fo.bodyLines, fn.bodyLines);
+        compareJob->cancel();
+    }
+}
 
-        // Pass all required arguments: diff, fileName, functionName
-        setPaneColorsFromDiff(diff, fileName, fname);
+/******************************************************************************
+ * @brief Lists every function in the diff view and sizes the progress bar
+ *        once the job knows how much to diff.
+ * @param changedCount Number of functions to diff.
+ * @param orig Original functions.
+ * @param news New functions.
+ ******************************************************************************/
+void MainWindow::onCompareExtracted(int changedCount, const QMap<QString, FunctionBlock> &orig,
+                                    const QMap<QString, FunctionBlock> &news)
+{
+    diffModel->setFunctions(orig, news);
+    compareProgress->setRange(0, changedCount);
+    compareProgress->setValue(0);
+}
 
-        progress->setValue(++step);
-        QApplication::processEvents();
-    }
+/******************************************************************************
+ * @brief Hands one diffed function to the diff view and advances the
+ *        progress bar. Nothing is rendered here; the view formats only the
+ *        rows it paints.
+ * @param name Function name.
+ * @param ops Edit script from CompareEngine::diffLines.
+ ******************************************************************************/
+void MainWindow::onCompareFunctionDiffed(const QString &name, const QVector<EditOp> &ops)
+{
+    diffModel->setFunctionDiff(name, ops);
+    compareProgress->setValue(compareProgress->value() + 1);
+}
 
+/******************************************************************************
+ * @brief Appends the summary and ends the compare.
+ * @param summary Text from CompareEngine::buildSummary.
+ ******************************************************************************/
+void MainWindow::onCompareFinished(const QString &summary)
+{
     // Optionally colorize summary as well
     QTextCursor cursor(comparisonEdit->document());
     QTextCharFormat fmt;
     fmt.setForeground(Qt::darkGray);
-    cursor.insertText("\n" + compareEngine->buildSummary(origMap, newMap) + "\n", fmt);
+    cursor.insertText("\n" + summary + "\n", fmt);
 
-    statusBar()->removeWidget(progress);
-    progress->deleteLater();
-    queueStatusMessage(tr("Comparison finished"), 3000);
+    endCompare();
+    endProfile(tr("Comparison finished"), 3000);
 }
 
 /******************************************************************************
- * @brief Color-codes the lower comparison panel from diff results.
+ * @brief Ends a canceled compare.
  ******************************************************************************/
-void MainWindow::setPaneColorsFromDiff(const QVector<QVector<QString>> &diff,
-                                       const QString &fileName,
-                                       const QString &functionName)
+void MainWindow::onCompareCanceled()
 {
-    QTextCursor cursor(comparisonEdit->document());
-
-    // Divider
-    QTextCharFormat dividerFmt;
-    dividerFmt.setForeground(Qt::darkGray);
-    cursor.insertText("-----------------------------------------------------------------\n", dividerFmt);
-
-    // File and function header
-    QTextCharFormat headerFmt;
-    headerFmt.setForeground(Qt::blue);
-    cursor.insertText(QString("File: %1\nFunction: %2\n\n").arg(fileName, functionName), headerFmt);
-
-    // Diff lines
-    for (const auto &triple : diff)
-    {
-        QTextCharFormat fmt;
-        if (triple[0] == "+")
-            fmt.setForeground(Qt::green);
-        else if (triple[0] == "-")
-            fmt.setForeground(Qt::red);
-        else if (triple[0] == "~")
-            fmt.setForeground(Qt::magenta);
-        else
-            fmt.setForeground(Qt::black);
-
-        QString line;
-        if (triple[0] == "+")
-            line = "+ " + triple[2];
-        else if (triple[0] == "-")
-            line = "- " + triple[1];
-        else if (triple[0] == "~")
-            line = "~ " + (triple[2].isEmpty() ? triple[1] : triple[2]);
-        else
-            line = " " + triple[1];
-
-        cursor.insertText(line + "\n", fmt);
-    }
-    cursor.insertText("\n", dividerFmt); // Optional: another divider after each diff
+    endCompare();
+    endProfile(tr("Comparison canceled"), 3000);
 }
 
 /******************************************************************************
- * @brief Appends readable diff text per function into comparison.
+ * @brief Removes the progress bar, releases the job and re-enables Compare.
  ******************************************************************************/
-void MainWindow::appendComparisonText(const QString &functionName,
-                                      const QVector<QVector<QString>> &diff)
+void MainWindow::endCompare()
 {
-    comparisonEdit->appendPlainText(QString("=== Function: %1 ===").arg(functionName));
-    for (const auto &row : diff)
-    {
-        const QString &marker = row[0];
-        const QString &ol = row[1];
-        const QString &nl = row[2];
-        if (marker == " ")
-        {
-            comparisonEdit->appendPlainText(" " + ol);
-        }
-        else if (marker == "-")
-        {
-            comparisonEdit->appendPlainText("- " + ol);
-        }
-        else if (marker == "+")
-        {
-            comparisonEdit->appendPlainText("+ " + nl);
-        }
-        else if (marker == "~")
-        {
-            comparisonEdit->appendPlainText("~ " + (nl.isEmpty() ? ol : nl));
-        }
-    }
-    comparisonEdit->appendPlainText(QString());
+    statusBar()->removeWidget(compareProgress);
+    compareProgress->deleteLater();
+    compareProgress = nullptr;
+    // Deleted later: this runs inside one of the job's signals
+    compareJob->deleteLater();
+    compareJob = nullptr;
+    compareButton->setEnabled(true);
+    actCompare->setEnabled(true);
+    cancelCompareButton->setEnabled(false);
+    actCancelCompare->setEnabled(false);
 }
 
 /******************************************************************************
@@ -816,6 +941,19 @@ void MainWindow::warnOverwriteIfNeeded(const QString &path, std::function<void()
 void MainWindow::saveTextToFile(const QString &path, const QString &text)
 {
     QDir().mkpath(QFileInfo(path).absolutePath());
+    // A Temp file linked to the project gets its own copy first; hard
+    // links anywhere else are the user's own and are written through
+    const QString tempRoot = QDir(tempPathEdit->text().trimmed()).absolutePath();
+    const QString absolutePath = QFileInfo(path).absoluteFilePath();
+    if (!tempPathEdit->text().trimmed().isEmpty() && absolutePath.startsWith(tempRoot + "/"))
+    {
+        const QString unshareError = CopyJob::unshareFile(path);
+        if (!unshareError.isEmpty())
+        {
+            QMessageBox::critical(this, tr("Save Failed"), tr("Cannot write: %1").arg(unshareError));
+            return;
+        }
+    }
     QFile f(path);
     if (!f.open(QIODevice::WriteOnly | QIODevice::Text))
     {
@@ -906,9 +1044,11 @@ void MainWindow::actionCompile()
 {
     QElapsedTimer timer;
     timer.start();
+    beginProfile();
 
     // Switch to Compare tab and show progress immediately
     tabs->setCurrentWidget(tabCompare);
+    comparisonTabs->setCurrentWidget(comparisonEdit);
     comparisonEdit->clear();
     queueStatusMessage(tr("Compile started..."), 2000);
 
@@ -1022,7 +1162,10 @@ void MainWindow::actionCompile()
                               tr("Failed to start CMake configuration process."));
         return;
     }
-    cmakeConfig.waitForFinished(-1);
+    {
+        PROFILE_SCOPE("cmake configure");
+        cmakeConfig.waitForFinished(-1);
+    }
     QString configOut = QString::fromUtf8(cmakeConfig.readAllStandardOutput());
     QString configErr = QString::fromUtf8(cmakeConfig.readAllStandardError());
     comparisonEdit->appendPlainText("=== CMake Configure Output ===");
@@ -1048,7 +1191,10 @@ void MainWindow::actionCompile()
                               tr("Failed to start CMake build process."));
         return;
     }
-    cmakeBuild.waitForFinished(-1);
+    {
+        PROFILE_SCOPE("cmake build");
+        cmakeBuild.waitForFinished(-1);
+    }
     QString buildOut = QString::fromUtf8(cmakeBuild.readAllStandardOutput());
     QString buildErr = QString::fromUtf8(cmakeBuild.readAllStandardError());
     comparisonEdit->appendPlainText("=== CMake Build Output ===");
@@ -1091,7 +1237,7 @@ void MainWindow::actionCompile()
     double seconds = ms / 1000.0;
     QString timeMsg = tr("Elapsed time: %1 seconds").arg(QString::number(seconds, 'f', 2));
     QMessageBox::information(this, tr("Compile Results"), summary + "\n\n" + timeMsg);
-    queueStatusMessage(tr("Compile complete. ") + timeMsg, 5000);
+    endProfile(tr("Compile complete. ") + timeMsg, 5000);
     comparisonEdit->appendPlainText(timeMsg);
 
 }
@@ -1177,13 +1323,22 @@ void MainWindow::browseTempPath()
 
 /******************************************************************************
  * @brief Loads the CMake project into the temp folder, backing up any existing
- *        temp contents to a timestamped backup folder (excluding build).
+ *        temp contents (excluding build) as a timestamped BackupStore snapshot.
  *        Warns before deleting temp contents, then copies all files/folders
  *        from the CMake project (excluding build) into temp.
- *        Shows progress feedback for both backup and copy operations.
+ *        Backup, delete and copy run as one background CopyJob with byte
+ *        progress; the backup is a BackupStore snapshot, and if it reports
+ *        any error, temp is left as it was.
+ *        With Tools > Incremental Load, TempSync updates temp in place
+ *        instead, after the same snapshot. With Tools > Link Temp Files
+ *        the project files are cloned or hard-linked rather than copied.
  ******************************************************************************/
 void MainWindow::loadCMakeProject()
 {
+    if (copyJob)
+    {
+        return; // One load at a time
+    }
     QString cmakePath = cmakePathEdit->text().trimmed();
     QString tempRoot = tempPathEdit->text().trimmed();
     QString backupRoot = backupPathEdit->text().trimmed();
@@ -1203,11 +1358,48 @@ void MainWindow::loadCMakeProject()
         return;
     }
 
-    // --- Backup existing temp contents ---
-    QDir tempDir(tempRoot);
-    QStringList tempEntries = tempDir.entryList(QDir::NoDotAndDotDot | QDir::AllEntries);
+    // Backups are snapshots in the content-addressed store under backupRoot
+    const QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+    const QString projectRoot = cfi.absolutePath();
 
-    if (!tempEntries.isEmpty())
+    // --- Incremental: snapshot Temp, then copy only what changed ---
+    if (actIncrementalLoad->isChecked())
+    {
+        beginProfile();
+        CopyJob *job = new CopyJob(this);
+        job->setLinkFiles(actLinkTemp->isChecked());
+        QSharedPointer<QString> snapshotName(new QString());
+        job->setPlanner([projectRoot, tempRoot, backupRoot, timestamp, snapshotName]()
+                        {
+                            CopyPlan plan;
+                            BackupStore store(backupRoot);
+                            *snapshotName = store.snapshot(tempRoot, timestamp, QStringList("build"), &plan.errors);
+                            if (!plan.errors.isEmpty())
+                            {
+                                return plan; // Never overwrite what could not be saved
+                            }
+                            return TempSync::plan(projectRoot, tempRoot, QString());
+                        });
+        startCopy(job, tr("Syncing project to temp..."), [this, job, snapshotName](const QStringList &errors)
+                  {
+                      const CopyPlan &plan = job->currentPlan();
+                      QString message = tr("Temp synced: %1 copied, %2 removed, %3 unchanged.")
+                                            .arg(plan.files.size()).arg(plan.removed).arg(plan.unchanged);
+                      if (!snapshotName->isEmpty())
+                      {
+                          message += " " + tr("Backup: %1").arg(*snapshotName);
+                      }
+                      if (!errors.isEmpty())
+                      {
+                          showCopyErrors(tr("Sync Project"), errors);
+                      }
+                      endProfile(message, errors.isEmpty() ? 3000 : 5000);
+                  });
+        return;
+    }
+
+    const bool tempEmpty = QDir(tempRoot).entryList(QDir::NoDotAndDotDot | QDir::AllEntries).isEmpty();
+    if (!tempEmpty)
     {
         int ret = QMessageBox::warning(this, tr("Clear Temp Folder"),
                                        tr("This will delete all contents in the temp folder:\n%1\n"
@@ -1219,123 +1411,135 @@ void MainWindow::loadCMakeProject()
             queueStatusMessage(tr("Load cancelled."), 2000);
             return;
         }
+    }
 
-        // Create timestamped backup folder
-        QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
-        QString backupFolder = backupRoot + "/" + timestamp;
-        QDir().mkpath(backupFolder);
+    // --- Backup, clear and copy (excluding build) as one job ---
+    // Every step runs on the copy pool, and Load stays disabled until the
+    // last one ends, so a second Load can never start in between
+    beginProfile();
+    CopyJob *job = new CopyJob(this);
+    job->setLinkFiles(actLinkTemp->isChecked());
+    QSharedPointer<QString> snapshotName(new QString());
+    QSharedPointer<bool> backedUp(new bool(false));
+    job->setPlanner([projectRoot, tempRoot, backupRoot, timestamp, tempEmpty, snapshotName, backedUp]()
+                    {
+                        CopyPlan cleared;
+                        if (!tempEmpty)
+                        {
+                            *snapshotName = BackupStore(backupRoot).snapshot(tempRoot, timestamp, QStringList("build"),
+                                                                             &cleared.errors);
+                            if (!cleared.errors.isEmpty())
+                            {
+                                return cleared; // Never delete what could not be saved
+                            }
+                            PROFILE_SCOPE("clear temp");
+                            const QDir dir(tempRoot);
+                            const QFileInfoList entries = dir.entryInfoList(QDir::NoDotAndDotDot | QDir::AllEntries);
+                            for (const QFileInfo &entry : entries)
+                            {
+                                if (entry.fileName() == "build")
+                                {
+                                    continue;
+                                }
+                                const bool removed = entry.isDir() && !entry.isSymLink()
+                                                         ? QDir(entry.absoluteFilePath()).removeRecursively()
+                                                         : QFile::remove(entry.absoluteFilePath());
+                                if (!removed)
+                                {
+                                    cleared.errors << QString("Cannot remove %1").arg(entry.absoluteFilePath());
+                                }
+                            }
+                        }
+                        *backedUp = true;
+                        CopyPlan plan = CopyJob::plan(QStringList(projectRoot), QStringList(tempRoot),
+                                                      QVector<QStringList>({ QStringList("build") }));
+                        plan.errors = cleared.errors + plan.errors;
+                        return plan;
+                    });
+    const QString message = tempEmpty ? tr("Copying project to temp...")
+                                      : tr("Backing up temp, then copying project to temp...");
+    startCopy(job, message,
+              [this, tempRoot, snapshotName, backedUp](const QStringList &errors)
+              {
+                  if (!*backedUp)
+                  {
+                      showCopyErrors(tr("Backup Incomplete"), errors);
+                      endProfile(tr("Load stopped: the backup is incomplete, Temp was left unchanged."), 5000);
+                      return;
+                  }
+                  QString message = errors.isEmpty()
+                                        ? tr("Project loaded to Temp: %1").arg(tempRoot)
+                                        : tr("Project loaded to Temp with %n error(s): %1", "", int(errors.size())).arg(tempRoot);
+                  if (!snapshotName->isEmpty())
+                  {
+                      message += " " + tr("Backup: %1").arg(*snapshotName);
+                  }
+                  if (!errors.isEmpty())
+                  {
+                      showCopyErrors(tr("Load Project"), errors);
+                  }
+                  endProfile(message, errors.isEmpty() ? 3000 : 5000);
+              });
+}
 
-        // Progress bar for backup
-        QProgressBar *backupProgress = new QProgressBar(this);
-        backupProgress->setRange(0, tempEntries.size());
-        statusBar()->addPermanentWidget(backupProgress);
-        queueStatusMessage(tr("Backing up temp folder..."));
+/******************************************************************************
+ * @brief Runs a prepared CopyJob with a byte progress bar in the status bar.
+ ******************************************************************************/
+void MainWindow::startCopy(CopyJob *job, const QString &message,
+                           std::function<void(const QStringList &errors)> onFinished)
+{
+    copyProgress = new QProgressBar(this);
+    copyProgress->setRange(0, 0); // Busy until the tree is walked
+    statusBar()->addPermanentWidget(copyProgress);
+    queueStatusMessage(message);
+    cmakeLoadButton->setEnabled(false);
 
-        int backupStep = 0;
-        for (int i = 0; i < tempEntries.size(); ++i)
-        {
-            QString entry = tempEntries.at(i);
-            if (entry == "build") { continue; }
-            QString srcPath = tempDir.absoluteFilePath(entry);
-            QString dstPath = backupFolder + "/" + entry;
-            copyRecursively(srcPath, dstPath);
-            ++backupStep;
-            backupProgress->setValue(backupStep);
-            QApplication::processEvents();
-        }
-        statusBar()->removeWidget(backupProgress);
-        backupProgress->deleteLater();
-        queueStatusMessage(tr("Backup created: %1").arg(backupFolder), 3000);
-
-        // Progress bar for deletion
-        QProgressBar *deleteProgress = new QProgressBar(this);
-        deleteProgress->setRange(0, tempEntries.size());
-        statusBar()->addPermanentWidget(deleteProgress);
-        queueStatusMessage(tr("Deleting temp folder contents..."));
-
-        int deleteStep = 0;
-        for (int i = 0; i < tempEntries.size(); ++i)
-        {
-            QString entry = tempEntries.at(i);
-            if (entry == "build") { continue; }
-            QString entryPath = tempDir.absoluteFilePath(entry);
-            QFileInfo fi(entryPath);
-            if (fi.isDir())
+    copyJob = job;
+    connect(copyJob, &CopyJob::progress, this, [this](qint64 bytesDone, qint64 bytesTotal)
             {
-                QDir(entryPath).removeRecursively();
-            }
-            else
+                // Per mille, so sizes beyond an int still fit the bar
+                copyProgress->setRange(0, 1000);
+                copyProgress->setValue(bytesTotal > 0 ? int(bytesDone * 1000 / bytesTotal) : 1000);
+                copyProgress->setFormat(tr("%1 of %2 MB").arg(double(bytesDone) / 1048576.0, 0, 'f', 1)
+                                            .arg(double(bytesTotal) / 1048576.0, 0, 'f', 1));
+            });
+    connect(copyJob, &CopyJob::finished, this, [this, onFinished](const QStringList &errors)
             {
-                QFile::remove(entryPath);
-            }
-            ++deleteStep;
-            deleteProgress->setValue(deleteStep);
-            QApplication::processEvents();
-        }
-        statusBar()->removeWidget(deleteProgress);
-        deleteProgress->deleteLater();
-    }
-
-    // --- Copy CMake project files/folders to temp (excluding build) ---
-    QDir srcDir = cfi.dir();
-    QStringList srcEntries = srcDir.entryList(QDir::NoDotAndDotDot | QDir::AllEntries);
+                endCopy();
+                onFinished(errors);
+            });
+    connect(copyJob, &CopyJob::canceled, this, [this]()
+            {
+                endCopy();
+                endProfile(tr("Load canceled"), 3000);
+            });
+    copyJob->start();
+}
 
-    QProgressBar *copyProgress = new QProgressBar(this);
-    copyProgress->setRange(0, srcEntries.size());
-    statusBar()->addPermanentWidget(copyProgress);
-    queueStatusMessage(tr("Copying project to temp..."));
-
-    int copyStep = 0;
-    for (int i = 0; i < srcEntries.size(); ++i)
-    {
-        QString entry = srcEntries.at(i);
-        if (entry == "build") { continue; }
-        QString srcPath = srcDir.absoluteFilePath(entry);
-        QString dstPath = tempRoot + "/" + entry;
-        copyRecursively(srcPath, dstPath);
-        ++copyStep;
-        copyProgress->setValue(copyStep);
-        QApplication::processEvents();
-    }
+/******************************************************************************
+ * @brief Removes the copy progress bar and releases the job.
+ ******************************************************************************/
+void MainWindow::endCopy()
+{
     statusBar()->removeWidget(copyProgress);
     copyProgress->deleteLater();
-
-    queueStatusMessage(tr("Project loaded to Temp: %1").arg(tempRoot), 3000);
+    copyProgress = nullptr;
+    // Deleted later: this runs inside one of the job's signals
+    copyJob->deleteLater();
+    copyJob = nullptr;
+    cmakeLoadButton->setEnabled(true);
 }
 
 /******************************************************************************
- * @brief Recursively copies files and folders from srcPath to dstPath.
+ * @brief Reports every file a CopyJob could not copy in one dialog.
  ******************************************************************************/
-bool MainWindow::copyRecursively(const QString &srcPath, const QString &dstPath)
+void MainWindow::showCopyErrors(const QString &title, const QStringList &errors)
 {
-    QFileInfo srcInfo(srcPath);
-    if (srcInfo.isDir())
-    {
-        QDir().mkpath(dstPath);
-        QDir srcDir(srcPath);
-        QStringList subEntries = srcDir.entryList(QDir::NoDotAndDotDot | QDir::AllEntries);
-        for (int i = 0; i < subEntries.size(); ++i)
-        {
-            const QString &subEntry = subEntries.at(i);
-            QString subSrcPath = srcDir.absoluteFilePath(subEntry);
-            QString subDstPath = dstPath + "/" + subEntry;
-            if (!copyRecursively(subSrcPath, subDstPath))
-            {
-                return false;
-            }
-        }
-    }
-    else
-    {
-        QDir().mkpath(QFileInfo(dstPath).absolutePath());
-        if (!QFile::copy(srcPath, dstPath))
-        {
-            QMessageBox::warning(this, tr("Copy Error"),
-                                 tr("Could not copy file:\n%1\nto\n%2").arg(srcPath, dstPath));
-            return false;
-        }
-    }
-    return true;
+    QMessageBox box(QMessageBox::Warning, title,
+                    tr("%n file(s) or folder(s) could not be copied.", "", int(errors.size())),
+                    QMessageBox::Ok, this);
+    box.setDetailedText(errors.join("\n"));
+    box.exec();
 }
 
 /******************************************************************************
@@ -1490,6 +1694,13 @@ void MainWindow::actionSaveTempFile()
         return;
     }
     QString path = tempModel->filePath(idx);
+    // A Temp file linked to the project gets its own copy first
+    const QString unshareError = CopyJob::unshareFile(path);
+    if (!unshareError.isEmpty())
+    {
+        QMessageBox::warning(this, tr("Save Failed"), unshareError);
+        return;
+    }
     QFile file(path);
     if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
     {
@@ -1521,6 +1732,139 @@ void MainWindow::actionPasteTempFile()
     queueStatusMessage(tr("Pasted from clipboard."), 2000);
 }
 
+/******************************************************************************
+ * @brief Restores the file selected in the Temp tree from a backup
+ *        snapshot. Only snapshots where the file differs from the next
+ *        older one are offered, newest first. Temp is snapshotted before
+ *        the file is replaced; both run as a CopyJob planner, so never
+ *        during a Load and never on the GUI thread.
+ ******************************************************************************/
+void MainWindow::actionRestoreTempFile()
+{
+    if (copyJob)
+    {
+        queueStatusMessage(tr("Wait for the running Load to finish before restoring."), 3000);
+        return;
+    }
+    QModelIndex idx = tempTree->currentIndex();
+    if (!idx.isValid() || tempModel->isDir(idx))
+    {
+        QMessageBox::warning(this, tr("No File Selected"), tr("Please select a file in the Temp folder tree."));
+        return;
+    }
+    const QString path = tempModel->filePath(idx);
+    const QString relative = QDir(tempPathEdit->text().trimmed()).relativeFilePath(path);
+    BackupStore store(backupPathEdit->text().trimmed());
+
+    const QStringList names = store.snapshots();
+    QStringList versions;
+    QStringList labels;
+    QByteArray olderHash;
+    for (int i = 0; i < names.size(); ++i)
+    {
+        const SyncEntry entry = store.files(names.at(i)).value(relative);
+        if (!entry.hash.isEmpty() && entry.hash != olderHash)
+        {
+            versions.prepend(names.at(i));
+            labels.prepend(tr("%1  (%2 bytes, modified %3)")
+                               .arg(names.at(i))
+                               .arg(entry.size)
+                               .arg(QDateTime::fromMSecsSinceEpoch(entry.mtime).toString("yyyy-MM-dd HH:mm:ss")));
+        }
+        olderHash = entry.hash;
+    }
+    if (versions.isEmpty())
+    {
+        QMessageBox::information(this, tr("Restore from Backup"), tr("No backup holds:\n%1").arg(relative));
+        return;
+    }
+
+    bool ok = false;
+    const QString label = QInputDialog::getItem(this, tr("Restore from Backup"),
+                                                tr("Version of %1 to restore:").arg(relative), labels, 0, false, &ok);
+    if (!ok)
+    {
+        return;
+    }
+    const QString name = versions.at(labels.indexOf(label));
+    warnOverwriteIfNeeded(path, [this, path, relative, name]()
+                          {
+                              if (copyJob)
+                              {
+                                  return; // A Load started while the dialog was open
+                              }
+                              const QString tempRoot = tempPathEdit->text().trimmed();
+                              const QString backupRoot = backupPathEdit->text().trimmed();
+                              const QString timestamp = QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+                              QSharedPointer<bool> backedUp(new bool(false));
+                              beginProfile();
+                              CopyJob *job = new CopyJob(this);
+                              job->setPlanner([tempRoot, backupRoot, timestamp, path, relative, name, backedUp]()
+                                              {
+                                                  // The file being replaced is saved first, so a restore can be undone
+                                                  CopyPlan plan;
+                                                  BackupStore store(backupRoot);
+                                                  store.snapshot(tempRoot, timestamp, QStringList("build"), &plan.errors);
+                                                  if (!plan.errors.isEmpty())
+                                                  {
+                                                      return plan;
+                                                  }
+                                                  *backedUp = true;
+                                                  const QString error = store.restoreFile(name, relative, path);
+                                                  if (!error.isEmpty())
+                                                  {
+                                                      plan.errors << error;
+                                                  }
+                                                  return plan;
+                                              });
+                              startCopy(job, tr("Backing up temp, then restoring %1...").arg(relative),
+                                        [this, path, relative, name, backedUp](const QStringList &errors)
+                                        {
+                                            if (!*backedUp)
+                                            {
+                                                showCopyErrors(tr("Backup Incomplete"), errors);
+                                                endProfile(tr("Restore stopped: the backup is incomplete."), 5000);
+                                                return;
+                                            }
+                                            if (!errors.isEmpty())
+                                            {
+                                                QMessageBox::warning(this, tr("Restore Failed"), errors.join("\n"));
+                                                endProfile(tr("Restore failed: %1").arg(relative), 5000);
+                                                return;
+                                            }
+                                            reloadEditorsShowing(path);
+                                            endProfile(tr("Restored %1 from backup %2").arg(relative, name), 3000);
+                                        });
+                          });
+}
+
+/******************************************************************************
+ * @brief Reloads every editor that shows @p path after it changed on disk.
+ ******************************************************************************/
+void MainWindow::reloadEditorsShowing(const QString &path)
+{
+    QFile f(path);
+    if (!f.open(QIODevice::ReadOnly | QIODevice::Text))
+    {
+        return;
+    }
+    const QString text = QString::fromUtf8(f.readAll());
+    // The Temp editor saves to the selected file, which is the one restored
+    const QModelIndex idx = tempTree->currentIndex();
+    if (idx.isValid() && tempModel->filePath(idx) == path)
+    {
+        tempFileEdit->setPlainText(text);
+    }
+    if (originalPath == path)
+    {
+        originalEdit->setPlainText(text);
+    }
+    if (newPath == path)
+    {
+        newEdit->setPlainText(text);
+    }
+}
+
 /******************************************************************************
  * @brief Adds a new project to the projects list.
  ******************************************************************************/
@@ -1717,4 +2061,128 @@ void MainWindow::onCmakePathChanged()
         backupPathEdit->clear();
     }
 }
+
+/****************************************************************
+ * @brief Applies the diff algorithm chosen in the Compare tab
+ * and saves it to settings.
+ * @param index Index in the algorithm combo box.
+ ***************************************************************/
+void MainWindow::onDiffAlgorithmChanged(int index)
+{
+    const QString name = algorithmCombo->itemData(index).toString();
+    compareEngine->setDiffAlgorithm(CompareEngine::diffAlgorithmFromName(name));
+    appSettings->setValue("compare/algorithm", name);
+    appSettings->save();
+}
+
+/****************************************************************
+ * @brief Builds the Normalizer flags from the Tools menu toggles.
+ * @return Combination of Normalizer::Flag values.
+ ***************************************************************/
+unsigned MainWindow::normalizeFlagsFromActions() const
+{
+    unsigned flags = Normalizer::NoFlags;
+    if (actIgnoreBlankLines->isChecked()) { flags |= Normalizer::IgnoreBlankLines; }
+    if (actIgnoreSemicolons->isChecked()) { flags |= Normalizer::IgnoreTrailingSemicolons; }
+    if (actIgnoreComments->isChecked()) { flags |= Normalizer::IgnoreCommentOnlyChanges; }
+    return flags;
+}
+
+/****************************************************************
+ * @brief Applies the normalization toggles of the Tools menu
+ * and saves them to settings.
+ ***************************************************************/
+void MainWindow::onNormalizeOptionsChanged()
+{
+    compareEngine->setNormalizeFlags(normalizeFlagsFromActions());
+    appSettings->setValue("compare/ignoreBlankLines", actIgnoreBlankLines->isChecked());
+    appSettings->setValue("compare/ignoreTrailingSemicolons", actIgnoreSemicolons->isChecked());
+    appSettings->setValue("compare/ignoreCommentOnlyChanges", actIgnoreComments->isChecked());
+    appSettings->save();
+}
+
+/****************************************************************
+ * @brief Applies the diff budget of the Settings tab and saves
+ * it to settings.
+ ***************************************************************/
+void MainWindow::onDiffBudgetChanged()
+{
+    compareEngine->setDiffBudget(maxEditCostSpin->value(), maxDiffTimeSpin->value());
+    appSettings->setValue("compare/maxEditCost", maxEditCostSpin->value());
+    appSettings->setValue("compare/maxMilliseconds", maxDiffTimeSpin->value());
+    appSettings->save();
+}
+
+/****************************************************************
+ * @brief Saves the project load options.
+ ***************************************************************/
+void MainWindow::onLoadOptionsChanged()
+{
+    appSettings->setValue("load/incremental", actIncrementalLoad->isChecked());
+    appSettings->setValue("load/link", actLinkTemp->isChecked());
+    appSettings->save();
+}
+
+/****************************************************************
+ * @brief Turns the Profiler on or off and saves the choice.
+ * @param on True to record phase timings.
+ ***************************************************************/
+void MainWindow::actionToggleProfiling(bool on)
+{
+    Profiler::setEnabled(on);
+    Profiler::reset();
+    actSaveTrace->setEnabled(on);
+    appSettings->setValue("profile/enabled", on);
+    appSettings->save();
+}
+
+/****************************************************************
+ * @brief Writes the phases of the last profiled operation as a
+ * trace file for chrome://tracing or ui.perfetto.dev.
+ ***************************************************************/
+void MainWindow::actionSaveTrace()
+{
+    const QString path = QFileDialog::getSaveFileName(this, tr("Save Trace"), QDir::homePath() + "/diffcheck_trace.json",
+                                                      tr("Trace files (*.json)"));
+    if (path.isEmpty())
+    {
+        return;
+    }
+    if (!Profiler::writeTrace(path))
+    {
+        QMessageBox::warning(this, tr("Save Trace"), tr("Could not write:\n%1").arg(path));
+        return;
+    }
+    queueStatusMessage(tr("Trace saved: %1").arg(path), 3000);
+}
+
+/****************************************************************
+ * @brief Starts a profiled operation: forgets the previous
+ * phases, so the breakdown and trace cover this one only.
+ ***************************************************************/
+void MainWindow::beginProfile()
+{
+    if (Profiler::isEnabled())
+    {
+        Profiler::reset();
+    }
+}
+
+/****************************************************************
+ * @brief Queues the status message of a finished operation,
+ * with the slowest phases appended when profiling.
+ * @param message Status message.
+ * @param timeoutMs Display time; doubled for the breakdown.
+ ***************************************************************/
+void MainWindow::endProfile(const QString &message, int timeoutMs)
+{
+    const QString phases = Profiler::isEnabled() ? Profiler::summary() : QString();
+    if (phases.isEmpty())
+    {
+        queueStatusMessage(message, timeoutMs);
+        return;
+    }
+    queueStatusMessage(tr("%1 | %2").arg(message, phases), timeoutMs * 2);
+}
+
 /*************** End of MainWindow.cpp ***************************************/
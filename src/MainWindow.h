@@ -3,15 +3,24 @@
  * @brief Declares the main application window for DiffCheckAI.
  *
  * @author Jeffrey Scott Flesher with the help of AI: Copilot
- * @version 0.10
- * @date    2025-11-08
+ * @version 0.26
+ * @date    2026-10-16
  * @section License MIT
  * @section DESCRIPTION
  * Main GUI window with tabs for Compare, Settings, Temp, and Projects.
  * Integrates CompareEngine for function-aware code comparison.
- * The Compare panel is cleared and shows a progress bar during comparison.
+ * The Compare panel is cleared and shows a progress bar during comparison,
+ * which runs as a background CompareJob and can be canceled.
  * Diff output is fully colorized: red for removed, green for new,
  * magenta for reordered, black for unchanged.
+ * Tools > Profile Phases times compare, load and compile phases (see
+ * Profiler) and shows the slowest in the status bar; Save Trace writes
+ * them as a chrome://tracing file.
+ * Loading a CMake project into Temp copies in the background (CopyJob),
+ * or with Incremental Load only syncs what changed (TempSync); Temp is
+ * backed up as BackupStore snapshots, and single files restored from them.
+ * Link Temp Files makes Load share files with the project instead of
+ * copying them; they are copied when first saved (break-on-write).
  ******************************************************************************/
 
 #pragma once
@@ -31,6 +40,8 @@
 #include <QToolBar>
 #include <QStatusBar>
 #include <QProgressBar>
+#include <QComboBox>
+#include <QSpinBox>
 #include <functional>
 #include <queue>
 #include <mutex>
@@ -40,6 +51,11 @@
 #include <QColor>
 #include "Settings.h"
 #include "CompareEngine.h"
+#include "CompareJob.h"
+#include "CopyJob.h"
+
+class DiffModel;
+class DiffView;
 
 /******************************************************************************
  * @class MainWindow
@@ -100,8 +116,42 @@ private slots:
 
     /******************************************************************************
      * @brief Handles Compare: tab focus, progress, diff, colors, summary.
+     *        The work runs in a CompareJob; results fill the diff view as they arrive.
+     ******************************************************************************/
+    void actionCompare(); // Clears panel, shows progress bar, starts the job
+
+    /******************************************************************************
+     * @brief Cancels the running compare, keeping the functions diffed so far.
+     ******************************************************************************/
+    void actionCancelCompare();
+
+    /******************************************************************************
+     * @brief Lists every function in the diff view and sizes the progress bar.
+     * @param changedCount Number of functions to diff.
+     * @param orig Original functions.
+     * @param news New functions.
+     ******************************************************************************/
+    void onCompareExtracted(int changedCount, const QMap<QString, FunctionBlock> &orig,
+                            const QMap<QString, FunctionBlock> &news);
+
+    /******************************************************************************
+     * @brief Hands one diffed function to the diff view and advances the
+     *        progress bar.
+     * @param name Function name.
+     * @param ops Edit script from CompareEngine::diffLines.
+     ******************************************************************************/
+    void onCompareFunctionDiffed(const QString &name, const QVector<EditOp> &ops);
+
+    /******************************************************************************
+     * @brief Appends the summary and ends the compare.
+     * @param summary Text from CompareEngine::buildSummary.
+     ******************************************************************************/
+    void onCompareFinished(const QString &summary);
+
+    /******************************************************************************
+     * @brief Ends a canceled compare.
      ******************************************************************************/
-    void actionCompare(); // Clears panel, shows progress bar, colorizes diff
+    void onCompareCanceled();
 
     /******************************************************************************
      * @brief Shows the About dialog.
@@ -176,7 +226,7 @@ private slots:
 
     /******************************************************************************
      * @brief Loads the CMake project into the temp folder, backing up any existing
-     *        temp contents to a timestamped backup folder (excluding build).
+     *        temp contents (excluding build) as a timestamped BackupStore snapshot.
      ******************************************************************************/
     void loadCMakeProject();
 
@@ -200,6 +250,11 @@ private slots:
      ******************************************************************************/
     void actionPasteTempFile();
 
+    /******************************************************************************
+     * @brief Restores the selected Temp file from a backup snapshot.
+     ******************************************************************************/
+    void actionRestoreTempFile();
+
     /******************************************************************************
      * @brief Adds a new project to the projects list.
      ******************************************************************************/
@@ -217,12 +272,61 @@ private slots:
 
     void onCmakePathChanged();
 
+    /******************************************************************************
+     * @brief Applies the diff algorithm chosen in the Compare tab and saves it.
+     * @param index Index in the algorithm combo box.
+     ******************************************************************************/
+    void onDiffAlgorithmChanged(int index);
+
+    /******************************************************************************
+     * @brief Applies the normalization toggles of the Tools menu and saves them.
+     ******************************************************************************/
+    void onNormalizeOptionsChanged();
+
+    /******************************************************************************
+     * @brief Applies the diff budget of the Settings tab and saves it.
+     ******************************************************************************/
+    void onDiffBudgetChanged();
+
+    /******************************************************************************
+     * @brief Saves the project load options.
+     ******************************************************************************/
+    void onLoadOptionsChanged();
+
+    /******************************************************************************
+     * @brief Turns the Profiler on or off and saves the choice.
+     * @param on True to record phase timings.
+     ******************************************************************************/
+    void actionToggleProfiling(bool on);
+
+    /******************************************************************************
+     * @brief Writes the recorded phases as a chrome://tracing / Perfetto file.
+     ******************************************************************************/
+    void actionSaveTrace();
+
 private:
+    /******************************************************************************
+     * @brief Starts a profiled operation: forgets the previous phases.
+     ******************************************************************************/
+    void beginProfile();
+
+    /******************************************************************************
+     * @brief Queues @p message, followed by the phase breakdown when profiling.
+     * @param message Status message of the finished operation.
+     * @param timeoutMs Display time.
+     ******************************************************************************/
+    void endProfile(const QString &message, int timeoutMs);
+
     /******************************************************************************
      * @brief Sets up the main window UI, including all tabs and panels.
      ******************************************************************************/
     void setupUi();
 
+    /******************************************************************************
+     * @brief Builds the Normalizer flags from the Tools menu toggles.
+     ******************************************************************************/
+    unsigned normalizeFlagsFromActions() const;
+
     /******************************************************************************
      * @brief Connects actions and widgets to their slots.
      ******************************************************************************/
@@ -233,24 +337,10 @@ private:
      ******************************************************************************/
     void updateAddSelectedEnabled();
 
-    /**************************************************************************
-     * @brief Colorizes diff output in the comparison panel.
-     *        - Red for removed (-)
-     *        - Green for new (+)
-     *        - Magenta for reordered (~)
-     *        - Black for unchanged ( )
-     * @param diff Diff result from CompareEngine.
-     *************************************************************************/
-    void setPaneColorsFromDiff(const QVector<QVector<QString>> &diff,
-                               const QString &fileName, const QString &functionName);
-
     /******************************************************************************
-     * @brief Appends readable diff text per function into comparison.
-     * @param functionName Name of the function.
-     * @param diff Diff result from CompareEngine.
+     * @brief Removes the progress bar, releases the job and re-enables Compare.
      ******************************************************************************/
-    void appendComparisonText(const QString &functionName,
-                              const QVector<QVector<QString>> &diff);
+    void endCompare();
 
     /******************************************************************************
      * @brief Warns before overwriting an existing file, with YesToAll.
@@ -312,12 +402,31 @@ private:
     void browseBackupPath();
 
     /******************************************************************************
-     * @brief Recursively copies files and folders from srcPath to dstPath.
-     * @param srcPath Source path.
-     * @param dstPath Destination path.
-     * @return true if successful, false otherwise.
+     * @brief Runs a prepared CopyJob with a byte progress bar.
+     * @param job Job with its trees or planner set; owned by the window.
+     * @param message Status bar message while copying.
+     * @param onFinished Called with the collected errors when the job ends.
+     ******************************************************************************/
+    void startCopy(CopyJob *job, const QString &message,
+                   std::function<void(const QStringList &errors)> onFinished);
+
+    /******************************************************************************
+     * @brief Removes the copy progress bar and releases the job.
+     ******************************************************************************/
+    void endCopy();
+
+    /******************************************************************************
+     * @brief Reports every file a CopyJob could not copy in one dialog.
+     * @param title Dialog title.
+     * @param errors Errors from CopyJob::finished.
+     ******************************************************************************/
+    void showCopyErrors(const QString &title, const QStringList &errors);
+
+    /******************************************************************************
+     * @brief Reloads every editor that shows @p path after it changed on disk.
+     * @param path File that changed.
      ******************************************************************************/
-    bool copyRecursively(const QString &srcPath, const QString &dstPath);
+    void reloadEditorsShowing(const QString &path);
 
     /******************************************************************************
      * @brief Extracts source/header file paths from CMakeLists.txt.
@@ -350,8 +459,13 @@ private:
     QSplitter *compareTopSplitter;     ///< Splitter for top section of Compare tab.
     QTextEdit *originalEdit;           ///< Editor for original code.
     QTextEdit *newEdit;                ///< Editor for new code.
-    QPlainTextEdit *comparisonEdit;    ///< Output panel for comparison results.
+    QTabWidget *comparisonTabs;        ///< Diff and Output pages of the lower panel.
+    DiffModel *diffModel;              ///< Functions and diff rows of the last compare.
+    DiffView *diffView;                ///< Virtualized view of diffModel.
+    QPlainTextEdit *comparisonEdit;    ///< Output panel for summaries and build logs.
     QPushButton *compareButton;        ///< Button to trigger code comparison.
+    QPushButton *cancelCompareButton;  ///< Button to cancel a running comparison.
+    QComboBox *algorithmCombo;         ///< Diff algorithm used by Compare.
 
     QLineEdit *cmakePathEdit;          ///< Edit field for CMakeLists.txt path.
     QPushButton *cmakeBrowseButton;    ///< Button to browse for CMakeLists.txt.
@@ -361,6 +475,8 @@ private:
     QPushButton *tempBrowseButton;     ///< Button to browse for temp folder.
 
     QLineEdit *backupPathEdit;         ///< Edit field for backup folder path.
+    QSpinBox *maxEditCostSpin;         ///< Diff edit cost budget, 0 for none.
+    QSpinBox *maxDiffTimeSpin;         ///< Diff time budget in ms, 0 for none.
     QPushButton *saveSettingsButton;   ///< Button to save settings in Settings tab.
 
     QSplitter *tempSplitter;           ///< Splitter for Temp tab panels.
@@ -371,6 +487,7 @@ private:
     QPushButton *tempSaveButton;       ///< Button to save temp file.
     QPushButton *tempCopyButton;       ///< Button to copy temp file content.
     QPushButton *tempPasteButton;      ///< Button to paste into temp file editor.
+    QPushButton *tempRestoreButton;    ///< Button to restore a temp file from a backup.
     QPushButton *tempClearButton;      ///< Button to clear temp folder.
 
     QListWidget *projectsList;         ///< List widget for projects.
@@ -395,6 +512,19 @@ private:
     QAction *actSaveNewAs;             ///< Action to save new file as.
     QAction *actCompile;               ///< Action to compile code.
     QAction *actOverwriteWarn;         ///< Action to toggle overwrite warning.
+    QAction *actIgnoreBlankLines;      ///< Compare ignores blank lines.
+    QAction *actIgnoreSemicolons;      ///< Compare ignores trailing semicolons.
+    QAction *actIgnoreComments;        ///< Compare ignores comment-only changes.
+    QAction *actCancelCompare;         ///< Action to cancel a running comparison.
+    QAction *actProfilePhases;         ///< Toggles phase timing (Profiler).
+    QAction *actSaveTrace;             ///< Saves the recorded phases as a trace.
+    QAction *actIncrementalLoad;       ///< Load syncs Temp in place (TempSync).
+    QAction *actLinkTemp;              ///< Load links files into Temp (copy on write).
+    CompareJob *compareJob;            ///< Running comparison, or nullptr.
+    QProgressBar *compareProgress;     ///< Status bar progress of compareJob.
+    CopyJob *copyJob;                  ///< Running project load copy, or nullptr.
+    QProgressBar *copyProgress;        ///< Status bar progress of copyJob.
+    QString compareFileName;           ///< File name on the Diff tab and in saved diffs.
 
     Settings* appSettings;             ///< Persistent settings storage.
     bool overwriteWarn;                ///< Flag for overwrite warning.
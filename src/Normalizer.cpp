@@ -0,0 +1,322 @@
+/******************************************************************************
+ * @file Normalizer.cpp
+ * @brief Implements the single-pass code normalizer used by CompareEngine.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * A small state machine over the characters: code, literals (copied
+ * verbatim via CppLexer's skip helpers) and comments. Whitespace, line
+ * breaks and a trailing ';' are held back until the next character shows
+ * whether they survive, so nothing written is ever taken back and the
+ * output is never longer than the input.
+ ******************************************************************************/
+
+#include "Normalizer.h"
+#include "CppLexer.h"
+
+/******************************************************************************
+ * @brief Writes normalized text into a buffer sized to the input.
+ ******************************************************************************/
+struct StringSink
+{
+    QChar *out;      /**< Start of the buffer */
+    int length = 0;  /**< Characters written */
+
+    void put(QChar c) { out[length++] = c; }
+};
+
+/******************************************************************************
+ * @brief Hashes normalized text (FNV-1a 64) instead of storing it.
+ ******************************************************************************/
+struct HashSink
+{
+    quint64 hash = 14695981039346656037ull; /**< Running hash */
+
+    void put(QChar c) { hash = (hash ^ c.unicode()) * 1099511628211ull; }
+};
+
+/******************************************************************************
+ * @brief Returns true if c can continue an identifier or number.
+ ******************************************************************************/
+static bool isIdentifierChar(QChar c)
+{
+    return c.isLetterOrNumber() || c == QLatin1Char('_') || c == QLatin1Char('$');
+}
+
+/******************************************************************************
+ * @brief Returns true for '{' and '}'.
+ ******************************************************************************/
+static bool isBrace(QChar c)
+{
+    return c == QLatin1Char('{') || c == QLatin1Char('}');
+}
+
+/******************************************************************************
+ * @brief Returns true if the '"' at pos opens a raw string, i.e. the word
+ *        before it is R, u8R, uR, UR or LR.
+ ******************************************************************************/
+static bool opensRawString(QStringView text, int pos)
+{
+    if (pos < 1 || text.at(pos - 1) != QLatin1Char('R'))
+    {
+        return false;
+    }
+    int start = pos - 1;
+    while (start > 0 && isIdentifierChar(text.at(start - 1)) && pos - start < 3)
+    {
+        --start;
+    }
+    if (start > 0 && isIdentifierChar(text.at(start - 1)))
+    {
+        return false;
+    }
+    const QStringView word = text.mid(start, pos - start);
+    return word == u"R" || word == u"u8R" || word == u"uR" || word == u"UR" || word == u"LR";
+}
+
+/******************************************************************************
+ * @brief Normalizes text for one flag combination in one pass. Runs of
+ *        whitespace become one space, dropped at line ends and next to
+ *        braces; literals are copied verbatim. Without JoinLines the
+ *        line structure is kept, with leading and trailing blank lines
+ *        trimmed.
+ * @param text Raw text.
+ * @param sink Receives the normalized characters.
+ ******************************************************************************/
+template<unsigned Flags, class Sink>
+void Normalizer::scan(QStringView text, Sink &sink)
+{
+    constexpr bool joinLines = (Flags & JoinLines) != 0;
+    constexpr bool skipBlankLines = (Flags & IgnoreBlankLines) != 0;
+    constexpr bool dropSemicolons = (Flags & IgnoreTrailingSemicolons) != 0;
+    constexpr bool dropComments = (Flags & IgnoreCommentOnlyChanges) != 0;
+
+    const int n = int(text.size());
+    QChar last;                  // Last character written on this line, null at line start
+    bool space = false;          // Whitespace since last
+    bool written = false;        // Anything written at all
+    int newlines = 0;            // Line breaks held back until more text follows
+    bool semicolon = false;      // A ';' held back until the line goes on
+    bool semicolonSpace = false; // Whitespace before the held ';'
+    bool lineEmpty = true;       // Nothing written or held since the last line break
+    bool lineComment = false;    // A comment was dropped on this line
+    bool number = false;         // Inside a numeric literal, where ' is a separator
+
+    // Held-back text goes out in source order: line breaks, then ';'
+    auto release = [&]()
+    {
+        if (!joinLines && newlines > 0)
+        {
+            const int breaks = skipBlankLines ? 1 : newlines;
+            for (int k = 0; k < breaks && written; ++k)
+            {
+                sink.put(QLatin1Char('\n'));
+            }
+            newlines = 0;
+            last = QChar();
+        }
+        if (dropSemicolons && semicolon)
+        {
+            if (semicolonSpace && !last.isNull() && !isBrace(last))
+            {
+                sink.put(QLatin1Char(' '));
+            }
+            sink.put(QLatin1Char(';'));
+            last = QLatin1Char(';');
+            written = true;
+            semicolon = false;
+        }
+    };
+    auto put = [&](QChar c, bool code)
+    {
+        release();
+        if (space && !last.isNull() && !isBrace(last) && !(code && isBrace(c)))
+        {
+            sink.put(QLatin1Char(' '));
+        }
+        space = false;
+        sink.put(c);
+        last = c;
+        written = true;
+        lineEmpty = false;
+    };
+    // Copies [from, to) verbatim
+    auto copy = [&](int from, int to)
+    {
+        for (int k = from; k < to; ++k)
+        {
+            put(text.at(k), false);
+        }
+    };
+
+    int pos = 0;
+    while (pos < n)
+    {
+        const QChar c = text.at(pos);
+        const QChar next = (pos + 1 < n) ? text.at(pos + 1) : QChar();
+        if (c == QLatin1Char('\n'))
+        {
+            semicolon = false; // It ended the line
+            if (joinLines)
+            {
+                space = true;
+            }
+            else if (!(dropComments && lineEmpty && lineComment))
+            {
+                ++newlines;
+            }
+            lineEmpty = true;
+            lineComment = false;
+            number = false;
+            ++pos;
+            continue;
+        }
+        if (c.isSpace())
+        {
+            space = true;
+            number = false;
+            ++pos;
+            continue;
+        }
+        if (c == QLatin1Char('/') && (next == QLatin1Char('/') || next == QLatin1Char('*')))
+        {
+            int end = pos + 2;
+            if (next == QLatin1Char('/'))
+            {
+                while (end < n && text.at(end) != QLatin1Char('\n'))
+                {
+                    ++end;
+                }
+            }
+            else
+            {
+                const qsizetype close = text.indexOf(QLatin1String("*/"), pos + 2);
+                end = (close < 0) ? n : int(close) + 2;
+            }
+            if (dropComments)
+            {
+                space = true;
+                lineComment = true;
+            }
+            else
+            {
+                int trimmed = end;
+                while (trimmed > pos + 2 && text.at(trimmed - 1).isSpace())
+                {
+                    --trimmed;
+                }
+                copy(pos, trimmed);
+            }
+            number = false;
+            pos = end;
+            continue;
+        }
+        if (c == QLatin1Char('"') || (c == QLatin1Char('\'') && !(number && isIdentifierChar(next))))
+        {
+            const int end = (c == QLatin1Char('"') && opensRawString(text, pos))
+                                ? CppLexer::skipRawString(text, pos)
+                                : CppLexer::skipQuoted(text, pos, c);
+            copy(pos, end);
+            number = false;
+            pos = end;
+            continue;
+        }
+        if (dropSemicolons && c == QLatin1Char(';'))
+        {
+            const bool gap = space;
+            release(); // The held ';' was not the last one on its line
+            semicolonSpace = gap;
+            space = false;
+            semicolon = true;
+            lineEmpty = false;
+            ++pos;
+            continue;
+        }
+        const QChar prev = (pos > 0) ? text.at(pos - 1) : QChar();
+        if (c.isDigit() && !isIdentifierChar(prev))
+        {
+            number = true;
+        }
+        else if (!isIdentifierChar(c) && c != QLatin1Char('.') && c != QLatin1Char('\''))
+        {
+            number = false;
+        }
+        if (c == QLatin1Char('}'))
+        {
+            semicolon = false; // It ended the block
+        }
+        put(c, true);
+        ++pos;
+    }
+}
+
+/******************************************************************************
+ * @brief Calls scan<Flags> for the run-time flags value. Each step of the
+ *        recursion is one comparison, resolved at compile time into a
+ *        chain over all AllFlags + 1 specializations.
+ ******************************************************************************/
+template<class Sink, unsigned Flags>
+void Normalizer::dispatch(QStringView text, unsigned flags, Sink &sink)
+{
+    if constexpr (Flags == AllFlags)
+    {
+        scan<AllFlags>(text, sink);
+    }
+    else
+    {
+        if (flags == Flags)
+        {
+            scan<Flags>(text, sink);
+        }
+        else
+        {
+            dispatch<Sink, Flags + 1>(text, flags, sink);
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief Normalizes text.
+ * @param text Raw text.
+ * @param flags Combination of Flag values.
+ * @return Normalized text.
+ ******************************************************************************/
+QString Normalizer::normalize(QStringView text, unsigned flags)
+{
+    QString out;
+    normalizeInto(text, flags, out);
+    return out;
+}
+
+/******************************************************************************
+ * @brief Normalizes text into out, reusing its capacity. The result is
+ *        never longer than text, so out is sized once and trimmed after.
+ * @param text Raw text.
+ * @param flags Combination of Flag values.
+ * @param out Receives the normalized text.
+ ******************************************************************************/
+void Normalizer::normalizeInto(QStringView text, unsigned flags, QString &out)
+{
+    out.resize(text.size());
+    StringSink sink{ out.data() };
+    dispatch(text, flags & AllFlags, sink);
+    out.resize(sink.length);
+}
+
+/******************************************************************************
+ * @brief Hashes the normalized text without building it.
+ * @param text Raw text.
+ * @param flags Combination of Flag values.
+ * @return FNV-1a 64 of the normalized text.
+ ******************************************************************************/
+quint64 Normalizer::fingerprint(QStringView text, unsigned flags)
+{
+    HashSink sink;
+    dispatch(text, flags & AllFlags, sink);
+    return sink.hash;
+}
+
+/*************** End of Normalizer.cpp ***************************************/
@@ -0,0 +1,82 @@
+/******************************************************************************
+ * @file Normalizer.h
+ * @brief Declares the single-pass code normalizer used by CompareEngine.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Collapses whitespace, trims lines and tightens braces in one linear
+ * scan, leaving string, char and raw string literals untouched. The
+ * policy flags are template parameters of the scan, so every flag
+ * combination compiles to its own loop; the public functions pick the
+ * specialization at run time. The same scan either writes the result
+ * into a preallocated buffer or hashes it without building it.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QString>
+#include <QStringView>
+
+/******************************************************************************
+ * @class Normalizer
+ * @brief Stateless whitespace/brace normalizer with policy flags.
+ ******************************************************************************/
+class Normalizer
+{
+public:
+    /**************************************************************************
+     * @enum Flag
+     * @brief Normalization policies, combined with |.
+     *************************************************************************/
+    enum Flag : unsigned
+    {
+        NoFlags = 0x0,                  /**< Per line: collapse, trim, tighten braces */
+        JoinLines = 0x1,                /**< Newlines are whitespace: one-line result */
+        IgnoreBlankLines = 0x2,         /**< Drop lines that are empty after normalizing */
+        IgnoreTrailingSemicolons = 0x4, /**< Drop a ';' that ends a line or block */
+        IgnoreCommentOnlyChanges = 0x8, /**< Drop comments, so edits in them do not count */
+        AllFlags = 0xF                  /**< Mask of all policies */
+    };
+
+    /**************************************************************************
+     * @brief Normalizes text.
+     * @param text Raw text.
+     * @param flags Combination of Flag values.
+     * @return Normalized text.
+     *************************************************************************/
+    static QString normalize(QStringView text, unsigned flags);
+
+    /**************************************************************************
+     * @brief Normalizes text into out, reusing its capacity.
+     * @param text Raw text.
+     * @param flags Combination of Flag values.
+     * @param out Receives the normalized text.
+     *************************************************************************/
+    static void normalizeInto(QStringView text, unsigned flags, QString &out);
+
+    /**************************************************************************
+     * @brief Hashes the normalized text without building it.
+     * @param text Raw text.
+     * @param flags Combination of Flag values.
+     * @return FNV-1a 64 of the normalized text.
+     *************************************************************************/
+    static quint64 fingerprint(QStringView text, unsigned flags);
+
+private:
+    /**************************************************************************
+     * @brief The normalizing scan for one flag combination.
+     *************************************************************************/
+    template<unsigned Flags, class Sink>
+    static void scan(QStringView text, Sink &sink);
+
+    /**************************************************************************
+     * @brief Calls scan<Flags> for the run-time flags value.
+     *************************************************************************/
+    template<class Sink, unsigned Flags = 0>
+    static void dispatch(QStringView text, unsigned flags, Sink &sink);
+};
+
+/*************** End of Normalizer.h *****************************************/
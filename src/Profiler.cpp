@@ -0,0 +1,251 @@
+/******************************************************************************
+ * @file Profiler.cpp
+ * @brief Implements the Profiler and ScopedTimer classes.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * One mutex guards the totals and the event list; it is taken once per
+ * finished scope and only while the Profiler is enabled. Totals are kept
+ * per name pointer and merged by text in phases(), since the same
+ * literal may have several addresses across translation units.
+ ******************************************************************************/
+
+#include "Profiler.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QStringList>
+#include <QThread>
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+/******************************************************************************
+ * @struct TraceEvent
+ * @brief One finished scope.
+ ******************************************************************************/
+struct TraceEvent
+{
+    const char *name; ///< Phase name
+    int thread;       ///< Small thread number, 1 for the first thread seen
+    qint64 start;     ///< Profiler::now() at the start
+    qint64 nsecs;     ///< Duration
+};
+
+/******************************************************************************
+ * @struct Totals
+ * @brief Summed time of one name pointer.
+ ******************************************************************************/
+struct Totals
+{
+    qint64 nsecs = 0;
+    int calls = 0;
+};
+
+std::atomic<bool> profilerEnabled(false);
+QMutex profilerMutex;
+QHash<const char *, Totals> profilerTotals;
+QVector<TraceEvent> profilerEvents;
+QHash<quintptr, int> profilerThreads;
+
+/******************************************************************************
+ * @brief Appends @p text to @p out as a JSON string.
+ ******************************************************************************/
+void appendJsonString(QByteArray &out, const char *text)
+{
+    out += '"';
+    for (const char *p = text; *p; ++p)
+    {
+        if (*p == '"' || *p == '\\')
+        {
+            out += '\\';
+        }
+        out += *p;
+    }
+    out += '"';
+}
+} // namespace
+
+/******************************************************************************
+ * @brief Turns recording on or off.
+ ******************************************************************************/
+void Profiler::setEnabled(bool enabled)
+{
+    profilerEnabled.store(enabled, std::memory_order_relaxed);
+}
+
+/******************************************************************************
+ * @brief Returns true while timers record.
+ ******************************************************************************/
+bool Profiler::isEnabled()
+{
+    return profilerEnabled.load(std::memory_order_relaxed);
+}
+
+/******************************************************************************
+ * @brief Forgets every total and trace event.
+ ******************************************************************************/
+void Profiler::reset()
+{
+    QMutexLocker lock(&profilerMutex);
+    profilerTotals.clear();
+    profilerEvents.clear();
+    profilerThreads.clear();
+}
+
+/******************************************************************************
+ * @brief Returns nanoseconds since the first call.
+ ******************************************************************************/
+qint64 Profiler::now()
+{
+    static const QElapsedTimer clock = []()
+    {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed();
+}
+
+/******************************************************************************
+ * @brief Records one finished scope of the calling thread.
+ ******************************************************************************/
+void Profiler::record(const char *name, qint64 startNsecs, qint64 nsecs)
+{
+    const quintptr threadId = quintptr(QThread::currentThreadId());
+    QMutexLocker lock(&profilerMutex);
+    Totals &totals = profilerTotals[name];
+    totals.nsecs += nsecs;
+    ++totals.calls;
+    if (profilerEvents.size() < MaxTraceEvents)
+    {
+        int thread = profilerThreads.value(threadId);
+        if (thread == 0)
+        {
+            thread = int(profilerThreads.size()) + 1;
+            profilerThreads.insert(threadId, thread);
+        }
+        profilerEvents.append(TraceEvent{ name, thread, startNsecs, nsecs });
+    }
+}
+
+/******************************************************************************
+ * @brief Returns the phase totals, slowest first.
+ ******************************************************************************/
+QVector<Profiler::Phase> Profiler::phases()
+{
+    QHash<QString, Phase> byName;
+    {
+        QMutexLocker lock(&profilerMutex);
+        for (auto it = profilerTotals.constBegin(); it != profilerTotals.constEnd(); ++it)
+        {
+            Phase &phase = byName[QString::fromUtf8(it.key())];
+            phase.nsecs += it.value().nsecs;
+            phase.calls += it.value().calls;
+        }
+    }
+    QVector<Phase> result;
+    result.reserve(byName.size());
+    for (auto it = byName.constBegin(); it != byName.constEnd(); ++it)
+    {
+        Phase phase = it.value();
+        phase.name = it.key();
+        result.append(phase);
+    }
+    std::sort(result.begin(), result.end(), [](const Phase &a, const Phase &b)
+              {
+                  return a.nsecs != b.nsecs ? a.nsecs > b.nsecs : a.name < b.name;
+              });
+    return result;
+}
+
+/******************************************************************************
+ * @brief Formats the slowest phases for a status bar.
+ ******************************************************************************/
+QString Profiler::summary(int maxPhases)
+{
+    const QVector<Phase> all = phases();
+    QStringList parts;
+    for (int i = 0; i < all.size() && i < maxPhases; ++i)
+    {
+        QString part = QString("%1 %2 ms").arg(all.at(i).name).arg(double(all.at(i).nsecs) / 1e6, 0, 'f', 1);
+        if (all.at(i).calls > 1)
+        {
+            part += QString(" (%1x)").arg(all.at(i).calls);
+        }
+        parts << part;
+    }
+    return parts.join(", ");
+}
+
+/******************************************************************************
+ * @brief Returns the trace events in Chrome trace event format: complete
+ *        ("X") events with microsecond timestamps, one track per thread.
+ ******************************************************************************/
+QByteArray Profiler::traceJson()
+{
+    QVector<TraceEvent> events;
+    {
+        QMutexLocker lock(&profilerMutex);
+        events = profilerEvents;
+    }
+    QByteArray out;
+    out.reserve(int(events.size()) * 96 + 64);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (int i = 0; i < events.size(); ++i)
+    {
+        const TraceEvent &event = events.at(i);
+        out += i == 0 ? "\n" : ",\n";
+        out += "{\"name\":";
+        appendJsonString(out, event.name);
+        out += ",\"cat\":\"diffcheck\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+        out += QByteArray::number(event.thread);
+        out += ",\"ts\":";
+        out += QByteArray::number(double(event.start) / 1000.0, 'f', 3);
+        out += ",\"dur\":";
+        out += QByteArray::number(double(event.nsecs) / 1000.0, 'f', 3);
+        out += '}';
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+/******************************************************************************
+ * @brief Writes traceJson() to @p path.
+ ******************************************************************************/
+bool Profiler::writeTrace(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+    return file.write(traceJson()) >= 0;
+}
+
+/******************************************************************************
+ * @brief Starts timing if the Profiler is enabled.
+ ******************************************************************************/
+ScopedTimer::ScopedTimer(const char *name)
+    : m_name(Profiler::isEnabled() ? name : nullptr)
+    , m_start(m_name ? Profiler::now() : 0)
+{
+}
+
+/******************************************************************************
+ * @brief Records the scope.
+ ******************************************************************************/
+ScopedTimer::~ScopedTimer()
+{
+    if (m_name)
+    {
+        Profiler::record(m_name, m_start, Profiler::now() - m_start);
+    }
+}
+
+/*************** End of Profiler.cpp *****************************************/
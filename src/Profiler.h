@@ -0,0 +1,126 @@
+/******************************************************************************
+ * @file Profiler.h
+ * @brief Declares the Profiler and ScopedTimer classes for phase timing.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * PROFILE_SCOPE("name") from Config.h puts a ScopedTimer on the stack;
+ * when the Profiler is enabled it adds the scope's time to the phase
+ * "name" and keeps one trace event per scope, which writeTrace saves as
+ * chrome://tracing / Perfetto JSON. Disabled, a timer costs one atomic
+ * load; built with SHOW_PROFILE 0 it is not compiled at all.
+ *
+ * Phase names must be string literals: they are stored by pointer.
+ * Times are inclusive, so nested phases overlap, and phases that run on
+ * several threads can add up to more than the wall time.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+
+/******************************************************************************
+ * @class Profiler
+ * @brief Process-wide store of phase totals and trace events.
+ ******************************************************************************/
+class Profiler
+{
+public:
+    /**************************************************************************
+     * @struct Phase
+     * @brief Total time of one phase name.
+     *************************************************************************/
+    struct Phase
+    {
+        QString name;     /**< Name given to PROFILE_SCOPE */
+        qint64 nsecs = 0; /**< Summed duration of every scope */
+        int calls = 0;    /**< Number of scopes */
+    };
+
+    static constexpr int MaxTraceEvents = 1 << 20; ///< Later events only add to the totals
+
+    /**************************************************************************
+     * @brief Turns recording on or off; timers already running still finish.
+     *************************************************************************/
+    static void setEnabled(bool enabled);
+
+    /**************************************************************************
+     * @brief Returns true while timers record.
+     *************************************************************************/
+    static bool isEnabled();
+
+    /**************************************************************************
+     * @brief Forgets every total and trace event.
+     *************************************************************************/
+    static void reset();
+
+    /**************************************************************************
+     * @brief Returns nanoseconds since the first call, the trace time base.
+     *************************************************************************/
+    static qint64 now();
+
+    /**************************************************************************
+     * @brief Records one finished scope of the calling thread.
+     * @param name Phase name; a string literal.
+     * @param startNsecs now() when the scope began.
+     * @param nsecs Duration.
+     *************************************************************************/
+    static void record(const char *name, qint64 startNsecs, qint64 nsecs);
+
+    /**************************************************************************
+     * @brief Returns the phase totals, slowest first.
+     *************************************************************************/
+    static QVector<Phase> phases();
+
+    /**************************************************************************
+     * @brief Formats the slowest phases for a status bar, e.g.
+     *        "extractFunctions 41.2 ms, diffLines 12.0 ms (37x)".
+     * @param maxPhases Number of phases to list.
+     * @return The breakdown, or an empty string if nothing was recorded.
+     *************************************************************************/
+    static QString summary(int maxPhases = 4);
+
+    /**************************************************************************
+     * @brief Returns the trace events in Chrome trace event format.
+     *************************************************************************/
+    static QByteArray traceJson();
+
+    /**************************************************************************
+     * @brief Writes traceJson() to @p path.
+     * @return False if the file cannot be written.
+     *************************************************************************/
+    static bool writeTrace(const QString &path);
+};
+
+/******************************************************************************
+ * @class ScopedTimer
+ * @brief Records the time between its construction and destruction.
+ ******************************************************************************/
+class ScopedTimer
+{
+public:
+    /**************************************************************************
+     * @brief Starts timing if the Profiler is enabled.
+     * @param name Phase name; a string literal.
+     *************************************************************************/
+    explicit ScopedTimer(const char *name);
+
+    /**************************************************************************
+     * @brief Records the scope.
+     *************************************************************************/
+    ~ScopedTimer();
+
+    ScopedTimer(const ScopedTimer &) = delete;
+    ScopedTimer &operator=(const ScopedTimer &) = delete;
+
+private:
+    const char *m_name; ///< Phase name, or nullptr when not recording
+    qint64 m_start;     ///< Profiler::now() at construction
+};
+
+/*************** End of Profiler.h *******************************************/
@@ -0,0 +1,370 @@
+/******************************************************************************
+ * @file TempSync.cpp
+ * @brief Implements the TempSync class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.4
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * The manifest only caches hashes: every decision is made against the
+ * Temp file as it is now, so a stale or missing manifest costs hashing
+ * time, never a wrong result. When two files differ only in time, the
+ * Temp copy is given the project time, so the next sync takes the
+ * size-and-time shortcut. A chmod leaves the time alone, so the modes
+ * are compared too, and an unchanged file with another mode gets the
+ * project permissions in place.
+ ******************************************************************************/
+
+#include "TempSync.h"
+#include "Config.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <algorithm>
+
+namespace
+{
+/******************************************************************************
+ * @brief Returns the manifest hash of @p file if the manifest saw it with
+ *        the same size and time, else an empty array.
+ ******************************************************************************/
+QByteArray cachedHash(const QHash<QString, SyncEntry> &manifest, const SyncFile &file)
+{
+    const auto it = manifest.constFind(file.relative);
+    if (it == manifest.constEnd() || it->size != file.size || it->mtime != file.mtime)
+    {
+        return QByteArray();
+    }
+    return it->hash;
+}
+
+/******************************************************************************
+ * @brief Returns the POSIX permission bits of @p permissions. The owner
+ *        bits stand for the user bits, which Qt reports for the caller.
+ ******************************************************************************/
+quint32 modeOf(QFileDevice::Permissions permissions)
+{
+    const quint32 bits = quint32(permissions);
+    return ((bits >> 12) & 07) << 6 | ((bits >> 4) & 07) << 3 | (bits & 07);
+}
+} // namespace
+
+/******************************************************************************
+ * @brief Returns the manifest file name.
+ ******************************************************************************/
+QString TempSync::manifestName()
+{
+    return QString(".diffcheck-sync.json");
+}
+
+/******************************************************************************
+ * @brief Lists the files and folders below a root with the filter
+ *        CopyJob::plan uses.
+ ******************************************************************************/
+void TempSync::walk(const QString &root, const QStringList &skipNames, QVector<SyncFile> &files,
+                    QStringList &folders, QStringList &errors)
+{
+    QSet<QString> walked;
+    QStringList stack(QString(""));
+    while (!stack.isEmpty())
+    {
+        const QString relative = stack.takeLast();
+        const QString folder = relative.isEmpty() ? root : root + "/" + relative;
+        const QString canonical = QFileInfo(folder).canonicalFilePath();
+        if (walked.contains(canonical))
+        {
+            continue;
+        }
+        walked.insert(canonical);
+        const QDir dir(folder);
+        if (!dir.exists())
+        {
+            errors << QString("Cannot read folder %1").arg(folder);
+            continue;
+        }
+        const QFileInfoList entries = dir.entryInfoList(QDir::NoDotAndDotDot | QDir::AllEntries, QDir::Name);
+        for (int i = 0; i < entries.size(); ++i)
+        {
+            const QFileInfo &entry = entries.at(i);
+            if (relative.isEmpty() && skipNames.contains(entry.fileName()))
+            {
+                continue;
+            }
+            const QString entryRelative = relative.isEmpty() ? entry.fileName() : relative + "/" + entry.fileName();
+            if (entry.isDir())
+            {
+                folders << entryRelative;
+                stack << entryRelative;
+            }
+            else
+            {
+                files.append(SyncFile{ entryRelative, entry.absoluteFilePath(), entry.size(),
+                                       entry.lastModified().toMSecsSinceEpoch(), modeOf(entry.permissions()) });
+            }
+        }
+    }
+}
+
+/******************************************************************************
+ * @brief Hashes a file's content.
+ ******************************************************************************/
+QByteArray TempSync::hashFile(const QString &path)
+{
+    PROFILE_SCOPE("hashFile");
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QByteArray();
+    }
+    QCryptographicHash hash(QCryptographicHash::Blake2b_256);
+    if (!hash.addData(&file))
+    {
+        return QByteArray();
+    }
+    return hash.result().toHex();
+}
+
+/******************************************************************************
+ * @brief Reads a manifest: {"version":1,"files":{"rel":{"size","mtime","mode","hash"}}}.
+ *        A manifest written before modes were kept reads as mode 0.
+ ******************************************************************************/
+QHash<QString, SyncEntry> TempSync::readManifest(const QString &path)
+{
+    QHash<QString, SyncEntry> entries;
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return entries;
+    }
+    const QJsonObject root = QJsonDocument::fromJson(file.readAll()).object();
+    if (root.value("version").toInt() != 1)
+    {
+        return entries;
+    }
+    const QJsonObject files = root.value("files").toObject();
+    entries.reserve(files.size());
+    for (auto it = files.constBegin(); it != files.constEnd(); ++it)
+    {
+        const QJsonObject value = it.value().toObject();
+        SyncEntry entry;
+        entry.size = qint64(value.value("size").toDouble());
+        entry.mtime = qint64(value.value("mtime").toDouble());
+        entry.mode = quint32(value.value("mode").toInt());
+        entry.hash = value.value("hash").toString().toLatin1();
+        entries.insert(it.key(), entry);
+    }
+    return entries;
+}
+
+/******************************************************************************
+ * @brief Writes a manifest.
+ ******************************************************************************/
+bool TempSync::writeManifest(const QString &path, const QHash<QString, SyncEntry> &entries)
+{
+    QJsonObject files;
+    for (auto it = entries.constBegin(); it != entries.constEnd(); ++it)
+    {
+        QJsonObject value;
+        value.insert("size", double(it->size));
+        value.insert("mtime", double(it->mtime));
+        value.insert("mode", int(it->mode));
+        value.insert("hash", QString::fromLatin1(it->hash));
+        files.insert(it.key(), value);
+    }
+    QJsonObject root;
+    root.insert("version", 1);
+    root.insert("files", files);
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+    return file.write(QJsonDocument(root).toJson(QJsonDocument::Compact)) >= 0;
+}
+
+/******************************************************************************
+ * @brief Brings the Temp folders in line with the project and lists the
+ *        files to copy.
+ ******************************************************************************/
+CopyPlan TempSync::plan(const QString &sourceDir, const QString &targetDir, const QString &backupDir,
+                        const QStringList &skipNames)
+{
+    PROFILE_SCOPE("sync plan");
+    CopyPlan result;
+    if (!QFileInfo(sourceDir).isDir())
+    {
+        result.errors << QString("Cannot read folder %1").arg(sourceDir);
+        return result;
+    }
+    if (!QDir().mkpath(targetDir))
+    {
+        result.errors << QString("Cannot create folder %1").arg(targetDir);
+        return result;
+    }
+
+    QVector<SyncFile> sourceFiles;
+    QVector<SyncFile> targetFiles;
+    QStringList sourceFolders;
+    QStringList targetFolders;
+    walk(sourceDir, skipNames, sourceFiles, sourceFolders, result.errors);
+    walk(targetDir, skipNames, targetFiles, targetFolders, result.errors);
+    QHash<QString, int> targetIndex;
+    targetIndex.reserve(targetFiles.size());
+    for (int i = 0; i < targetFiles.size(); ++i)
+    {
+        targetIndex.insert(targetFiles.at(i).relative, i);
+    }
+
+    const QString manifestPath = targetDir + "/" + manifestName();
+    const QHash<QString, SyncEntry> manifest = readManifest(manifestPath);
+    QHash<QString, SyncEntry> synced;
+    synced.reserve(sourceFiles.size());
+
+    // Saves the Temp file before it is overwritten or removed
+    auto backup = [&](const QString &relative)
+    {
+        if (backupDir.isEmpty())
+        {
+            return true;
+        }
+        const QString target = backupDir + "/" + relative;
+        QString error;
+        if (!QDir().mkpath(QFileInfo(target).absolutePath()))
+        {
+            error = QString("Cannot create folder %1").arg(QFileInfo(target).absolutePath());
+        }
+        else
+        {
+            error = CopyJob::copyFile(targetDir + "/" + relative, target);
+        }
+        if (!error.isEmpty())
+        {
+            result.errors << QString("Not backed up, left as it was: %1").arg(error);
+            return false;
+        }
+        return true;
+    };
+
+    // Folders first, so every copy has somewhere to go
+    const QSet<QString> targetFolderSet(targetFolders.begin(), targetFolders.end());
+    for (int i = 0; i < sourceFolders.size(); ++i)
+    {
+        if (!targetFolderSet.contains(sourceFolders.at(i)) && !QDir().mkpath(targetDir + "/" + sourceFolders.at(i)))
+        {
+            result.errors << QString("Cannot create folder %1").arg(targetDir + "/" + sourceFolders.at(i));
+        }
+    }
+
+    QSet<QString> sourceNames;
+    sourceNames.reserve(sourceFiles.size());
+    for (int i = 0; i < sourceFiles.size(); ++i)
+    {
+        const SyncFile &source = sourceFiles.at(i);
+        sourceNames.insert(source.relative);
+        SyncEntry entry;
+        entry.size = source.size;
+        entry.mtime = source.mtime;
+        entry.mode = source.mode;
+        bool changed = true;
+        const int t = targetIndex.value(source.relative, -1);
+        if (t >= 0)
+        {
+            const SyncFile &target = targetFiles.at(t);
+            if (target.size == source.size && target.mtime == source.mtime)
+            {
+                changed = false;
+                entry.hash = cachedHash(manifest, source);
+            }
+            else if (target.size == source.size)
+            {
+                entry.hash = cachedHash(manifest, source);
+                if (entry.hash.isEmpty())
+                {
+                    entry.hash = hashFile(source.path);
+                }
+                QByteArray targetHash = cachedHash(manifest, target);
+                if (targetHash.isEmpty())
+                {
+                    targetHash = hashFile(target.path);
+                }
+                changed = entry.hash.isEmpty() || entry.hash != targetHash;
+                if (!changed)
+                {
+                    QFile file(target.path);
+                    if (file.open(QIODevice::Append))
+                    {
+                        file.setFileTime(QDateTime::fromMSecsSinceEpoch(source.mtime), QFileDevice::FileModificationTime);
+                    }
+                }
+            }
+            if (!changed && target.mode != source.mode
+                && !QFile::setPermissions(target.path, QFile::permissions(source.path)))
+            {
+                changed = true; // The copy brings the mode along
+            }
+            if (changed && !backup(source.relative))
+            {
+                continue;
+            }
+        }
+        if (changed)
+        {
+            CopyItem item;
+            item.source = source.path;
+            item.target = targetDir + "/" + source.relative;
+            item.size = source.size;
+            result.bytes += item.size;
+            result.files << item;
+        }
+        else
+        {
+            ++result.unchanged;
+        }
+        synced.insert(source.relative, entry);
+    }
+
+    // Files and then folders that are no longer in the project
+    for (int i = 0; i < targetFiles.size(); ++i)
+    {
+        const SyncFile &target = targetFiles.at(i);
+        if (sourceNames.contains(target.relative) || !backup(target.relative))
+        {
+            continue;
+        }
+        if (QFile::remove(target.path))
+        {
+            ++result.removed;
+        }
+        else
+        {
+            result.errors << QString("Cannot remove %1").arg(target.path);
+        }
+    }
+    const QSet<QString> sourceFolderSet(sourceFolders.begin(), sourceFolders.end());
+    std::sort(targetFolders.begin(), targetFolders.end(), [](const QString &a, const QString &b)
+              {
+                  return a.size() > b.size(); // Children before parents
+              });
+    for (int i = 0; i < targetFolders.size(); ++i)
+    {
+        // rmdir keeps a folder that still holds hidden or unsaved files
+        if (!sourceFolderSet.contains(targetFolders.at(i)) && QDir(targetDir).rmdir(targetFolders.at(i)))
+        {
+            ++result.removed;
+        }
+    }
+
+    if (!writeManifest(manifestPath, synced))
+    {
+        result.errors << QString("Cannot write %1").arg(manifestPath);
+    }
+    return result;
+}
+
+/*************** End of TempSync.cpp *****************************************/
@@ -0,0 +1,124 @@
+/******************************************************************************
+ * @file TempSync.h
+ * @brief Declares the TempSync class that brings Temp up to date in place.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.3
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * An incremental alternative to delete-and-recopy for project load.
+ * plan() compares every project file with its Temp copy: a different
+ * size means changed, the same size and modification time unchanged,
+ * and otherwise the content hashes decide. Hashes are kept in a
+ * manifest in the Temp root, so a file that was only touched is read
+ * once, not on every load. Only changed files are copied (by CopyJob);
+ * Temp files that vanished from the project are removed, and every
+ * file about to be overwritten or removed is first copied to the
+ * backup folder. The top-level build folder is never looked at.
+ ******************************************************************************/
+
+#pragma once
+
+#include "CopyJob.h"
+#include <QByteArray>
+#include <QHash>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+/******************************************************************************
+ * @struct SyncEntry
+ * @brief What the last sync knew about one file.
+ ******************************************************************************/
+struct SyncEntry
+{
+    qint64 size = 0;  /**< Size in bytes */
+    qint64 mtime = 0; /**< Modification time, ms since the epoch */
+    quint32 mode = 0; /**< Permission bits as in st_mode & 0777; 0 if not recorded */
+    QByteArray hash;  /**< TempSync::hashFile of the content; empty if never hashed */
+};
+
+/******************************************************************************
+ * @struct SyncFile
+ * @brief One file found by TempSync::walk.
+ ******************************************************************************/
+struct SyncFile
+{
+    QString relative; /**< Path below the walked root */
+    QString path;     /**< Absolute path */
+    qint64 size;      /**< Size in bytes */
+    qint64 mtime;     /**< Modification time, ms since the epoch */
+    quint32 mode;     /**< Permission bits as in st_mode & 0777 */
+};
+
+/******************************************************************************
+ * @class TempSync
+ * @brief Plans an incremental sync of a project into Temp.
+ ******************************************************************************/
+class TempSync
+{
+public:
+    /**************************************************************************
+     * @brief Returns the manifest file name, kept in the Temp root. It is
+     *        hidden, so tree walks and the Temp view leave it out.
+     *************************************************************************/
+    static QString manifestName();
+
+    /**************************************************************************
+     * @brief Lists the files and folders below @p root with the filter
+     *        CopyJob::plan uses: no hidden entries, and the top-level
+     *        @p skipNames left out; a folder reached twice through
+     *        symlinks is walked once.
+     * @param root Folder to walk.
+     * @param skipNames Top-level names to leave out.
+     * @param files Receives the files.
+     * @param folders Receives the folders, relative to @p root.
+     * @param errors Receives folders that cannot be read.
+     *************************************************************************/
+    static void walk(const QString &root, const QStringList &skipNames, QVector<SyncFile> &files,
+                     QStringList &folders, QStringList &errors);
+
+    /**************************************************************************
+     * @brief Hashes a file's content (BLAKE2b-256, hex).
+     * @param path File path.
+     * @return The hash, or an empty array if the file cannot be read.
+     *************************************************************************/
+    static QByteArray hashFile(const QString &path);
+
+    /**************************************************************************
+     * @brief Reads a manifest.
+     * @param path Manifest path.
+     * @return Entries by path relative to the synced root; empty if the
+     *         file is missing or unreadable.
+     *************************************************************************/
+    static QHash<QString, SyncEntry> readManifest(const QString &path);
+
+    /**************************************************************************
+     * @brief Writes a manifest.
+     * @param path Manifest path.
+     * @param entries Entries by relative path.
+     * @return False if the file cannot be written.
+     *************************************************************************/
+    static bool writeManifest(const QString &path, const QHash<QString, SyncEntry> &entries);
+
+    /**************************************************************************
+     * @brief Brings @p targetDir in line with @p sourceDir except for file
+     *        content: makes missing folders, backs up and removes vanished
+     *        files and folders, backs up the files that will be overwritten,
+     *        and writes the manifest. Run it on a worker thread, e.g. as a
+     *        CopyJob planner; the job then copies the returned files.
+     * @param sourceDir Project folder.
+     * @param targetDir Temp folder.
+     * @param backupDir Receives each overwritten or removed file at its
+     *        relative path, made only if needed; empty for no backup.
+     * @param skipNames Top-level names left alone on both sides.
+     * @return Changed files to copy, errors, and the unchanged and removed
+     *         counts. A file whose backup failed is neither copied nor
+     *         removed, and is reported.
+     *************************************************************************/
+    static CopyPlan plan(const QString &sourceDir, const QString &targetDir, const QString &backupDir,
+                         const QStringList &skipNames = QStringList("build"));
+};
+
+/*************** End of TempSync.h *******************************************/
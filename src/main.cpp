@@ -3,25 +3,38 @@
  * @brief Application entry point for CodeHelpAI.
  *
  * @author Jeffrey Scott Flesher with the help of AI: Copilot
- * @version 0.8
- * @date 2025-11-07
+ * @version 0.9
+ * @date 2026-10-16
  * @section License MIT
  * @section DESCRIPTION
  * Loads resources and translations, constructs MainWindow,
- * sets app icon and shows the window.
+ * sets app icon and shows the window. With --compare it runs
+ * CompareCli under a QCoreApplication instead: no widgets, no
+ * translations, and it exits as soon as the report is written.
  ******************************************************************************/
 
 #include <QApplication>
+#include <QCoreApplication>
 #include <QIcon>
 #include <QTranslator>
 #include <QLocale>
 #include <QDebug>
 //#define SHOW_DEBUG 1
 //#include "Config.h"
+#include "CompareCli.h"
 #include "MainWindow.h"
 
 int main(int argc, char *argv[])
 {
+    // Headless compare for scripts; decided before any GUI object exists
+    if (CompareCli::isCompareCommand(argc, argv))
+    {
+        QCoreApplication app(argc, argv);
+        QTextStream out(stdout);
+        QTextStream err(stderr);
+        return CompareCli::run(app.arguments(), out, err);
+    }
+
     #ifdef __MINGW32__
     // Force Qt 6 to use OpenGL instead of D3D12
     qputenv("QT_DEFAULT_RHI", "opengl");
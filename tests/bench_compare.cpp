@@ -0,0 +1,322 @@
+/****************************************************************
+ * @file    bench_compare.cpp
+ * @brief   Benchmarks the CompareEngine compare pipeline.
+ *
+ * @author  Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.5
+ * @date    2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * benchPhase times each step of a compare (stripComments,
+ * extractFunctions, normalizeBody, diffLines, buildSummary) on
+ * small, medium and huge CorpusGenerator files (seed 7, every
+ * mutation) and reports MB/s and lines/s. benchDiffLines diffs
+ * whole sources with every DiffAlgorithm and reports time and
+ * hunk count, so speed and readability of the output can be
+ * compared.
+ * Throughput can be checked against a baseline JSON file:
+ *   BENCH_SAVE_BASELINE=base.json bench_compare benchPhase
+ *   BENCH_BASELINE=base.json bench_compare benchPhase
+ * The second run fails every phase more than BENCH_TOLERANCE
+ * (default 0.15, i.e. 15%) slower than the baseline.
+ * Run: bench_compare [-iterations N] [function[:row]]
+ ***************************************************************/
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRandomGenerator>
+#include "CompareEngine.h"
+#include "CorpusGenerator.h"
+
+class BenchCompare : public QObject
+{
+    Q_OBJECT
+private:
+    /************************************************************
+     * @brief Builds a source of small functions with braces,
+     *        blank lines and repeated boilerplate.
+     * @param lines Approximate number of lines.
+     ***********************************************************/
+    static QStringList makeSource(int lines)
+    {
+        QStringList source;
+        int function = 0;
+        while (source.size() < lines)
+        {
+            source << QString("int function%1(int value)").arg(function);
+            source << "{";
+            source << "    int result = 0;";
+            for (int i = 0; i < 6; ++i)
+            {
+                source << QString("    result += value * %1 + %2;").arg(i).arg(function);
+            }
+            source << "    return result;";
+            source << "}";
+            source << "";
+            ++function;
+        }
+        return source;
+    }
+
+    /************************************************************
+     * @brief Applies deterministic edits: changed, deleted,
+     *        inserted lines and one moved function.
+     ***********************************************************/
+    static QStringList mutate(const QStringList &source)
+    {
+        QRandomGenerator random(42);
+        QStringList result = source;
+        const int edits = qMax(1, int(source.size() / 50));
+        for (int i = 0; i < edits; ++i)
+        {
+            const int at = random.bounded(int(result.size()));
+            switch (random.bounded(3))
+            {
+            case 0:
+                result[at] = QString("    result -= %1;").arg(i);
+                break;
+            case 1:
+                result.removeAt(at);
+                break;
+            default:
+                result.insert(at, "    log(result);");
+                break;
+            }
+        }
+        // Move the first function to the end
+        const int functionLines = 11;
+        if (result.size() > functionLines * 2)
+        {
+            const QStringList moved = result.mid(0, functionLines);
+            result.remove(0, functionLines);
+            result << moved;
+        }
+        return result;
+    }
+
+    /************************************************************
+     * @brief Logs the throughput of a phase, records it for
+     *        BENCH_SAVE_BASELINE and checks it against
+     *        BENCH_BASELINE.
+     * @param bytes UTF-8 bytes one iteration processes.
+     * @param lines Lines one iteration processes.
+     * @param nsecs Time of all iterations.
+     * @param iterations Number of iterations.
+     ***********************************************************/
+    void report(qint64 bytes, qint64 lines, qint64 nsecs, int iterations)
+    {
+        const double seconds = double(qMax<qint64>(nsecs, 1)) / 1e9 / qMax(iterations, 1);
+        const double mbPerSecond = double(bytes) / (1024.0 * 1024.0) / seconds;
+        const double linesPerSecond = double(lines) / seconds;
+        const QString tag = QString::fromUtf8(QTest::currentDataTag());
+        qInfo().noquote() << QString("%1: %2 MB/s, %3 lines/s")
+                                 .arg(tag)
+                                 .arg(mbPerSecond, 0, 'f', 1)
+                                 .arg(linesPerSecond, 0, 'f', 0);
+        m_results.insert(tag, mbPerSecond);
+        if (m_baseline.contains(tag))
+        {
+            const double expected = m_baseline.value(tag).toDouble();
+            QVERIFY2(mbPerSecond >= expected * (1.0 - m_tolerance),
+                     qPrintable(QString("%1 regressed: %2 MB/s, baseline %3 MB/s")
+                                    .arg(tag)
+                                    .arg(mbPerSecond, 0, 'f', 1)
+                                    .arg(expected, 0, 'f', 1)));
+        }
+    }
+
+    QJsonObject m_baseline;     ///< MB/s per data tag from BENCH_BASELINE
+    QJsonObject m_results;      ///< MB/s per data tag of this run
+    double m_tolerance = 0.15;  ///< Allowed slowdown against the baseline
+
+private slots:
+    void initTestCase()
+    {
+        const QString baselinePath = qEnvironmentVariable("BENCH_BASELINE");
+        if (!baselinePath.isEmpty())
+        {
+            QFile file(baselinePath);
+            QVERIFY2(file.open(QIODevice::ReadOnly), qPrintable("Cannot read " + baselinePath));
+            m_baseline = QJsonDocument::fromJson(file.readAll()).object();
+        }
+        bool ok = false;
+        const double tolerance = qEnvironmentVariable("BENCH_TOLERANCE").toDouble(&ok);
+        if (ok)
+        {
+            m_tolerance = tolerance;
+        }
+    }
+
+    void cleanupTestCase()
+    {
+        const QString savePath = qEnvironmentVariable("BENCH_SAVE_BASELINE");
+        if (savePath.isEmpty())
+        {
+            return;
+        }
+        QFile file(savePath);
+        QVERIFY2(file.open(QIODevice::WriteOnly | QIODevice::Truncate), qPrintable("Cannot write " + savePath));
+        file.write(QJsonDocument(m_results).toJson(QJsonDocument::Indented));
+    }
+
+    void benchPhase_data()
+    {
+        QTest::addColumn<QString>("phase");
+        QTest::addColumn<int>("lines");
+
+        const char *phases[] = { "stripComments", "extractFunctions", "normalizeBody", "diffLines", "buildSummary" };
+        const char *sizeNames[] = { "small", "medium", "huge" };
+        const int sizes[] = { 2000, 20000, 200000 };
+        for (int p = 0; p < 5; ++p)
+        {
+            for (int s = 0; s < 3; ++s)
+            {
+                const QString name = QString("%1 %2").arg(QLatin1String(phases[p]), QLatin1String(sizeNames[s]));
+                QTest::newRow(name.toUtf8().constData()) << QString(phases[p]) << sizes[s];
+            }
+        }
+    }
+
+    void benchPhase()
+    {
+        QFETCH(QString, phase);
+        QFETCH(int, lines);
+
+        CorpusGenerator generator(7);
+        const CorpusFile corpus = generator.generate(lines);
+        const QString &origText = corpus.original;
+        const QString &newText = corpus.mutated;
+        CompareEngine engine;
+        const QMap<QString, FunctionBlock> orig = engine.extractFunctions(origText);
+        const QMap<QString, FunctionBlock> news = engine.extractFunctions(newText);
+        QVERIFY(!orig.isEmpty());
+
+        // Input of one iteration, for the throughput
+        qint64 bytes = origText.toUtf8().size();
+        qint64 lineCount = origText.count('\n');
+        QStringList changed;
+        if (phase == "normalizeBody")
+        {
+            bytes = 0;
+            lineCount = 0;
+            for (auto it = orig.constBegin(); it != orig.constEnd(); ++it)
+            {
+                bytes += it.value().body().toUtf8().size();
+                lineCount += it.value().body().count('\n') + 1;
+            }
+        }
+        else if (phase == "diffLines")
+        {
+            bytes = 0;
+            lineCount = 0;
+            for (auto it = orig.constBegin(); it != orig.constEnd(); ++it)
+            {
+                const FunctionBlock other = news.value(it.key());
+                if (other.fingerprint != it.value().fingerprint)
+                {
+                    changed << it.key();
+                    bytes += it.value().body().toUtf8().size() + other.body().toUtf8().size();
+                    lineCount += it.value().body().count('\n') + other.body().count('\n') + 2;
+                }
+            }
+            QVERIFY(!changed.isEmpty());
+        }
+        else if (phase == "buildSummary")
+        {
+            bytes += newText.toUtf8().size();
+            lineCount += newText.count('\n');
+        }
+
+        int iterations = 0;
+        qint64 checksum = 0; // Keeps results alive
+        QElapsedTimer timer;
+        timer.start();
+        QBENCHMARK
+        {
+            if (phase == "stripComments")
+            {
+                checksum += engine.stripComments(origText).size();
+            }
+            else if (phase == "extractFunctions")
+            {
+                checksum += engine.extractFunctions(origText).size();
+            }
+            else if (phase == "normalizeBody")
+            {
+                for (auto it = orig.constBegin(); it != orig.constEnd(); ++it)
+                {
+                    checksum += CompareEngine::normalizeBody(it.value().body()).size();
+                }
+            }
+            else if (phase == "diffLines")
+            {
+                for (int i = 0; i < changed.size(); ++i)
+                {
+                    checksum += engine.diffLines(orig.value(changed.at(i)).bodyLines(),
+                                                 news.value(changed.at(i)).bodyLines()).size();
+                }
+            }
+            else
+            {
+                checksum += engine.buildSummary(orig, news).size();
+            }
+            ++iterations;
+        }
+        const qint64 nsecs = timer.nsecsElapsed();
+        QVERIFY(checksum > 0);
+        report(bytes, lineCount, nsecs, iterations);
+    }
+
+    void benchDiffLines_data()
+    {
+        QTest::addColumn<int>("lines");
+        QTest::addColumn<int>("algorithm");
+
+        const int sizes[] = { 200, 2000, 20000 };
+        const DiffAlgorithm algorithms[] = { DiffAlgorithm::Auto, DiffAlgorithm::Myers, DiffAlgorithm::Patience,
+                                             DiffAlgorithm::Histogram, DiffAlgorithm::BitParallel, DiffAlgorithm::Lcs };
+        for (int s = 0; s < 3; ++s)
+        {
+            for (int a = 0; a < 6; ++a)
+            {
+                // O(N*M) memory kernels are too large beyond a few thousand lines
+                const bool quadratic = (algorithms[a] == DiffAlgorithm::Lcs || algorithms[a] == DiffAlgorithm::BitParallel);
+                if (quadratic && sizes[s] > 2000)
+                {
+                    continue;
+                }
+                const QString name = QString("%1 %2").arg(CompareEngine::diffAlgorithmName(algorithms[a])).arg(sizes[s]);
+                QTest::newRow(name.toUtf8().constData()) << sizes[s] << int(algorithms[a]);
+            }
+        }
+    }
+
+    void benchDiffLines()
+    {
+        QFETCH(int, lines);
+        QFETCH(int, algorithm);
+
+        const QStringList orig = makeSource(lines);
+        const QStringList news = mutate(orig);
+        CompareEngine engine;
+        engine.setDiffAlgorithm(DiffAlgorithm(algorithm));
+
+        QVector<EditOp> diff;
+        QBENCHMARK
+        {
+            diff = engine.diffLines(orig, news);
+        }
+        qInfo().noquote() << QString("%1: %2 rows, %3 hunks")
+                                 .arg(QTest::currentDataTag())
+                                 .arg(CompareEngine::countRows(diff))
+                                 .arg(CompareEngine::countHunks(diff));
+    }
+};
+
+QTEST_MAIN(BenchCompare)
+#include "bench_compare.moc"
+
+/************** End of bench_compare.cpp **************************/
@@ -0,0 +1,999 @@
+/****************************************************************
+ * @file    test_compareengine.cpp
+ * @brief   Unit tests for CompareEngine diff kernels.
+ *
+ * @author  Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.34
+ * @date    2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Checks the Myers diff against the reference LCS table: both
+ * must keep the same number of lines, and the diff rows must
+ * rebuild the original and new sides in order. The bit-parallel
+ * LCS must be minimal too; patience and histogram must produce
+ * valid (not necessarily minimal) rows. Also covers the lexer
+ * behind comment stripping and function extraction, and the
+ * Normalizer policies, the background CompareJob, the
+ * DiffRenderer row text and colors, the folding DiffModel and the
+ * intra-line InlineDiff. testCorpus compares CorpusGenerator
+ * pairs against the outcome the generator expects, and
+ * testProfiler the phase totals and the trace export.
+ ***************************************************************/
+
+#include <QtTest>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include "CompareCli.h"
+#include "CompareEngine.h"
+#include "CompareJob.h"
+#include "Config.h"
+#include "CorpusGenerator.h"
+#include "CppLexer.h"
+#include "DiffKernels.h"
+#include "DiffModel.h"
+#include "DiffRenderer.h"
+#include "InlineDiff.h"
+#include "LineInterner.h"
+#include "Normalizer.h"
+#include "Profiler.h"
+
+class TestCompareEngine : public QObject
+{
+    Q_OBJECT
+private:
+    /************************************************************
+     * @brief Counts rows with the given marker.
+     ***********************************************************/
+    static int countMarker(const QVector<EditOp> &diff, const QString &marker)
+    {
+        int count = 0;
+        for (int i = 0; i < diff.size(); ++i)
+        {
+            if (diff.at(i).marker() == marker.at(0))
+            {
+                count += diff.at(i).length;
+            }
+        }
+        return count;
+    }
+
+    /************************************************************
+     * @brief Rebuilds one side of the diff from its runs.
+     * @param original true for the original side, else new.
+     ***********************************************************/
+    static QStringList rebuildSide(const QVector<EditOp> &diff, const QStringList &orig,
+                                   const QStringList &news, bool original)
+    {
+        QStringList lines;
+        for (int i = 0; i < diff.size(); ++i)
+        {
+            const EditOp &op = diff.at(i);
+            if (op.op != EditOp::Equal && op.fromOriginal() != original)
+            {
+                continue;
+            }
+            for (int k = 0; k < op.length; ++k)
+            {
+                lines << (original ? orig.at(op.origIndex + k) : news.at(op.newIndex + k));
+            }
+        }
+        return lines;
+    }
+
+    /************************************************************
+     * @brief Returns views of lines, as FunctionBlock::bodyLines.
+     ***********************************************************/
+    static QVector<QStringView> views(const QStringList &lines)
+    {
+        QVector<QStringView> result;
+        for (int i = 0; i < lines.size(); ++i)
+        {
+            result.append(lines.at(i));
+        }
+        return result;
+    }
+
+private slots:
+    void testMyersMatchesLcs_data()
+    {
+        QTest::addColumn<QStringList>("orig");
+        QTest::addColumn<QStringList>("news");
+
+        QTest::newRow("empty") << QStringList() << QStringList();
+        QTest::newRow("all new") << QStringList() << QStringList({ "a", "b" });
+        QTest::newRow("all gone") << QStringList({ "a", "b" }) << QStringList();
+        QTest::newRow("same") << QStringList({ "a", "b", "c" }) << QStringList({ "a", "b", "c" });
+        QTest::newRow("one edit") << QStringList({ "a", "b", "c" }) << QStringList({ "a", "x", "c" });
+        QTest::newRow("spacing") << QStringList({ "int  x = 1;", "\treturn x;" })
+                                 << QStringList({ "int x = 1;", "return x;" });
+        QTest::newRow("disjoint") << QStringList({ "a", "b", "c" }) << QStringList({ "x", "y" });
+        QTest::newRow("classic") << QStringList({ "a", "b", "c", "a", "b", "b", "a" })
+                                 << QStringList({ "c", "b", "a", "b", "a", "c" });
+        QTest::newRow("braces") << QStringList({ "{", "x();", "}", "{", "y();", "}" })
+                                << QStringList({ "{", "y();", "}", "{", "z();", "}" });
+    }
+
+    void testMyersMatchesLcs()
+    {
+        QFETCH(QStringList, orig);
+        QFETCH(QStringList, news);
+
+        CompareEngine engine;
+        engine.setDiffAlgorithm(DiffAlgorithm::Lcs);
+        const auto reference = engine.diffLines(orig, news);
+        engine.setDiffAlgorithm(DiffAlgorithm::Myers);
+        const auto myers = engine.diffLines(orig, news);
+
+        // Runs of equal-cost scripts may split differently; the rows may not
+        QCOMPARE(CompareEngine::countRows(myers), CompareEngine::countRows(reference));
+        for (const QString &marker : { " ", "-", "+", "~" })
+        {
+            QCOMPARE(countMarker(myers, marker), countMarker(reference, marker));
+        }
+        QCOMPARE(rebuildSide(myers, orig, news, true), orig);
+        QCOMPARE(rebuildSide(myers, orig, news, false), news);
+
+        engine.setDiffAlgorithm(DiffAlgorithm::BitParallel);
+        const auto bitParallel = engine.diffLines(orig, news);
+        QCOMPARE(countMarker(bitParallel, " "), countMarker(reference, " "));
+        QCOMPARE(rebuildSide(bitParallel, orig, news, true), orig);
+        QCOMPARE(rebuildSide(bitParallel, orig, news, false), news);
+
+        // Anchored algorithms need not be minimal, but must be valid
+        const DiffAlgorithm anchored[] = { DiffAlgorithm::Patience, DiffAlgorithm::Histogram };
+        for (int i = 0; i < 2; ++i)
+        {
+            engine.setDiffAlgorithm(anchored[i]);
+            const auto diff = engine.diffLines(orig, news);
+            QVERIFY(countMarker(diff, " ") <= countMarker(reference, " "));
+            QCOMPARE(rebuildSide(diff, orig, news, true), orig);
+            QCOMPARE(rebuildSide(diff, orig, news, false), news);
+        }
+    }
+
+    void testAlgorithmNames()
+    {
+        const DiffAlgorithm all[] = { DiffAlgorithm::Auto, DiffAlgorithm::Myers, DiffAlgorithm::Patience,
+                                      DiffAlgorithm::Histogram, DiffAlgorithm::BitParallel, DiffAlgorithm::Lcs };
+        for (int i = 0; i < 6; ++i)
+        {
+            QCOMPARE(CompareEngine::diffAlgorithmFromName(CompareEngine::diffAlgorithmName(all[i])), all[i]);
+        }
+        QCOMPARE(CompareEngine::diffAlgorithmFromName("unknown"), DiffAlgorithm::Auto);
+    }
+
+    void testBitParallelMultiword()
+    {
+        // More than 64 lines per side so the carry crosses words
+        QStringList orig;
+        QStringList news;
+        for (int i = 0; i < 300; ++i)
+        {
+            orig << QString("x%1();").arg(i % 17);
+            news << QString("x%1();").arg((i * 7) % 19);
+        }
+
+        CompareEngine engine;
+        engine.setDiffAlgorithm(DiffAlgorithm::Lcs);
+        const auto reference = engine.diffLines(orig, news);
+        engine.setDiffAlgorithm(DiffAlgorithm::BitParallel);
+        const auto diff = engine.diffLines(orig, news);
+        QCOMPARE(countMarker(diff, " "), countMarker(reference, " "));
+        QCOMPARE(rebuildSide(diff, orig, news, true), orig);
+        QCOMPARE(rebuildSide(diff, orig, news, false), news);
+    }
+
+    void testAutoChoosesKernel()
+    {
+        LineInterner interner;
+        QStringList orig;
+        for (int i = 0; i < 400; ++i)
+        {
+            orig << QString("value%1();").arg(i);
+        }
+        QStringList fewEdits = orig;
+        fewEdits[200] = "changed();";
+        QStringList rewritten;
+        for (int i = 0; i < 400; ++i)
+        {
+            rewritten << QString("other%1();").arg(i % 3 == 0 ? i : i + 1000);
+        }
+        const QVector<quint32> a = interner.internLines(orig);
+        QCOMPARE(CompareEngine::chooseDiffAlgorithm(a, interner.internLines(fewEdits)), DiffAlgorithm::Myers);
+        QCOMPARE(CompareEngine::chooseDiffAlgorithm(a, interner.internLines(rewritten)), DiffAlgorithm::BitParallel);
+        QCOMPARE(CompareEngine::chooseDiffAlgorithm(a, QVector<quint32>()), DiffAlgorithm::Myers);
+
+        // Two lines against many: one word per row, still too many rows to keep
+        const QVector<quint32> shortRows({ 1, 2 });
+        const QVector<quint32> manyRows(DiffKernels::BitParallelMaxWords + 1, 3);
+        QCOMPARE(CompareEngine::chooseDiffAlgorithm(shortRows, manyRows), DiffAlgorithm::Myers);
+        QCOMPARE(CompareEngine::chooseDiffAlgorithm(shortRows, manyRows.mid(0, 1000)), DiffAlgorithm::BitParallel);
+    }
+
+    void testPatienceAnchorsOnUniqueLines()
+    {
+        // The inserted function must come out as one contiguous hunk
+        const QStringList orig({ "void a()", "{", "a();", "}", "", "void c()", "{", "c();", "}" });
+        const QStringList news({ "void a()", "{", "a();", "}", "", "void b()", "{", "b();", "}",
+                                 "", "void c()", "{", "c();", "}" });
+
+        CompareEngine engine;
+        engine.setDiffAlgorithm(DiffAlgorithm::Patience);
+        const auto diff = engine.diffLines(orig, news);
+        QCOMPARE(countMarker(diff, "+"), 5);
+        QCOMPARE(countMarker(diff, "-"), 0);
+        QCOMPARE(CompareEngine::countHunks(diff), 1);
+    }
+
+    void testHistogramChainCap()
+    {
+        // Anchoring on the x run costs two more rows than the minimal
+        // script, which keeps the z run; a line seen more than
+        // HistogramMaxChain times is never an anchor
+        const int counts[] = { DiffKernels::HistogramMaxChain, DiffKernels::HistogramMaxChain + 1 };
+        for (const int count : counts)
+        {
+            QVector<quint32> a;
+            QVector<quint32> b;
+            a.fill(1, count + 1);
+            a.append(QVector<quint32>(count, 2));
+            b.fill(2, count);
+            b.append(QVector<quint32>(count + 1, 1));
+
+            QByteArray script;
+            DiffKernels::histogram(a, b, script);
+            const bool anchored = count <= DiffKernels::HistogramMaxChain;
+            QCOMPARE(int(script.count(DiffKernels::OpDelete)), anchored ? count + 1 : count);
+            QCOMPARE(int(script.count(DiffKernels::OpInsert)), anchored ? count + 1 : count);
+            QCOMPARE(int(script.size() - script.count(DiffKernels::OpInsert)), int(a.size()));
+        }
+    }
+
+    void testQuadraticKernelsCapped()
+    {
+        // Too large for the LCS table or the bit rows: Myers diffs it, and
+        // the changes are flagged approximate
+        const int count = 6000;
+        QVector<quint32> a;
+        QVector<quint32> b;
+        for (int i = 0; i < count; ++i)
+        {
+            a.append(quint32(i));
+            b.append(quint32(i % 50 == 0 ? i + count : i));
+        }
+        QVERIFY(qint64(count + 1) * (count + 1) > DiffKernels::LcsMaxCells);
+        QVERIFY(qint64(count) * ((count + 63) / 64) > DiffKernels::BitParallelMaxWords);
+
+        QByteArray myers;
+        DiffKernels::myers(a, b, myers);
+        QByteArray script;
+        DiffKernels::lcs(a, b, script);
+        QCOMPARE(script.count(DiffKernels::OpEqual), myers.count(DiffKernels::OpEqual));
+        QCOMPARE(script.count(DiffKernels::OpDelete), 0);
+        QCOMPARE(script.count(DiffKernels::OpDeleteApprox), count / 50);
+        script.clear();
+        DiffKernels::bitParallel(a, b, script);
+        QCOMPARE(script.count(DiffKernels::OpEqual), myers.count(DiffKernels::OpEqual));
+        QCOMPARE(script.count(DiffKernels::OpInsert), 0);
+        QCOMPARE(script.count(DiffKernels::OpInsertApprox), count / 50);
+    }
+
+    void testLineInterner()
+    {
+        LineInterner interner;
+        const quint32 a = interner.intern(u"  int  x =\t1; ");
+        const quint32 b = interner.intern(u"int x = 1;");
+        const quint32 c = interner.intern(u"int x = 2;");
+        QCOMPARE(a, b);
+        QVERIFY(a != c);
+        QCOMPARE(interner.text(a), QString("int x = 1;"));
+        QCOMPARE(interner.hash(a), interner.hash(b));
+        QCOMPARE(interner.size(), 2);
+        QCOMPARE(interner.intern(u"   "), interner.intern(u""));
+
+        // An unrelated policy does not change how braces and spaces compare
+        const unsigned policies[] = { Normalizer::NoFlags, Normalizer::IgnoreTrailingSemicolons,
+                                      Normalizer::IgnoreCommentOnlyChanges };
+        for (const unsigned flags : policies)
+        {
+            LineInterner withFlags(flags);
+            QCOMPARE(withFlags.intern(u"if (x){"), withFlags.intern(u"if (x) {"));
+            QCOMPARE(withFlags.text(withFlags.intern(u"  int  x =\t1 ")), QString("int x = 1"));
+        }
+    }
+
+    void testMovedBlock()
+    {
+        const QStringList orig({ "a();", "b();", "c();", "d();", "e();", "f();" });
+        const QStringList news({ "a();", "e();", "f();", "b();", "c();", "d();" });
+
+        CompareEngine engine;
+        const auto diff = engine.diffLines(orig, news);
+        QCOMPARE(countMarker(diff, "~"), 4);
+        QCOMPARE(countMarker(diff, "-"), 0);
+        QCOMPARE(countMarker(diff, "+"), 0);
+        QCOMPARE(rebuildSide(diff, orig, news, true), orig);
+        QCOMPARE(rebuildSide(diff, orig, news, false), news);
+    }
+
+    void testTrivialMoveIgnored()
+    {
+        const QStringList orig({ "a();", "b();", "}" });
+        const QStringList news({ "}", "a();", "b();" });
+
+        CompareEngine engine;
+        const auto diff = engine.diffLines(orig, news);
+        QCOMPARE(countMarker(diff, "~"), 0);
+        QCOMPARE(countMarker(diff, "-"), 1);
+        QCOMPARE(countMarker(diff, "+"), 1);
+    }
+
+    void testLexerLiterals()
+    {
+        const QString code = "auto s = R\"d(}\" // )d\"; char c = '{'; int n = 1'000; // end\n";
+        const QVector<CppToken> tokens = CppLexer::tokenize(code);
+        QStringList kinds;
+        int braces = 0;
+        for (int i = 0; i < tokens.size(); ++i)
+        {
+            const CppTokenKind kind = tokens.at(i).kind;
+            braces += (kind == CppTokenKind::OpenBrace || kind == CppTokenKind::CloseBrace) ? 1 : 0;
+            if (kind == CppTokenKind::RawString || kind == CppTokenKind::Char || kind == CppTokenKind::Number
+                || kind == CppTokenKind::LineComment)
+            {
+                kinds << code.mid(tokens.at(i).start, tokens.at(i).length);
+            }
+        }
+        QCOMPARE(braces, 0);
+        QCOMPARE(kinds, QStringList({ "R\"d(}\" // )d\"", "'{'", "1'000", "// end" }));
+    }
+
+    void testStripCommentsKeepsStrings()
+    {
+        CompareEngine engine;
+        const QString code = "const char *url = \"http://x/*y*/\"; // gone\nint/* one */a; /* two\nlines */ b;";
+        QCOMPARE(engine.stripComments(code),
+                 QString("const char *url = \"http://x/*y*/\"; \nint a; \n b;"));
+    }
+
+    void testExtractFunctions()
+    {
+        const QString code =
+            "#include \"a.h\"\n"
+            "int Foo::bar(int x) const\n{\n    if (x) { return '}'; }\n    return 0;\n}\n"
+            "Foo::~Foo() {}\n"
+            "Foo::Foo(int a) : m_a(a), m_b{ 2 } { init(); }\n"
+            "bool operator==(const A &l, const A &r) { return l.x == r.x; }\n"
+            "Q_DECLARE_METATYPE(Foo)\n"
+            "int declared(int);\n"
+            "auto later() -> int { return 1; }\n";
+
+        CompareEngine engine;
+        const QMap<QString, FunctionBlock> functions = engine.extractFunctions(code);
+        QCOMPARE(functions.keys(), QStringList({ "Foo::Foo", "Foo::bar", "Foo::~Foo", "later", "operator==" }));
+        QCOMPARE(functions.value("Foo::bar").signature().toString(), QString("Foo::bar(int x) const"));
+        QCOMPARE(functions.value("Foo::bar").normalizedBody(), QString("if (x){return '}';}return 0;"));
+        QCOMPARE(functions.value("Foo::Foo").signature().toString(), QString("Foo::Foo(int a) : m_a(a), m_b{ 2 }"));
+        QCOMPARE(functions.value("later").normalizedBody(), QString("return 1;"));
+    }
+
+    void testFunctionBlockSpans()
+    {
+        const QString code = "int a()\r\n{\r\n    return 1;\r\n}\r\nint b() { return 2; }\r\n";
+        CompareEngine engine;
+        const QMap<QString, FunctionBlock> functions = engine.extractFunctions(code);
+        const FunctionBlock a = functions.value("a");
+        const FunctionBlock b = functions.value("b");
+        QVERIFY(a.source == b.source);
+        QCOMPARE(a.body().toString(), QString("\r\n    return 1;\r\n"));
+        const QVector<QStringView> lines = a.bodyLines();
+        QCOMPARE(lines.size(), 3);
+        QCOMPARE(lines.at(1).toString(), QString("    return 1;"));
+        QCOMPARE(b.normalizedBody(), QString("return 2;"));
+    }
+
+    void testFingerprints()
+    {
+        CompareEngine engine;
+        const auto orig = engine.extractFunctions("int a() { return  1; }\nint b() { return 2; }\nint c() { return 3; }\n");
+        const auto news = engine.extractFunctions("int a()\n{\n    return 1; // same\n}\nint b() { return 20; }\n");
+        QCOMPARE(orig.value("a").fingerprint, news.value("a").fingerprint);
+        QVERIFY(orig.value("b").fingerprint != news.value("b").fingerprint);
+        QCOMPARE(orig.value("a").fingerprint, CompareEngine::fingerprintBody(orig.value("a").body()));
+        QVERIFY(CompareEngine::fingerprintBody(u"f(\"a b\");") != CompareEngine::fingerprintBody(u"f(\"a  b\");"));
+
+        const QString summary = engine.buildSummary(orig, news);
+        QVERIFY(summary.contains("Changed function bodies (1):\n * b"));
+        QVERIFY(summary.contains("Missing functions in new (1):\n - c"));
+    }
+
+    void testExtractFunctionsNested()
+    {
+        QString deep = "void deep()\n{\n";
+        for (int i = 0; i < 2000; ++i)
+        {
+            deep += "if (x) { for (;;) { auto f = [](int y) { return y; };\n";
+        }
+        for (int i = 0; i < 2000; ++i)
+        {
+            deep += "} }\n";
+        }
+        deep += "}\n";
+        const QString code =
+            "template <class T, typename U = std::vector<int>> struct Box : Base<T> {\n"
+            "    T get() { return value; }\n"
+            "};\n"
+            "namespace ns {\n"
+            "class Q_EXPORT Widget final : public Base {\n"
+            "public:\n"
+            "    void paint() { if (dirty) { redraw(); } }\n"
+            "    enum class Mode { A, B };\n"
+            "};\n"
+            "namespace { int helper() { return 1; } }\n"
+            "}\n"
+            "extern \"C\" { int c_api(void) { return 0; } }\n"
+            "static int table[] = { 1, 2 };\n"
+            "template <class K, class V> V Map<K, std::pair<K, V>>::get() const { return at(0); }\n"
+            "int get() { return 0; }\n" + deep;
+
+        CompareEngine engine;
+        const QMap<QString, FunctionBlock> functions = engine.extractFunctions(code);
+        QCOMPARE(functions.keys(), QStringList({ "Box::get", "Map::get", "c_api", "deep", "get", "ns::Widget::paint", "ns::helper" }));
+        QCOMPARE(functions.value("Map::get").normalizedBody(), QString("return at(0);"));
+        QCOMPARE(functions.value("get").normalizedBody(), QString("return 0;"));
+        QCOMPARE(functions.value("ns::Widget::paint").normalizedBody(), QString("if (dirty){redraw();}"));
+    }
+
+    void testNormalizerPolicies_data()
+    {
+        QTest::addColumn<QString>("text");
+        QTest::addColumn<uint>("flags");
+        QTest::addColumn<QString>("expected");
+
+        const QString code = "\n  int a = 1 ;  // note\n\n\n  if (a)\n  {\n    f(\"x  ;\");\n  }\n\n";
+        QTest::newRow("lines") << code << uint(Normalizer::NoFlags)
+                               << "int a = 1 ; // note\n\n\nif (a)\n{\nf(\"x  ;\");\n}";
+        QTest::newRow("joined") << code << uint(Normalizer::JoinLines)
+                                << "int a = 1 ; // note if (a){f(\"x  ;\");}";
+        QTest::newRow("blank") << code << uint(Normalizer::IgnoreBlankLines)
+                               << "int a = 1 ; // note\nif (a)\n{\nf(\"x  ;\");\n}";
+        QTest::newRow("semicolons") << code << uint(Normalizer::IgnoreTrailingSemicolons)
+                                    << "int a = 1 ; // note\n\n\nif (a)\n{\nf(\"x  ;\")\n}";
+        QTest::newRow("comments") << code << uint(Normalizer::IgnoreCommentOnlyChanges | Normalizer::IgnoreTrailingSemicolons)
+                                  << "int a = 1\n\n\nif (a)\n{\nf(\"x  ;\")\n}";
+        QTest::newRow("comment line") << QString("a;\n  // gone\nb; /* x */ c;")
+                                      << uint(Normalizer::IgnoreCommentOnlyChanges) << "a;\nb; c;";
+        QTest::newRow("inner semicolons") << QString("for (;;) ;\nx = 1;; { y; }")
+                                          << uint(Normalizer::IgnoreTrailingSemicolons) << "for (;;)\nx = 1;;{y}";
+        QTest::newRow("literals") << QString("c = '{' ; n = 1'000 ; s = R\"d( } ; )d\" ;")
+                                  << uint(Normalizer::IgnoreTrailingSemicolons)
+                                  << "c = '{' ; n = 1'000 ; s = R\"d( } ; )d\"";
+    }
+
+    void testNormalizerPolicies()
+    {
+        QFETCH(QString, text);
+        QFETCH(uint, flags);
+        QFETCH(QString, expected);
+        QCOMPARE(Normalizer::normalize(text, flags), expected);
+        // The hash sink must see exactly what the string sink writes
+        QCOMPARE(Normalizer::fingerprint(text, flags), Normalizer::fingerprint(expected, Normalizer::NoFlags));
+    }
+
+    void testNormalizeFlagsInEngine()
+    {
+        CompareEngine engine;
+        engine.setNormalizeFlags(Normalizer::IgnoreBlankLines | Normalizer::IgnoreTrailingSemicolons);
+        const auto orig = engine.extractFunctions("int a()\n{\n    x = 1;\n    y = 2; }\n");
+        const auto news = engine.extractFunctions("int a() {\n    x = 1;\n\n    y = 2\n}\n");
+        QCOMPARE(orig.value("a").fingerprint, news.value("a").fingerprint);
+        QCOMPARE(orig.value("a").normalizedBody(), news.value("a").normalizedBody());
+
+        const auto diff = engine.diffLines(QStringList({ "x = 1;", "", "y = 2;" }), QStringList({ "x = 1", "y = 2;", "  " }));
+        QCOMPARE(CompareEngine::countRows(diff), 2);
+        QCOMPARE(countMarker(diff, " "), 2);
+        // Runs index the inputs, so the skipped blank line splits them
+        QCOMPARE(diff.size(), 2);
+        QCOMPARE(diff.at(1).origIndex, 2);
+        QCOMPARE(diff.at(1).newIndex, 1);
+    }
+
+    void testIgnoreCommentsInEngine()
+    {
+        const QString origCode = "int a()\n{\n    x = 1; // one\n    return x;\n}\n";
+        const QString newCode = "int a()\n{\n    x = 1; // first\n    /* kept */\n    return x;\n}\n";
+        CompareEngine engine;
+        QVERIFY(engine.normalizeFlags() & Normalizer::IgnoreCommentOnlyChanges);
+        auto orig = engine.extractFunctions(origCode);
+        auto news = engine.extractFunctions(newCode);
+        QCOMPARE(orig.value("a").fingerprint, news.value("a").fingerprint);
+
+        engine.setNormalizeFlags(Normalizer::NoFlags);
+        orig = engine.extractFunctions(origCode);
+        news = engine.extractFunctions(newCode);
+        QVERIFY(orig.value("a").fingerprint != news.value("a").fingerprint);
+        QVERIFY(news.value("a").body().contains(u"/* kept */"));
+        const auto diff = engine.diffLines(orig.value("a").bodyLines(), news.value("a").bodyLines());
+        QCOMPARE(countMarker(diff, "-"), 1);
+        QCOMPARE(countMarker(diff, "+"), 2);
+    }
+
+    void testEditScriptRuns()
+    {
+        const QStringList orig({ "a();", "b();", "c();", "d();", "e();", "f();" });
+        const QStringList news({ "a();", "b();", "x();", "y();", "e();", "f();" });
+        CompareEngine engine;
+        const auto diff = engine.diffLines(orig, news);
+        QCOMPARE(diff.size(), 4);
+        QCOMPARE(diff.at(0).op, EditOp::Equal);
+        QCOMPARE(diff.at(0).length, 2);
+        QCOMPARE(diff.at(1).op, EditOp::Delete);
+        QCOMPARE(diff.at(1).origIndex, 2);
+        QCOMPARE(diff.at(1).newIndex, 2);
+        QCOMPARE(diff.at(1).length, 2);
+        QCOMPARE(diff.at(2).op, EditOp::Insert);
+        QCOMPARE(diff.at(2).origIndex, 4);
+        QCOMPARE(diff.at(2).newIndex, 2);
+        QCOMPARE(diff.at(3).op, EditOp::Equal);
+        QCOMPARE(diff.at(3).origIndex, 4);
+        QCOMPARE(diff.at(3).newIndex, 4);
+        QCOMPARE(diff.at(2).line(orig, news, 1), QString("y();"));
+        QCOMPARE(CompareEngine::countRows(diff), 8);
+        QCOMPARE(CompareEngine::countHunks(diff), 1);
+    }
+
+    void testInlineDiff()
+    {
+        QVector<InlineSpan> a;
+        QVector<InlineSpan> b;
+        QVERIFY(InlineDiff::diff(u"    int count = total + 1;", u"    int amount = total + 1;", a, b));
+        QCOMPARE(a.size(), 1);
+        QCOMPARE(a.at(0).start, 8);
+        QCOMPARE(a.at(0).length, 5);
+        QCOMPARE(b.size(), 1);
+        QCOMPARE(b.at(0).start, 8);
+        QCOMPARE(b.at(0).length, 6);
+
+        // A literal is narrowed to the characters that differ
+        QVERIFY(InlineDiff::diff(u"log(\"hello world\");", u"log(\"hello there\");", a, b));
+        QCOMPARE(a.size(), 1);
+        QCOMPARE(a.at(0).start, 11);
+        QCOMPARE(a.at(0).length, 5);
+        QCOMPARE(b.size(), 1);
+        QCOMPARE(b.at(0).start, 11);
+        QCOMPARE(b.at(0).length, 5);
+
+        // An added argument marks only the new line
+        QVERIFY(InlineDiff::diff(u"f(a);", u"f(a, b);", a, b));
+        QVERIFY(a.isEmpty());
+        QCOMPARE(b.size(), 1);
+        QCOMPARE(b.at(0).start, 3);
+        QCOMPARE(b.at(0).length, 3);
+
+        QVERIFY(!InlineDiff::diff(QString(InlineDiff::MaxLineLength + 1, 'x'), u"x", a, b));
+        QVERIFY(a.isEmpty() && b.isEmpty());
+    }
+
+    void testCompareJob()
+    {
+        CompareEngine engine;
+        CompareJob job(engine, "int a() { return 1; }\nint b() { return 2; }\nint c() { return 3; }\n",
+                       "int c() { return 30; }\nint a() { return  1; }\nint b() { return 20; }\n");
+        QStringList diffed;
+        connect(&job, &CompareJob::functionDiffed, this, [&diffed](const QString &name)
+                {
+                    diffed << name;
+                });
+        QSignalSpy finished(&job, &CompareJob::finished);
+        QSignalSpy canceled(&job, &CompareJob::canceled);
+        job.start();
+        QVERIFY(job.isRunning());
+        QVERIFY(finished.wait(10000));
+        QVERIFY(!job.isRunning());
+        QCOMPARE(diffed, QStringList({ "b", "c" }));
+        QVERIFY(finished.at(0).at(0).toString().contains("Changed function bodies (2)"));
+        QCOMPARE(canceled.count(), 0);
+    }
+
+    void testCompareJobBatches()
+    {
+        // Three functions of over half a batch each: the third goes out on a
+        // later tick, and the summary only after it
+        const int lines = CompareJob::RowsPerTick / 4 + 1;
+        QString original;
+        QString changed;
+        for (const char *name : { "a", "b", "c" })
+        {
+            original += QString("int %1()\n{\n").arg(name);
+            changed += QString("int %1()\n{\n").arg(name);
+            for (int i = 0; i < lines; ++i)
+            {
+                original += QString("    x%1();\n").arg(i);
+                changed += QString("    y%1();\n").arg(i);
+            }
+            original += "}\n";
+            changed += "}\n";
+        }
+        CompareEngine engine;
+        CompareJob job(engine, original, changed);
+        QStringList events;
+        connect(&job, &CompareJob::functionDiffed, this, [&events](const QString &name)
+                {
+                    events << name;
+                });
+        connect(&job, &CompareJob::finished, this, [&events]()
+                {
+                    events << "finished";
+                });
+        QSignalSpy finished(&job, &CompareJob::finished);
+        job.start();
+        QVERIFY(finished.wait(30000));
+        QCOMPARE(events, QStringList({ "a", "b", "c", "finished" }));
+    }
+
+    void testCompareJobCancel()
+    {
+        CompareEngine engine;
+        CompareJob job(engine, "int a() { return 1; }\n", "int a() { return 2; }\n");
+        QSignalSpy finished(&job, &CompareJob::finished);
+        QSignalSpy canceled(&job, &CompareJob::canceled);
+        job.start();
+        job.cancel();
+        job.cancel();
+        QCOMPARE(canceled.count(), 1);
+        QVERIFY(!job.isRunning());
+        QTest::qWait(100);
+        QCOMPARE(finished.count(), 0);
+
+        // Deleted mid-compare: nothing waits, the tasks finish on their own copies
+        QString big;
+        for (int i = 0; i < 2000; ++i)
+        {
+            big += QString("int f%1() { return %1; }\n").arg(i);
+        }
+        CompareJob *dropped = new CompareJob(engine, big, QString(big).replace("return", "return -"));
+        dropped->start();
+        delete dropped;
+        QVERIFY(QThreadPool::globalInstance()->waitForDone(10000));
+    }
+
+    void testDiffRenderer()
+    {
+        QCOMPARE(DiffRenderer::lineText(' ', u"a();"), QString(" a();"));
+        QCOMPARE(DiffRenderer::lineText('-', u"b();"), QString("- b();"));
+        QCOMPARE(DiffRenderer::lineText('~', u""), QString("~ "));
+        QCOMPARE(DiffRenderer::format('-').foreground().color(), QColor(Qt::red));
+        QCOMPARE(DiffRenderer::format('+').foreground().color(), QColor(Qt::green));
+        QCOMPARE(DiffRenderer::format('~').foreground().color(), QColor(Qt::magenta));
+        QCOMPARE(DiffRenderer::format(' ').foreground().color(), QColor(Qt::black));
+        QVERIFY(DiffRenderer::highlight('-') != DiffRenderer::highlight('+'));
+    }
+
+    void testDiffModel()
+    {
+        QString body;
+        for (int i = 0; i < 30; ++i)
+        {
+            body += QString("    x%1();\n").arg(i);
+        }
+        QString changedBody = body;
+        changedBody.replace("    x15();", "    y15();");
+        CompareEngine engine;
+        const auto orig = engine.extractFunctions("int a() { return 1; }\nint b() {\n" + body + "}\nint m() { return 3; }\n");
+        const auto news = engine.extractFunctions("int a() { return 1; }\nint b() {\n" + changedBody + "}\nint n() { return 4; }\n");
+        const QVector<QStringView> origLines = orig.value("b").bodyLines();
+        const QVector<QStringView> newLines = news.value("b").bodyLines();
+        const auto ops = engine.diffLines(origLines, newLines);
+
+        DiffModel model;
+        QAbstractItemModelTester tester(&model, QAbstractItemModelTester::FailureReportingMode::QtTest);
+        model.setFunctions(orig, news);
+        QCOMPARE(model.rowCount(), 4);
+        const QModelIndex a = model.index(0, 0);
+        const QModelIndex b = model.index(1, 0);
+        QCOMPARE(a.data().toString(), QString("a"));
+        QCOMPARE(b.data(DiffModel::StatusRole).toInt(), int(FunctionStatus::Changed));
+        QCOMPARE(model.index(2, 0).data(DiffModel::StatusRole).toInt(), int(FunctionStatus::Missing));
+        QCOMPARE(model.index(3, 0).data(DiffModel::StatusRole).toInt(), int(FunctionStatus::Added));
+        QCOMPARE(model.rowCount(b), 0);
+
+        // Unchanged runs on both sides of the edit fold, keeping context
+        model.setFunctionDiff("b", ops);
+        const QModelIndex fold = model.index(0, 0, b);
+        QVERIFY(model.rowCount(fold) >= DiffModel::FoldMinimum);
+        QVERIFY(fold.data().toString().contains("unchanged lines"));
+        QCOMPARE(fold.data(DiffModel::MarkerRole).toString(), QString());
+        QCOMPARE(model.parent(model.index(0, 0, fold)), fold);
+        QStringList shown;
+        for (int i = 0; i < model.rowCount(b); ++i)
+        {
+            const QModelIndex child = model.index(i, 0, b);
+            for (int j = 0; j < model.rowCount(child); ++j)
+            {
+                shown << model.index(j, 0, child).data().toString();
+            }
+            if (model.rowCount(child) == 0)
+            {
+                shown << child.data().toString();
+            }
+        }
+        QStringList expected;
+        for (int i = 0; i < ops.size(); ++i)
+        {
+            for (int k = 0; k < ops.at(i).length; ++k)
+            {
+                expected << DiffRenderer::lineText(ops.at(i).marker(), ops.at(i).line(origLines, newLines, k));
+            }
+        }
+        QCOMPARE(shown, expected);
+        QVERIFY(model.rowCount(b) < expected.size() - DiffModel::FoldMinimum);
+
+        // The renamed call is highlighted on both rows of the pair
+        int refined = 0;
+        for (int i = 0; i < model.rowCount(b); ++i)
+        {
+            const QModelIndex child = model.index(i, 0, b);
+            const QString marker = child.data(DiffModel::MarkerRole).toString();
+            if (marker == "-" || marker == "+")
+            {
+                const auto spans = child.data(DiffModel::SpansRole).value<QVector<InlineSpan>>();
+                QCOMPARE(spans.size(), 1);
+                QCOMPARE(child.data().toString().mid(spans.at(0).start, spans.at(0).length),
+                         QString(marker == "-" ? "x15" : "y15"));
+                ++refined;
+            }
+        }
+        QCOMPARE(refined, 2);
+
+        // Unchanged functions list their lines only when expanded
+        QVERIFY(model.hasChildren(a));
+        QCOMPARE(model.rowCount(a), 0);
+        QVERIFY(model.canFetchMore(a));
+        model.fetchMore(a);
+        QCOMPARE(model.rowCount(a), int(orig.value("a").bodyLines().size()));
+        QVERIFY(!model.canFetchMore(a));
+
+        QVERIFY(model.toPlainText().startsWith("=== Function: b ===\n"));
+        model.setFileName("a.cpp");
+        QVERIFY(model.toPlainText().startsWith("File: a.cpp\n\n=== Function: b ===\n"));
+        model.clear();
+        QCOMPARE(model.rowCount(), 0);
+        QCOMPARE(model.fileName(), QString());
+    }
+
+    void testMyersLargeFewEdits()
+    {
+        QStringList orig;
+        for (int i = 0; i < 3000; ++i)
+        {
+            orig << QString("    value%1 = compute(%1);").arg(i);
+        }
+        QStringList news = orig;
+        news[10] = "    changed();";
+        news.removeAt(1500);
+        news.insert(2500, "    inserted();");
+
+        CompareEngine engine;
+        const auto diff = engine.diffLines(orig, news);
+        QCOMPARE(countMarker(diff, " "), 2998);
+        QCOMPARE(rebuildSide(diff, orig, news, true), orig);
+        QCOMPARE(rebuildSide(diff, orig, news, false), news);
+    }
+
+    void testDiffBudget()
+    {
+        // Mostly rewritten bodies with a few shared lines: a real search
+        QStringList orig;
+        QStringList news;
+        for (int i = 0; i < 4000; ++i)
+        {
+            orig << QString("left%1();").arg(i);
+            news << (i % 40 == 0 ? orig.at(i) : QString("right%1();").arg(i));
+        }
+
+        CompareEngine engine;
+        engine.setDiffAlgorithm(DiffAlgorithm::Myers);
+        engine.setDiffBudget(64, 0);
+        const auto coarse = engine.diffLines(orig, news);
+        QVERIFY(CompareEngine::isApproximate(coarse));
+        QCOMPARE(rebuildSide(coarse, orig, news, true), orig);
+        QCOMPARE(rebuildSide(coarse, orig, news, false), news);
+        for (int i = 0; i < coarse.size(); ++i)
+        {
+            QVERIFY(!coarse.at(i).approximate || coarse.at(i).op != EditOp::Equal);
+        }
+
+        engine.setDiffBudget(0, 0);
+        const auto exact = engine.diffLines(orig, news);
+        QVERIFY(!CompareEngine::isApproximate(exact));
+        QCOMPARE(countMarker(exact, " "), 100);
+        QVERIFY(countMarker(coarse, " ") <= countMarker(exact, " "));
+
+        // The default budget leaves small edits exact
+        engine.setDiffBudget(CompareEngine::DefaultMaxEditCost, CompareEngine::DefaultMaxMilliseconds);
+        QStringList edited = orig;
+        edited[7] = "changed();";
+        QVERIFY(!CompareEngine::isApproximate(engine.diffLines(orig, edited)));
+
+        // Past the deadline a kernel emits the rest as one coarse block
+        LineInterner interner;
+        const QVector<quint32> a = interner.internLines(QStringList({ "a", "b", "c", "d" }));
+        const QVector<quint32> b = interner.internLines(QStringList({ "a", "x", "c", "d" }));
+        DiffKernels::Budget expired;
+        expired.deadline = QDeadlineTimer(0);
+        QByteArray script;
+        DiffKernels::myers(a, b, script, &expired);
+        QCOMPARE(script, QByteArray("=di=="));
+        script.clear();
+        DiffKernels::histogram(a, b, script, &expired);
+        QCOMPARE(script, QByteArray("=di=="));
+        script.clear();
+        DiffKernels::lcs(a, b, script, &expired);
+        QCOMPARE(script, QByteArray("ddddiiii"));
+    }
+
+    void testCompareCli()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString origPath = dir.filePath("orig.cpp");
+        const QString newPath = dir.filePath("new.cpp");
+        QFile origFile(origPath);
+        QFile newFile(newPath);
+        QVERIFY(origFile.open(QIODevice::WriteOnly));
+        QVERIFY(newFile.open(QIODevice::WriteOnly));
+        origFile.write("// header\nint a()\n{\n    x();\n    y();\n}\nint gone() { return 1; }\n");
+        newFile.write("// header\nint a()\n{\n    x();\n    z();\n}\nint added() { return 2; }\n");
+        origFile.close();
+        newFile.close();
+
+        QString output;
+        QString errors;
+        QTextStream out(&output);
+        QTextStream err(&errors);
+        const QStringList base({ "DiffCheckAI", "--compare", origPath, newPath });
+        const int expected = CompareCli::ExitChanged | CompareCli::ExitMissing | CompareCli::ExitAdded;
+        QCOMPARE(CompareCli::run(base + QStringList("--unified"), out, err), expected);
+        QVERIFY(output.startsWith(QString("--- %1\n+++ %2\n").arg(origPath, newPath)));
+        QVERIFY(output.contains("@@ -3,4 +3,4 @@ a\n {\n     x();\n-    y();\n+    z();\n }\n"));
+        QVERIFY(output.contains("@@ -7,1 +0,0 @@ gone\n-int gone() { return 1; }\n"));
+        QVERIFY(output.contains("@@ -0,0 +7,1 @@ added\n+int added() { return 2; }\n"));
+
+        // Comments are ignored by the diff but kept in the printed lines
+        const QString commentedOrig = dir.filePath("commented_orig.cpp");
+        const QString commentedNew = dir.filePath("commented_new.cpp");
+        QFile commentedOrigFile(commentedOrig);
+        QFile commentedNewFile(commentedNew);
+        QVERIFY(commentedOrigFile.open(QIODevice::WriteOnly));
+        QVERIFY(commentedNewFile.open(QIODevice::WriteOnly));
+        commentedOrigFile.write("int c()\n{\n    // keep\n    p(); // old\n}\n");
+        commentedNewFile.write("int c()\n{\n    // keep\n    q(); // new\n}\n");
+        commentedOrigFile.close();
+        commentedNewFile.close();
+        output.clear();
+        QCOMPARE(CompareCli::run({ "DiffCheckAI", "--compare", commentedOrig, commentedNew, "--unified" }, out, err),
+                 int(CompareCli::ExitChanged));
+        QVERIFY(output.contains("@@ -2,4 +2,4 @@ c\n {\n     // keep\n-    p(); // old\n+    q(); // new\n }\n"));
+
+        output.clear();
+        QCOMPARE(CompareCli::run(base + QStringList("--json"), out, err), expected);
+        const QJsonObject root = QJsonDocument::fromJson(output.toUtf8()).object();
+        QCOMPARE(root.value("missing").toArray().at(0).toObject().value("name").toString(), QString("gone"));
+        QCOMPARE(root.value("added").toArray().at(0).toObject().value("line").toInt(), 7);
+        const QJsonObject changed = root.value("changed").toArray().at(0).toObject();
+        QCOMPARE(changed.value("name").toString(), QString("a"));
+        QCOMPARE(changed.value("hunks").toInt(), 1);
+        QCOMPARE(changed.value("deleted").toInt(), 1);
+        QCOMPARE(changed.value("inserted").toInt(), 1);
+
+        QCOMPARE(CompareCli::run({ "DiffCheckAI", "--compare", origPath, origPath }, out, err), int(CompareCli::ExitSame));
+        QCOMPARE(CompareCli::run({ "DiffCheckAI", "--compare", origPath }, out, err), int(CompareCli::ExitUsage));
+        QCOMPARE(CompareCli::run(base + QStringList({ "--json", "--unified" }), out, err), int(CompareCli::ExitUsage));
+        QCOMPARE(CompareCli::run(base + QStringList({ "--algorithm", "Histogram" }), out, err), expected);
+        errors.clear();
+        QCOMPARE(CompareCli::run(base + QStringList({ "--algorithm", "meyers" }), out, err), int(CompareCli::ExitUsage));
+        QVERIFY(errors.contains("meyers"));
+        QCOMPARE(CompareCli::run(base + QStringList({ "--algorithm", "lcs" }), out, err), int(CompareCli::ExitUsage));
+        QCOMPARE(CompareCli::run({ "DiffCheckAI", "--compare", origPath, dir.filePath("none.cpp") }, out, err),
+                 int(CompareCli::ExitNoInput));
+    }
+    void testCorpus_data()
+    {
+        QTest::addColumn<uint>("seed");
+        QTest::addColumn<uint>("mutations");
+
+        QTest::newRow("all seed 1") << 1u << uint(CorpusGenerator::AllMutations);
+        QTest::newRow("all seed 2") << 2u << uint(CorpusGenerator::AllMutations);
+        QTest::newRow("reformat only") << 3u << uint(CorpusGenerator::ReformatWhitespace);
+        QTest::newRow("body edits") << 4u << uint(CorpusGenerator::AllMutations & ~CorpusGenerator::ReformatWhitespace);
+        QTest::newRow("none") << 5u << uint(CorpusGenerator::NoMutations);
+    }
+
+    void testCorpus()
+    {
+        QFETCH(uint, seed);
+        QFETCH(uint, mutations);
+
+        CorpusGenerator generator(seed);
+        const CorpusFile file = generator.generate(3000, mutations, 25);
+        CorpusGenerator again(seed);
+        QCOMPARE(again.generate(3000, mutations, 25).mutated, file.mutated);
+
+        CompareEngine engine;
+        const QMap<QString, FunctionBlock> orig = engine.extractFunctions(file.original);
+        const QMap<QString, FunctionBlock> news = engine.extractFunctions(file.mutated);
+        QCOMPARE(orig.keys(), file.functions);
+        QCOMPARE(news.size(), orig.size() - file.dropped.size());
+        for (int i = 0; i < file.functions.size(); ++i)
+        {
+            const QString &name = file.functions.at(i);
+            const bool dropped = file.dropped.contains(name);
+            QVERIFY2(news.contains(name) != dropped, qPrintable(name));
+            if (!dropped)
+            {
+                const bool same = orig.value(name).fingerprint == news.value(name).fingerprint;
+                QVERIFY2(same != file.changed.contains(name), qPrintable(name));
+            }
+        }
+        if (mutations & ~uint(CorpusGenerator::ReformatWhitespace))
+        {
+            QVERIFY(!file.changed.isEmpty());
+        }
+        else
+        {
+            QVERIFY(file.changed.isEmpty() && file.dropped.isEmpty());
+        }
+    }
+    void testProfiler()
+    {
+        const QString code = "int a()\n{\n    return 1;\n}\nint b()\n{\n    return 2;\n}\n";
+        CompareEngine engine;
+        Profiler::reset();
+        Profiler::setEnabled(false);
+        engine.extractFunctions(code);
+        QVERIFY(Profiler::phases().isEmpty());
+
+        Profiler::setEnabled(true);
+        engine.extractFunctions(code);
+        engine.extractFunctions(code);
+        engine.stripComments(code);
+        {
+            PROFILE_SCOPE("test scope");
+        }
+        Profiler::setEnabled(false);
+
+        const QVector<Profiler::Phase> phases = Profiler::phases();
+        QStringList names;
+        int extractCalls = 0;
+        for (int i = 0; i < phases.size(); ++i)
+        {
+            names << phases.at(i).name;
+            QVERIFY(phases.at(i).nsecs >= 0);
+            QVERIFY(i == 0 || phases.at(i - 1).nsecs >= phases.at(i).nsecs);
+            if (phases.at(i).name == "extractFunctions")
+            {
+                extractCalls = phases.at(i).calls;
+            }
+        }
+        QVERIFY(names.contains("stripComments"));
+        QVERIFY(names.contains("test scope"));
+        QCOMPARE(extractCalls, 2);
+        QVERIFY(Profiler::summary().contains("extractFunctions"));
+
+        const QJsonObject trace = QJsonDocument::fromJson(Profiler::traceJson()).object();
+        const QJsonArray events = trace.value("traceEvents").toArray();
+        QCOMPARE(events.size(), 4);
+        QCOMPARE(events.at(0).toObject().value("ph").toString(), QString("X"));
+        QCOMPARE(events.at(0).toObject().value("tid").toInt(), 1);
+        QVERIFY(events.at(0).toObject().value("dur").toDouble() >= 0.0);
+
+        Profiler::reset();
+        QVERIFY(Profiler::summary().isEmpty());
+    }
+};
+
+QTEST_MAIN(TestCompareEngine)
+#include "test_compareengine.moc"
+
+/************** End of test_compareengine.cpp *********************/
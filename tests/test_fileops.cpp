@@ -0,0 +1,423 @@
+/****************************************************************
+ * @file    test_fileops.cpp
+ * @brief   Unit tests for the project file operations.
+ *
+ * @author  Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.7
+ * @date    2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Covers CopyJob: a tree is copied byte for byte with its
+ * modification times, the top-level skip names and hidden
+ * entries are left out, progress ends at the planned size, and
+ * a file that cannot be read is reported without stopping the
+ * others. testTempSync checks that a second sync copies nothing,
+ * that only changed files are copied and vanished ones removed
+ * (both backed up first), that a touched file is matched by hash,
+ * that a chmod alone reaches Temp, and that build is never touched. testBackupStore checks that
+ * equal content is stored once, that an unchanged folder makes
+ * no new snapshot, and that any version of a file restores
+ * with its time and, on Unix, its permissions.
+ * testLinkFile checks that a linked file reads like the source
+ * and that neither unshareFile nor copyFile writes through it;
+ * on Unix it also checks the inodes and link counts.
+ ***************************************************************/
+
+#include <QtTest>
+#include <QDirIterator>
+#include <QTemporaryDir>
+#include "BackupStore.h"
+#include "CopyJob.h"
+#include "TempSync.h"
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+class TestFileOps : public QObject
+{
+    Q_OBJECT
+private:
+    /************************************************************
+     * @brief Writes @p data to @p path, making its folder.
+     ***********************************************************/
+    static void writeFile(const QString &path, const QByteArray &data)
+    {
+        QDir().mkpath(QFileInfo(path).absolutePath());
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        QCOMPARE(file.write(data), qint64(data.size()));
+    }
+
+    /************************************************************
+     * @brief Reads @p path, or returns a null array.
+     ***********************************************************/
+    static QByteArray readFile(const QString &path)
+    {
+        QFile file(path);
+        return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+    }
+
+    /************************************************************
+     * @brief Sets the modification time of @p path.
+     ***********************************************************/
+    static void setModified(const QString &path, const QDateTime &time)
+    {
+        QFile file(path);
+        QVERIFY(file.open(QIODevice::Append));
+        QVERIFY(file.setFileTime(time, QFileDevice::FileModificationTime));
+    }
+
+#ifdef Q_OS_UNIX
+    /************************************************************
+     * @brief Returns the stat of @p path; st_ino is 0 if missing.
+     ***********************************************************/
+    static struct stat statFile(const QString &path)
+    {
+        struct stat info = {};
+        if (::stat(QFile::encodeName(path).constData(), &info) != 0)
+        {
+            info.st_ino = 0;
+        }
+        return info;
+    }
+#endif
+
+    /************************************************************
+     * @brief Runs TempSync::plan and copies what it returns.
+     ***********************************************************/
+    static CopyPlan sync(const QString &source, const QString &target, const QString &backup)
+    {
+        const CopyPlan plan = TempSync::plan(source, target, backup);
+        for (int i = 0; i < plan.files.size(); ++i)
+        {
+            if (!CopyJob::copyFile(plan.files.at(i).source, plan.files.at(i).target).isEmpty())
+            {
+                return CopyPlan();
+            }
+        }
+        return plan;
+    }
+
+    /************************************************************
+     * @brief Counts the objects of @p store.
+     ***********************************************************/
+    static int countObjects(const BackupStore &store)
+    {
+        int count = 0;
+        QDirIterator it(store.root() + "/objects", QDir::Files, QDirIterator::Subdirectories);
+        while (it.hasNext())
+        {
+            it.next();
+            ++count;
+        }
+        return count;
+    }
+
+private slots:
+    void testCopyFile()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        QByteArray data(int(CopyJob::ChunkBytes) + 4099, '\0');
+        for (int i = 0; i < data.size(); ++i)
+        {
+            data[i] = char(i * 31 + 7);
+        }
+        const QString source = dir.filePath("big.bin");
+        writeFile(source, data);
+        const QDateTime modified = QDateTime::currentDateTime().addDays(-3);
+        {
+            QFile file(source);
+            QVERIFY(file.open(QIODevice::ReadWrite));
+            QVERIFY(file.setFileTime(modified, QFileDevice::FileModificationTime));
+        }
+        std::atomic<qint64> bytesDone(0);
+        QCOMPARE(CopyJob::copyFile(source, dir.filePath("copy.bin"), &bytesDone), QString());
+        QCOMPARE(bytesDone.load(), qint64(data.size()));
+        QCOMPARE(readFile(dir.filePath("copy.bin")), data);
+        QCOMPARE(QFileInfo(dir.filePath("copy.bin")).lastModified().toSecsSinceEpoch(),
+                 modified.toSecsSinceEpoch());
+
+        std::atomic<bool> stop(true);
+        QVERIFY(!CopyJob::copyFile(source, dir.filePath("stopped.bin"), nullptr, &stop).isEmpty());
+        QVERIFY(!QFile::exists(dir.filePath("stopped.bin")));
+        QVERIFY(CopyJob::copyFile(dir.filePath("missing.bin"), dir.filePath("x.bin")).contains("missing.bin"));
+    }
+
+    void testCopyJob()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString source = dir.filePath("project");
+        writeFile(source + "/CMakeLists.txt", "project(x)\n");
+        writeFile(source + "/src/a.cpp", QByteArray(100000, 'a'));
+        writeFile(source + "/src/deep/b.h", "int b();\n");
+        writeFile(source + "/build/out.o", "object");
+        writeFile(source + "/src/build/kept.txt", "only the top-level build is skipped");
+        writeFile(source + "/.hidden", "hidden");
+        QDir().mkpath(source + "/empty");
+
+        CopyJob job;
+        job.addTree(source, dir.filePath("temp"), QStringList("build"));
+        QSignalSpy planned(&job, &CopyJob::planned);
+        QSignalSpy progress(&job, &CopyJob::progress);
+        QSignalSpy finished(&job, &CopyJob::finished);
+        job.start();
+        QVERIFY(job.isRunning());
+        QVERIFY(finished.wait(10000));
+        QVERIFY(!job.isRunning());
+
+        QCOMPARE(finished.first().at(0).toStringList(), QStringList());
+        QCOMPARE(planned.first().at(0).toInt(), 4);
+        const qint64 bytes = planned.first().at(1).toLongLong();
+        QCOMPARE(progress.last().at(0).toLongLong(), bytes);
+        QCOMPARE(progress.last().at(1).toLongLong(), bytes);
+        QCOMPARE(readFile(dir.filePath("temp/src/a.cpp")), QByteArray(100000, 'a'));
+        QCOMPARE(readFile(dir.filePath("temp/src/deep/b.h")), QByteArray("int b();\n"));
+        QVERIFY(QFile::exists(dir.filePath("temp/src/build/kept.txt")));
+        QVERIFY(QFileInfo(dir.filePath("temp/empty")).isDir());
+        QVERIFY(!QFile::exists(dir.filePath("temp/build")));
+        QVERIFY(!QFile::exists(dir.filePath("temp/.hidden")));
+    }
+
+    void testCopyJobErrors()
+    {
+#ifdef Q_OS_UNIX
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString source = dir.filePath("project");
+        writeFile(source + "/locked.txt", "locked");
+        writeFile(source + "/open.txt", "open");
+        QFile::setPermissions(source + "/locked.txt", QFileDevice::WriteOwner);
+        if (QFile(source + "/locked.txt").open(QIODevice::ReadOnly))
+        {
+            QSKIP("Running with permission to read any file");
+        }
+
+        CopyJob job;
+        job.addTree(source, dir.filePath("temp"));
+        QSignalSpy finished(&job, &CopyJob::finished);
+        job.start();
+        QVERIFY(finished.wait(10000));
+        const QStringList errors = finished.first().at(0).toStringList();
+        QCOMPARE(errors.size(), 1);
+        QVERIFY(errors.first().contains("locked.txt"));
+        QCOMPARE(readFile(dir.filePath("temp/open.txt")), QByteArray("open"));
+        QVERIFY(!QFile::exists(dir.filePath("temp/locked.txt")));
+#else
+        QSKIP("Needs Unix file permissions");
+#endif
+    }
+
+    void testTempSync()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString source = dir.filePath("project");
+        const QString temp = dir.filePath("temp");
+        writeFile(source + "/CMakeLists.txt", "project(x)\n");
+        writeFile(source + "/src/a.cpp", "int a() { return 1; }\n");
+        writeFile(source + "/src/b.cpp", "int b() { return 2; }\n");
+        writeFile(source + "/src/old/c.cpp", "int c();\n");
+        writeFile(temp + "/build/cache.o", "object");
+
+        CopyPlan plan = sync(source, temp, dir.filePath("backup1"));
+        QCOMPARE(plan.errors, QStringList());
+        QCOMPARE(plan.files.size(), 4);
+        QVERIFY(QFile::exists(temp + "/" + TempSync::manifestName()));
+        QVERIFY(!QFile::exists(dir.filePath("backup1")));
+
+        plan = sync(source, temp, dir.filePath("backup2"));
+        QCOMPARE(plan.files.size(), 0);
+        QCOMPARE(plan.unchanged, 4);
+        QCOMPARE(plan.removed, 0);
+
+        const QDateTime later = QDateTime::currentDateTime().addSecs(60);
+        writeFile(source + "/src/a.cpp", "int a() { return 10; }\n");
+        setModified(source + "/src/b.cpp", later);
+        QVERIFY(QFile::remove(source + "/src/old/c.cpp"));
+        QVERIFY(QDir(source).rmdir("src/old"));
+        writeFile(temp + "/notes.txt", "made in temp");
+        plan = sync(source, temp, dir.filePath("backup3"));
+        QCOMPARE(plan.errors, QStringList());
+        QCOMPARE(plan.files.size(), 1);
+        QCOMPARE(plan.files.first().target, temp + "/src/a.cpp");
+        QCOMPARE(plan.unchanged, 2);
+        QCOMPARE(plan.removed, 3);
+        QCOMPARE(readFile(temp + "/src/a.cpp"), QByteArray("int a() { return 10; }\n"));
+        QCOMPARE(QFileInfo(temp + "/src/b.cpp").lastModified().toSecsSinceEpoch(), later.toSecsSinceEpoch());
+        QVERIFY(!QFile::exists(temp + "/src/old"));
+        QVERIFY(!QFile::exists(temp + "/notes.txt"));
+        QCOMPARE(readFile(dir.filePath("backup3/src/a.cpp")), QByteArray("int a() { return 1; }\n"));
+        QCOMPARE(readFile(dir.filePath("backup3/src/old/c.cpp")), QByteArray("int c();\n"));
+        QCOMPARE(readFile(dir.filePath("backup3/notes.txt")), QByteArray("made in temp"));
+        QVERIFY(!QFile::exists(dir.filePath("backup3/src/b.cpp")));
+        QCOMPARE(readFile(temp + "/build/cache.o"), QByteArray("object"));
+
+        // Same size, new time, new content: the hash decides
+        writeFile(source + "/src/b.cpp", "int b() { return 3; }\n");
+        setModified(source + "/src/b.cpp", later.addSecs(60));
+        plan = sync(source, temp, QString());
+        QCOMPARE(plan.files.size(), 1);
+        QCOMPARE(readFile(temp + "/src/b.cpp"), QByteArray("int b() { return 3; }\n"));
+
+#ifdef Q_OS_UNIX
+        // A chmod keeps size and time; the mode is fixed in place
+        QVERIFY(::chmod(QFile::encodeName(source + "/src/b.cpp").constData(), 0755) == 0);
+        plan = sync(source, temp, QString());
+        QCOMPARE(plan.files.size(), 0);
+        QCOMPARE(int(statFile(temp + "/src/b.cpp").st_mode & 0777), 0755);
+#endif
+    }
+
+    void testTempSyncJob()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        writeFile(dir.filePath("project/a.txt"), "a");
+        const QString source = dir.filePath("project");
+        const QString temp = dir.filePath("temp");
+        CopyJob job;
+        job.setPlanner([source, temp]()
+                       {
+                           return TempSync::plan(source, temp, QString());
+                       });
+        QSignalSpy finished(&job, &CopyJob::finished);
+        job.start();
+        QVERIFY(finished.wait(10000));
+        QCOMPARE(finished.first().at(0).toStringList(), QStringList());
+        QCOMPARE(job.currentPlan().files.size(), 1);
+        QCOMPARE(readFile(temp + "/a.txt"), QByteArray("a"));
+    }
+
+    void testBackupStore()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString temp = dir.filePath("temp");
+        writeFile(temp + "/a.cpp", "int a();\n");
+        writeFile(temp + "/src/same1.h", "same\n");
+        writeFile(temp + "/src/same2.h", "same\n");
+        writeFile(temp + "/build/out.o", "object");
+        const QDateTime older = QDateTime::currentDateTime().addDays(-1);
+        setModified(temp + "/a.cpp", older);
+
+        BackupStore store(dir.filePath("backup"));
+        QStringList errors;
+        QCOMPARE(store.snapshot(temp, "s1", QStringList("build"), &errors), QString("s1"));
+        QCOMPARE(errors, QStringList());
+        QCOMPARE(countObjects(store), 2);
+        QCOMPARE(store.files("s1").size(), 3);
+        QVERIFY(!store.files("s1").contains("build/out.o"));
+
+        QCOMPARE(store.snapshot(temp, "s2", QStringList("build"), &errors), QString("s1"));
+        QCOMPARE(store.snapshots(), QStringList({ "s1" }));
+
+        writeFile(temp + "/a.cpp", "int a(int);\n");
+        QCOMPARE(store.snapshot(temp, "s1", QStringList("build"), &errors), QString("s1_2"));
+        QCOMPARE(errors, QStringList());
+        QCOMPARE(store.snapshots(), QStringList({ "s1", "s1_2" }));
+        QCOMPARE(countObjects(store), 3);
+
+        QCOMPARE(store.restoreFile("s1", "a.cpp", temp + "/a.cpp"), QString());
+        QCOMPARE(readFile(temp + "/a.cpp"), QByteArray("int a();\n"));
+        QCOMPARE(QFileInfo(temp + "/a.cpp").lastModified().toSecsSinceEpoch(), older.toSecsSinceEpoch());
+        QCOMPARE(store.restoreFile("s1_2", "src/same2.h", dir.filePath("out/same2.h")), QString());
+        QCOMPARE(readFile(dir.filePath("out/same2.h")), QByteArray("same\n"));
+        QVERIFY(!store.restoreFile("s1", "missing.h", dir.filePath("out/missing.h")).isEmpty());
+
+#ifdef Q_OS_UNIX
+        // A chmod alone makes a new snapshot, and restore applies the mode
+        QCOMPARE(store.snapshot(temp, "s3", QStringList("build"), &errors), QString("s3"));
+        QVERIFY(::chmod(QFile::encodeName(temp + "/src/same1.h").constData(), 0600) == 0);
+        QCOMPARE(store.snapshot(temp, "s4", QStringList("build"), &errors), QString("s4"));
+        QCOMPARE(store.files("s4").value("src/same1.h").mode, quint32(0600));
+        QVERIFY(::chmod(QFile::encodeName(temp + "/src/same1.h").constData(), 0644) == 0);
+        QCOMPARE(store.restoreFile("s4", "src/same1.h", temp + "/src/same1.h"), QString());
+        struct stat info;
+        QVERIFY(::stat(QFile::encodeName(temp + "/src/same1.h").constData(), &info) == 0);
+        QCOMPARE(int(info.st_mode & 0777), 0600);
+#endif
+    }
+
+    void testLinkFile()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        const QString source = dir.filePath("project/a.cpp");
+        const QString temp = dir.filePath("temp/a.cpp");
+        writeFile(source, "int a();\n");
+        QDir().mkpath(dir.filePath("temp"));
+        std::atomic<qint64> bytesDone(0);
+        QCOMPARE(CopyJob::linkFile(source, temp, &bytesDone), QString());
+        QCOMPARE(bytesDone.load(), qint64(9));
+        QCOMPARE(readFile(temp), QByteArray("int a();\n"));
+#ifdef Q_OS_UNIX
+        const ino_t projectInode = statFile(source).st_ino;
+        QVERIFY(projectInode != 0);
+        // A reflink clone is a file of its own; only a hard link shares the inode
+        if (statFile(temp).st_ino == projectInode)
+        {
+            QCOMPARE(int(statFile(source).st_nlink), 2);
+            QCOMPARE(int(statFile(temp).st_nlink), 2);
+        }
+#endif
+
+        // Break-on-write: the project keeps its content
+        QCOMPARE(CopyJob::unshareFile(temp), QString());
+        QCOMPARE(readFile(temp), QByteArray("int a();\n"));
+#ifdef Q_OS_UNIX
+        QVERIFY(statFile(temp).st_ino != projectInode);
+        QCOMPARE(int(statFile(source).st_nlink), 1);
+        QCOMPARE(int(statFile(temp).st_nlink), 1);
+#endif
+        writeFile(temp, "int a(int);\n");
+        QCOMPARE(readFile(source), QByteArray("int a();\n"));
+
+        // A copy onto a linked file replaces it
+        QCOMPARE(CopyJob::linkFile(source, temp), QString());
+        writeFile(dir.filePath("other.cpp"), "int other();\n");
+        QCOMPARE(CopyJob::copyFile(dir.filePath("other.cpp"), temp), QString());
+        QCOMPARE(readFile(temp), QByteArray("int other();\n"));
+        QCOMPARE(readFile(source), QByteArray("int a();\n"));
+#ifdef Q_OS_UNIX
+        QCOMPARE(statFile(source).st_ino, projectInode);
+        QVERIFY(statFile(temp).st_ino != projectInode);
+        QCOMPARE(int(statFile(source).st_nlink), 1);
+        QVERIFY(!QFileInfo::exists(dir.filePath("temp/.a.cpp.part")));
+#endif
+
+        CopyJob job;
+        job.addTree(dir.filePath("project"), dir.filePath("linked"));
+        job.setLinkFiles(true);
+        QSignalSpy finished(&job, &CopyJob::finished);
+        job.start();
+        QVERIFY(finished.wait(10000));
+        QCOMPARE(finished.first().at(0).toStringList(), QStringList());
+        QCOMPARE(readFile(dir.filePath("linked/a.cpp")), QByteArray("int a();\n"));
+    }
+
+    void testCopyJobCancel()
+    {
+        QTemporaryDir dir;
+        QVERIFY(dir.isValid());
+        writeFile(dir.filePath("project/a.txt"), "a");
+        CopyJob job;
+        job.addTree(dir.filePath("project"), dir.filePath("temp"));
+        QSignalSpy finished(&job, &CopyJob::finished);
+        QSignalSpy canceled(&job, &CopyJob::canceled);
+        job.start();
+        job.cancel();
+        job.cancel();
+        QCOMPARE(canceled.count(), 1);
+        QVERIFY(!job.isRunning());
+        QTest::qWait(100);
+        QCOMPARE(finished.count(), 0);
+    }
+};
+
+QTEST_MAIN(TestFileOps)
+#include "test_fileops.moc"
+
+/************** End of test_fileops.cpp ***************************/
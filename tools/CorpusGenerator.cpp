@@ -0,0 +1,400 @@
+/******************************************************************************
+ * @file CorpusGenerator.cpp
+ * @brief Implements the CorpusGenerator class.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * A file is a run of modules, one namespace each, generated until the
+ * line target is met. A module holds free functions, a class with inline
+ * methods and one out-of-class method, sometimes an overload pair and an
+ * anonymous namespace. Each function is built as a list of statement
+ * units; the mutation is chosen when the function is made, and both
+ * variants are rendered from the same units.
+ *
+ * Overloads share one extractFunctions key, so the later overload hides
+ * the earlier one; they are never mutated, which keeps the expected
+ * result exact.
+ ******************************************************************************/
+
+#include "CorpusGenerator.h"
+
+namespace
+{
+/******************************************************************************
+ * @brief Body mutation chosen for one function.
+ ******************************************************************************/
+enum class BodyEdit
+{
+    None,
+    Drop,
+    Placeholder,
+    Reorder,
+    Rename
+};
+
+/******************************************************************************
+ * @struct Unit
+ * @brief One statement; loops and ifs span several lines.
+ ******************************************************************************/
+struct Unit
+{
+    QStringList lines;      ///< Statement lines, indented relative to the body
+    bool swappable = true;  ///< False for the return, which must stay last
+};
+
+/******************************************************************************
+ * @struct GenFunction
+ * @brief A function as generated and as mutated.
+ ******************************************************************************/
+struct GenFunction
+{
+    QString key;         ///< extractFunctions key
+    QString signature;   ///< Declaration line, e.g. "int Shape3::resize3(int w, int h)"
+    QVector<Unit> body;  ///< Original statements
+    QVector<Unit> edited; ///< Statements of the mutated variant
+    BodyEdit edit = BodyEdit::None;
+};
+
+/******************************************************************************
+ * @brief Replaces whole-word occurrences of @p from with @p to.
+ ******************************************************************************/
+QString renameWord(const QString &line, const QString &from, const QString &to)
+{
+    QString result;
+    int i = 0;
+    while (i < line.size())
+    {
+        const int hit = line.indexOf(from, i);
+        if (hit < 0)
+        {
+            result += line.mid(i);
+            break;
+        }
+        const int end = hit + from.size();
+        const bool before = hit > 0 && (line.at(hit - 1).isLetterOrNumber() || line.at(hit - 1) == QLatin1Char('_'));
+        const bool after = end < line.size() && (line.at(end).isLetterOrNumber() || line.at(end) == QLatin1Char('_'));
+        result += line.mid(i, hit - i);
+        result += (before || after) ? from : to;
+        i = end;
+    }
+    return result;
+}
+
+/******************************************************************************
+ * @brief Widens the single spaces around '=' and after ',' to the kind of
+ *        spacing formatters disagree on. Only whitespace runs change
+ *        length, so normalized bodies stay equal.
+ ******************************************************************************/
+QString respace(const QString &line)
+{
+    QString result = line;
+    result.replace(QLatin1String(" = "), QLatin1String("  =  "));
+    result.replace(QLatin1String(", "), QLatin1String(",   "));
+    return result;
+}
+
+/******************************************************************************
+ * @brief Appends one function to @p out.
+ * @param indent Indentation of the signature.
+ * @param mutated Render the mutated statements.
+ * @param reformat Use the reformatted layout: brace on the signature line,
+ *                 tab indentation and wider spacing.
+ ******************************************************************************/
+void renderFunction(const GenFunction &fn, const QString &indent, bool mutated, bool reformat, QString &out)
+{
+    if (mutated && fn.edit == BodyEdit::Drop)
+    {
+        return;
+    }
+    const QVector<Unit> &units = mutated ? fn.edited : fn.body;
+    if (reformat)
+    {
+        out += indent + QString("/* %1 */\n").arg(fn.key);
+        out += indent + respace(fn.signature) + QString(" {\n");
+    }
+    else
+    {
+        out += indent + QString("/**\n");
+        out += indent + QString(" * @brief Generated function %1.\n").arg(fn.key);
+        out += indent + QString(" */\n");
+        out += indent + fn.signature + QLatin1Char('\n');
+        out += indent + QString("{\n");
+    }
+    const QString bodyIndent = reformat ? indent + QLatin1Char('\t') : indent + QString("    ");
+    for (int u = 0; u < units.size(); ++u)
+    {
+        for (int l = 0; l < units.at(u).lines.size(); ++l)
+        {
+            QString line = units.at(u).lines.at(l);
+            if (reformat)
+            {
+                // Inner indentation becomes tabs as well
+                while (line.startsWith(QLatin1String("    ")))
+                {
+                    line = QLatin1Char('\t') + line.mid(4);
+                }
+                line = respace(line);
+            }
+            out += bodyIndent + line + QLatin1Char('\n');
+        }
+        if (reformat && u == 0)
+        {
+            out += QLatin1Char('\n');
+        }
+    }
+    out += indent + QString("}\n\n");
+}
+} // namespace
+
+/******************************************************************************
+ * @brief Constructor.
+ ******************************************************************************/
+CorpusGenerator::CorpusGenerator(quint32 seed)
+    : m_random(seed), m_serial(0)
+{
+}
+
+/******************************************************************************
+ * @brief Returns a random int in [low, high).
+ ******************************************************************************/
+int CorpusGenerator::pick(int low, int high)
+{
+    return low + int(m_random.bounded(quint32(high - low)));
+}
+
+/******************************************************************************
+ * @brief Parses a comma-separated list of mutation names.
+ ******************************************************************************/
+unsigned CorpusGenerator::mutationsFromNames(const QString &names, bool *ok)
+{
+    unsigned flags = NoMutations;
+    bool valid = true;
+    const QStringList parts = names.split(QLatin1Char(','), Qt::SkipEmptyParts);
+    for (int i = 0; i < parts.size(); ++i)
+    {
+        const QString name = parts.at(i).trimmed().toLower();
+        if (name == QLatin1String("drop"))               flags |= DropFunctions;
+        else if (name == QLatin1String("placeholder"))   flags |= PlaceholderBodies;
+        else if (name == QLatin1String("reorder"))       flags |= ReorderStatements;
+        else if (name == QLatin1String("rename"))        flags |= RenameIdentifiers;
+        else if (name == QLatin1String("reformat"))      flags |= ReformatWhitespace;
+        else if (name == QLatin1String("all"))           flags |= AllMutations;
+        else if (name != QLatin1String("none"))          valid = false;
+    }
+    if (ok)
+    {
+        *ok = valid;
+    }
+    return flags;
+}
+
+/******************************************************************************
+ * @brief Generates the next file.
+ *
+ * Statement kinds cover what the lexer and the function scanner must get
+ * right: a lambda with its own braces, a raw string full of braces, a
+ * string holding comment markers, and comments holding unbalanced braces.
+ * Every body declares "count", so a rename always changes it, and has at
+ * least two distinct swappable statements, so a reorder always does too.
+ ******************************************************************************/
+CorpusFile CorpusGenerator::generate(int lines, unsigned mutations, int mutatePercent)
+{
+    const bool reformat = mutations & ReformatWhitespace;
+    QVector<BodyEdit> edits;
+    if (mutations & DropFunctions)      edits.append(BodyEdit::Drop);
+    if (mutations & PlaceholderBodies)  edits.append(BodyEdit::Placeholder);
+    if (mutations & ReorderStatements)  edits.append(BodyEdit::Reorder);
+    if (mutations & RenameIdentifiers)  edits.append(BodyEdit::Rename);
+
+    CorpusFile file;
+    const QString header = QString("// Generated by corpus_generator; do not edit.\n"
+                                          "#include <vector>\n\nnamespace corpus\n{\n");
+    file.original = header;
+    file.mutated = reformat ? QString("// Generated by corpus_generator; do not edit.\n"
+                                             "#include <vector>\n\nnamespace corpus {\n")
+                            : header;
+
+    // Builds a body and decides its mutation
+    auto makeFunction = [&](const QString &key, const QString &signature, bool mutable_) -> GenFunction
+    {
+        GenFunction fn;
+        fn.key = key;
+        fn.signature = signature;
+        const int n = ++m_serial;
+        fn.body.append(Unit{ { QString("int count = value + %1;").arg(pick(1, 100)) }, false });
+        const int statements = pick(3, 9);
+        for (int s = 0; s < statements; ++s)
+        {
+            const int r = pick(1, 1000);
+            const QString id = QString("%1_%2").arg(n).arg(s);
+            switch (pick(0, 9))
+            {
+            case 0:
+                fn.body.append(Unit{ { QString("count += %1;").arg(r) } });
+                break;
+            case 1:
+                fn.body.append(Unit{ { QString("for (int i = 0; i < %1; ++i)").arg(r % 16 + 1),
+                                       QString("{"),
+                                       QString("    count ^= i * %1;").arg(r),
+                                       QString("}") } });
+                break;
+            case 2:
+                fn.body.append(Unit{ { QString("auto scale%1 = [count](int v) { return v * count + %2; };").arg(id).arg(r),
+                                       QString("count = scale%1(count);").arg(id) } });
+                break;
+            case 3:
+                fn.body.append(Unit{ { QString("const char *pattern%1 = R\"re({[^}]*}%2)re\";").arg(id).arg(r),
+                                       QString("count += pattern%1[0] == '{' ? 1 : 0;").arg(id) } });
+                break;
+            case 4:
+                fn.body.append(Unit{ { QString("const char *url%1 = \"http://example.com/*%2*/\";").arg(id).arg(r),
+                                       QString("count -= url%1[0];").arg(id) } });
+                break;
+            case 5:
+                fn.body.append(Unit{ { QString("/* { unbalanced in a comment */ count -= %1;").arg(r) } });
+                break;
+            case 6:
+                fn.body.append(Unit{ { QString("count *= %1; // keep } out of the scanner").arg(r % 7 + 2) } });
+                break;
+            case 7:
+                fn.body.append(Unit{ { QString("if (count > %1)").arg(r),
+                                       QString("{"),
+                                       QString("    return count - %1;").arg(r),
+                                       QString("}") } });
+                break;
+            default:
+                fn.body.append(Unit{ { QString("std::vector<int> values%1{ count, %2, %3 };").arg(id).arg(r).arg(r * 3),
+                                       QString("count += int(values%1.size());").arg(id) } });
+                break;
+            }
+        }
+        // Two statements that always differ, so a swap always changes the body
+        fn.body.append(Unit{ { QString("count += %1;").arg(n) } });
+        fn.body.append(Unit{ { QString("count -= %1;").arg(n + 1) } });
+        fn.body.append(Unit{ { QString("return count;") }, false });
+
+        fn.edited = fn.body;
+        if (mutable_ && !edits.isEmpty() && pick(0, 100) < mutatePercent)
+        {
+            fn.edit = edits.at(pick(0, edits.size()));
+        }
+        switch (fn.edit)
+        {
+        case BodyEdit::Placeholder:
+            fn.edited.clear();
+            fn.edited.append(Unit{ { QString("// ... existing code ...") } });
+            fn.edited.append(Unit{ { QString("return 0;") }, false });
+            break;
+        case BodyEdit::Reorder:
+        {
+            // Swappable units run from 1 to size - 2; the last two always differ
+            const int first = pick(1, fn.edited.size() - 2);
+            fn.edited.swapItemsAt(first, first + 1);
+            if (fn.edited.at(first).lines == fn.edited.at(first + 1).lines)
+            {
+                fn.edited.swapItemsAt(fn.edited.size() - 3, fn.edited.size() - 2);
+            }
+            break;
+        }
+        case BodyEdit::Rename:
+            for (int u = 0; u < fn.edited.size(); ++u)
+            {
+                for (int l = 0; l < fn.edited[u].lines.size(); ++l)
+                {
+                    fn.edited[u].lines[l] = renameWord(fn.edited[u].lines[l], QString("count"),
+                                                       QString("total"));
+                }
+            }
+            break;
+        default:
+            break;
+        }
+
+        file.functions.append(key);
+        if (fn.edit == BodyEdit::Drop)
+        {
+            file.dropped.append(key);
+        }
+        else if (fn.edit != BodyEdit::None)
+        {
+            file.changed.append(key);
+        }
+        return fn;
+    };
+
+    auto render = [&](const GenFunction &fn, const QString &indent)
+    {
+        renderFunction(fn, indent, false, false, file.original);
+        renderFunction(fn, indent, true, reformat, file.mutated);
+    };
+    auto addText = [&](const QString &text, const QString &reformatted)
+    {
+        file.original += text;
+        file.mutated += reformat ? reformatted : text;
+    };
+
+    while (file.original.count(QLatin1Char('\n')) < lines)
+    {
+        const int module = ++m_serial;
+        const QString ns = QString("detail%1").arg(module);
+        const QString scope = QString("corpus::") + ns + QString("::");
+        addText(QString("namespace %1\n{\n\n").arg(ns), QString("namespace %1 {\n").arg(ns));
+
+        const int freeCount = pick(1, 4);
+        for (int f = 0; f < freeCount; ++f)
+        {
+            const QString name = QString("compute%1_%2").arg(module).arg(f);
+            const QString prefix = pick(0, 3) == 0 ? QString("static ") : QString();
+            render(makeFunction(scope + name, prefix + QString("int %1(int value)").arg(name), true),
+                   QString());
+        }
+
+        const QString cls = QString("Shape%1").arg(module);
+        addText(QString("class %1\n{\npublic:\n").arg(cls), QString("class %1 {\n  public:\n").arg(cls));
+        const int methodCount = pick(1, 3);
+        for (int m = 0; m < methodCount; ++m)
+        {
+            const QString name = QString("measure%1").arg(m);
+            render(makeFunction(scope + cls + QString("::") + name,
+                                QString("int %1(int value) const").arg(name), true),
+                   QString("    "));
+        }
+        const QString resize = QString("resize%1").arg(module);
+        addText(QString("    int %1(int value, int scale);\n\nprivate:\n    int m_width = 0;\n};\n\n").arg(resize),
+             QString("    int %1(int value,   int scale);\n  private:\n    int m_width  =  0;\n};\n").arg(resize));
+        render(makeFunction(scope + cls + QString("::") + resize,
+                            QString("int %1::%2(int value, int scale)").arg(cls, resize), true),
+               QString());
+
+        if (pick(0, 3) == 0)
+        {
+            // Both overloads map to one key; the second one is what extractFunctions keeps
+            const QString name = QString("convert%1").arg(module);
+            render(makeFunction(scope + name, QString("int %1(int value)").arg(name), false), QString());
+            file.functions.removeLast();
+            render(makeFunction(scope + name, QString("int %1(int value, int base)").arg(name), false),
+                   QString());
+        }
+
+        if (pick(0, 4) == 0)
+        {
+            addText(QString("namespace\n{\n\n"), QString("namespace {\n"));
+            const QString name = QString("helper%1").arg(module);
+            render(makeFunction(scope + name, QString("int %1(int value)").arg(name), true), QString());
+            addText(QString("} // namespace\n\n"), QString("}\n"));
+        }
+
+        addText(QString("} // namespace %1\n\n").arg(ns), QString("}\n\n"));
+    }
+
+    addText(QString("} // namespace corpus\n"), QString("}\n"));
+    file.functions.sort();
+    file.dropped.sort();
+    file.changed.sort();
+    return file;
+}
+
+/*************** End of CorpusGenerator.cpp **********************************/
@@ -0,0 +1,97 @@
+/******************************************************************************
+ * @file CorpusGenerator.h
+ * @brief Declares the CorpusGenerator class for synthetic compare inputs.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * Builds seeded C++ sources with nested namespaces, classes with inline
+ * and out-of-class methods, overloads, lambdas, raw strings and comments
+ * that hide braces, together with an "AI-mutated" variant: functions
+ * dropped, bodies replaced by placeholders, statements reordered,
+ * identifiers renamed and whitespace reformatted. Each file comes with
+ * the expected outcome per function, so correctness tests can check
+ * CompareEngine against it and benchmarks can share the same inputs.
+ * The same seed always gives the same files.
+ ******************************************************************************/
+
+#pragma once
+
+#include <QRandomGenerator>
+#include <QString>
+#include <QStringList>
+
+/******************************************************************************
+ * @struct CorpusFile
+ * @brief One generated source, its mutated variant and what a compare of
+ *        the two must report. Names are CompareEngine::extractFunctions
+ *        keys, sorted.
+ ******************************************************************************/
+struct CorpusFile
+{
+    QString original;    /**< Generated source */
+    QString mutated;     /**< The source after the mutations */
+    QStringList functions; /**< Every function of the original */
+    QStringList dropped; /**< Functions missing from the mutated source */
+    QStringList changed; /**< Functions whose body changed */
+};
+
+/******************************************************************************
+ * @class CorpusGenerator
+ * @brief Deterministic generator of source/mutated source pairs.
+ ******************************************************************************/
+class CorpusGenerator
+{
+public:
+    /**************************************************************************
+     * @enum Mutation
+     * @brief Edits applied to the mutated variant; combine as flags.
+     *************************************************************************/
+    enum Mutation : unsigned
+    {
+        NoMutations = 0x00,
+        DropFunctions = 0x01,      /**< Leave functions out */
+        PlaceholderBodies = 0x02,  /**< Replace a body by "... existing code ..." */
+        ReorderStatements = 0x04,  /**< Swap two neighbouring statements */
+        RenameIdentifiers = 0x08,  /**< Rename a local variable */
+        ReformatWhitespace = 0x10, /**< Reindent and respace the whole file */
+        AllMutations = 0x1f
+    };
+
+    /**************************************************************************
+     * @brief Constructor.
+     * @param seed Seed of every choice the generator makes.
+     *************************************************************************/
+    explicit CorpusGenerator(quint32 seed = 1);
+
+    /**************************************************************************
+     * @brief Generates the next file.
+     * @param lines Approximate line count of the original.
+     * @param mutations Mutation flags for the mutated variant.
+     * @param mutatePercent Share of functions that get a body mutation.
+     * @return The file pair and its expected compare result.
+     *************************************************************************/
+    CorpusFile generate(int lines, unsigned mutations = AllMutations, int mutatePercent = 20);
+
+    /**************************************************************************
+     * @brief Parses a comma-separated list such as "drop,rename".
+     * @param names Names: drop, placeholder, reorder, rename, reformat,
+     *              all or none.
+     * @param ok Set to false if a name is unknown.
+     * @return Mutation flags.
+     *************************************************************************/
+    static unsigned mutationsFromNames(const QString &names, bool *ok = nullptr);
+
+private:
+    /**************************************************************************
+     * @brief Returns a random int in [low, high).
+     *************************************************************************/
+    int pick(int low, int high);
+
+    QRandomGenerator m_random; ///< Source of every choice
+    int m_serial;              ///< Numbers names so files never collide
+};
+
+/*************** End of CorpusGenerator.h ************************************/
@@ -0,0 +1,123 @@
+/******************************************************************************
+ * @file corpus_generator.cpp
+ * @brief Command-line front end of CorpusGenerator.
+ *
+ * @author Jeffrey Scott Flesher with the help of AI: Copilot
+ * @version 0.1
+ * @date 2026-10-16
+ * @section License MIT
+ * @section DESCRIPTION
+ * corpus_generator [--seed N] [--files N] [--lines N]
+ *                  [--mutations drop,placeholder,reorder,rename,reformat]
+ *                  [--percent N] outDir
+ * writes corpus_NNN.cpp and corpus_NNN.mutated.cpp pairs and a
+ * manifest.json with the expected missing and changed functions of
+ * each pair. The same arguments always write the same bytes, so a
+ * corpus can be regenerated instead of checked in:
+ *     DiffCheckAI --compare out/corpus_000.cpp out/corpus_000.mutated.cpp
+ ******************************************************************************/
+
+#include <QCommandLineParser>
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include "CorpusGenerator.h"
+
+/******************************************************************************
+ * @brief Writes @p text as UTF-8 to @p path.
+ ******************************************************************************/
+static bool writeFile(const QString &path, const QString &text)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        return false;
+    }
+    return file.write(text.toUtf8()) >= 0;
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream err(stderr);
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Writes seeded C++ files and AI-style mutated variants for "
+                                     "diff benchmarks and compare tests.");
+    const QCommandLineOption seedOption("seed", "Seed of the generator.", "n", "1");
+    const QCommandLineOption filesOption("files", "Number of file pairs.", "n", "4");
+    const QCommandLineOption linesOption("lines", "Approximate lines per file.", "n", "2000");
+    const QCommandLineOption mutationsOption("mutations", "Comma-separated: drop, placeholder, reorder, "
+                                             "rename, reformat, all or none.", "list", "all");
+    const QCommandLineOption percentOption("percent", "Share of functions with a body mutation.", "n", "20");
+    parser.addOptions({ seedOption, filesOption, linesOption, mutationsOption, percentOption });
+    parser.addHelpOption();
+    parser.addPositionalArgument("outDir", "Directory for the corpus; created if missing.");
+    parser.process(app);
+
+    bool seedOk = false;
+    bool filesOk = false;
+    bool linesOk = false;
+    bool percentOk = false;
+    bool mutationsOk = false;
+    const quint32 seed = parser.value(seedOption).toUInt(&seedOk);
+    const int files = parser.value(filesOption).toInt(&filesOk);
+    const int lines = parser.value(linesOption).toInt(&linesOk);
+    const int percent = parser.value(percentOption).toInt(&percentOk);
+    const unsigned mutations = CorpusGenerator::mutationsFromNames(parser.value(mutationsOption), &mutationsOk);
+    const QStringList positional = parser.positionalArguments();
+    if (!seedOk || !filesOk || files < 1 || !linesOk || lines < 1 || !percentOk || percent < 0 || percent > 100
+        || !mutationsOk || positional.size() != 1)
+    {
+        err << parser.helpText();
+        return 64;
+    }
+
+    const QDir dir(positional.first());
+    if (!dir.mkpath("."))
+    {
+        err << "Cannot create " << dir.path() << '\n';
+        return 73;
+    }
+
+    CorpusGenerator generator(seed);
+    QJsonArray pairs;
+    for (int i = 0; i < files; ++i)
+    {
+        const CorpusFile file = generator.generate(lines, mutations, percent);
+        const QString base = QString("corpus_%1").arg(i, 3, 10, QLatin1Char('0'));
+        const QString origName = base + ".cpp";
+        const QString newName = base + ".mutated.cpp";
+        if (!writeFile(dir.filePath(origName), file.original) || !writeFile(dir.filePath(newName), file.mutated))
+        {
+            err << "Cannot write " << dir.filePath(base) << '\n';
+            return 73;
+        }
+        QJsonObject pair;
+        pair.insert("original", origName);
+        pair.insert("mutated", newName);
+        pair.insert("functions", QJsonArray::fromStringList(file.functions));
+        pair.insert("dropped", QJsonArray::fromStringList(file.dropped));
+        pair.insert("changed", QJsonArray::fromStringList(file.changed));
+        pairs.append(pair);
+    }
+
+    QJsonObject manifest;
+    manifest.insert("seed", qint64(seed));
+    manifest.insert("lines", lines);
+    manifest.insert("mutations", parser.value(mutationsOption));
+    manifest.insert("percent", percent);
+    manifest.insert("files", pairs);
+    if (!writeFile(dir.filePath("manifest.json"), QString::fromUtf8(QJsonDocument(manifest).toJson())))
+    {
+        err << "Cannot write " << dir.filePath("manifest.json") << '\n';
+        return 73;
+    }
+    return 0;
+}
+
+/*************** End of corpus_generator.cpp *********************************/